@@ -9,6 +9,7 @@
 
 #include "DCPSE_op.hpp"
 #include "Matrix/SparseMatrix.hpp"
+#include "Matrix/SparseMatrix_assembly.hpp"
 #include "Vector/Vector.hpp"
 #include "NN/CellList/CellDecomposer.hpp"
 #include "Vector/Vector_util.hpp"
@@ -82,6 +83,9 @@ class DCPSE_scheme {
 
     size_t offset;
 
+    //! evaluate the rows of the system in parallel when imposing the operators
+    bool parallel_assembly = false;
+
 
     /*! \brief Construct the gmap structure
  *
@@ -239,6 +243,14 @@ class DCPSE_scheme {
             if (trpl.get(i).value() != 0) { nz_rows.get(trpl.get(i).row() - s_pnt * Sys_eqs::nvar) = true; }
         }
 
+        A.getMatrixRows().forEachNonZero([&](long int r, long int c, typename Sys_eqs::stype v) {
+            if (r - s_pnt * Sys_eqs::nvar >= nz_rows.size()) {
+                std::cerr << "Error " << __FILE__ << ":" << __LINE__
+                          << " It seems that you are setting colums that does not exist \n";
+            }
+            if (v != 0) { nz_rows.get(r - s_pnt * Sys_eqs::nvar) = true; }
+        });
+
         // Indicate all the non zero colums
         // This check can be done only on single processor
 
@@ -251,6 +263,10 @@ class DCPSE_scheme {
                 if (trpl.get(i).value() != 0) { nz_cols.get(trpl.get(i).col()) = true; }
             }
 
+            A.getMatrixRows().forEachNonZero([&](long int r, long int c, typename Sys_eqs::stype v) {
+                if (v != 0) { nz_cols.get(c) = true; }
+            });
+
             // all the rows must have a non zero element
             for (size_t i = 0; i < nz_rows.size(); i++) {
                 if (nz_rows.get(i) == false) {
@@ -304,6 +320,27 @@ class DCPSE_scheme {
         comp++;
     }
 
+    /*! \brief Copy the solution of the right-hand-side k into the expressions that belong to it
+     *
+     * The expressions are grouped by right-hand-side, Sys_eqs::nvar for each one
+     *
+     * \param x solution
+     * \param k right-hand-side
+     * \param j index of the expression exp
+     *
+     */
+    template<typename solType, typename exp1, typename ... othersExp>
+    void copy_rhs(solType &x, size_t k, size_t j, exp1 exp, othersExp ... exps) {
+        if (j / Sys_eqs::nvar == k)
+        {copy_impl(x, exp, j % Sys_eqs::nvar);}
+
+        copy_rhs(x, k, j+1, exps ...);
+    }
+
+    template<typename solType>
+    void copy_rhs(solType &x, size_t k, size_t j) {
+    }
+
 public:
 
     /*! \brief Set the structure of the system of equation
@@ -382,6 +419,73 @@ public:
         copy_nested(x, comp, exps ...);
     }
 
+    /*! \brief Solve the system for several right-hand-sides with one matrix
+     *
+     * The matrix is assembled and the solver is set-up (factorized or preconditioned) once. The
+     * right-hand-side imposed together with the operators is the first one, the others are
+     * imposed by the functor set_rhs(k) with impose_b (k from 1), the solution of the right-hand-side k
+     * is stored in the expressions from k*Sys_eqs::nvar to (k+1)*Sys_eqs::nvar - 1
+     *
+     * \verbatim
+       Solver.impose(Lap(sol), bulk, RHS[0]);
+       Solver.impose(sol, boundary, 0.0);
+
+       Solver.solve_multi([&](size_t k){Solver.impose_b(bulk,RHS[k]);
+                                        Solver.impose_b(boundary,0.0);},
+                          sol[0],sol[1],sol[2]);
+     * \endverbatim
+     *
+     * \param solver Manually created Solver instead from the Equation structure
+     * \param set_rhs functor that impose the right-hand-side k
+     * \param exps where to store the results
+     *
+     */
+    template<typename SolverType, typename rhs_type, typename ... expr_type>
+    void solve_multi_with_solver(SolverType &solver, rhs_type set_rhs, expr_type ... exps) {
+        if (sizeof...(exps) % Sys_eqs::nvar != 0) {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error the number of properties you gave must be a multiple of "
+                      << Sys_eqs::nvar << std::endl;
+            return;
+        }
+
+        size_t n_rhs = sizeof...(exps) / Sys_eqs::nvar;
+
+        auto & A_ = getA(opt);
+
+        auto get_b = [&](size_t k) -> typename Sys_eqs::Vector_type & {
+            if (k != 0)
+            {
+                size_t row_b_end = row_b;
+                row_b = 0;
+                set_rhs(k);
+                row_b = row_b_end;
+            }
+
+            return getB(opt);
+        };
+
+        auto set_x = [&](size_t k, typename Sys_eqs::Vector_type & x) {
+            copy_rhs(x, k, 0, exps ...);
+        };
+
+        solver.solve_multi(A_, n_rhs, get_b, set_x);
+    }
+
+    /*! \brief Solve the system for several right-hand-sides with one matrix
+     *
+     * Same as solve_multi_with_solver using the solver of the Equation structure
+     *
+     * \param set_rhs functor that impose the right-hand-side k
+     * \param exps where to store the results
+     *
+     */
+    template<typename rhs_type, typename ... expr_type>
+    void solve_multi(rhs_type set_rhs, expr_type ... exps) {
+        typename Sys_eqs::solver_type solver;
+
+        solve_multi_with_solver(solver, set_rhs, exps ...);
+    }
+
     /*! \brief Solve an equation with a given Nullspace
      *
      *  \warning exp must be a scalar type
@@ -465,6 +569,7 @@ public:
     	p_map.resize(part.size_local());
 
     	A.getMatrixTriplets().clear();
+    	A.getMatrixRows().clear();
 
     	construct_pmap(opt);
     }
@@ -475,6 +580,36 @@ public:
     	row_b = 0;
 
     	A.getMatrixTriplets().clear();
+    	A.getMatrixRows().clear();
+    }
+
+    /*! \brief Freeze the sparsity pattern of the Matrix
+     *
+     * For time dependent problems where the same operators are imposed again (after reset_nodec) on the
+     * same particles and only the coefficients change. The sparsity pattern is recorded on the first
+     * assembly and the next ones write the values in place, see SparseMatrix::freezePattern
+     *
+     * \param freeze true to freeze the pattern
+     *
+     */
+    void freezePattern(bool freeze = true)
+    {
+        A.freezePattern(freeze);
+    }
+
+    /*! \brief Evaluate the rows of the system in parallel
+     *
+     * When enabled, impose evaluate the rows once in parallel (OpenMP), every thread with its own row
+     * accumulator writing into its own CSR block of the Matrix rows (see sparse_matrix_add_rows). The
+     * blocks are given to the Matrix backend as CSR, without triplets. The operators are evaluated
+     * concurrently, so it cannot be used with operators that have a state (like the copy operators)
+     *
+     * \param parallel true to enable the parallel assembly
+     *
+     */
+    void setParallelAssembly(bool parallel)
+    {
+        parallel_assembly = parallel;
     }
 
     /*! \brief Constructor for the solver
@@ -787,23 +922,18 @@ public:
 
         auto it = it_d;
 
-        //std::unordered_map<long int, typename particles_type::stype> cols;
+        if (parallel_assembly == true) {
+            impose_git_parallel(op, num, id, it);
+            return;
+        }
 
-        tsl::hopscotch_map<long int, typename particles_type::stype> cols;
+        sparse_row_accumulator<typename Sys_eqs::stype> cols;
 
         // iterate all particles points
         while (it.isNext()) {
             // get the particle
             auto key = it.get();
 
-/*
-            if (key == 298 && create_vcluster().rank() == 1)
-            {
-            	int debug = 0;
-            	debug++;
-            }
-*/
-
             // Calculate the non-zero colums
             typename Sys_eqs::stype coeff = 1.0;
             op.template value_nz<Sys_eqs>(p_map, key, cols, coeff, 0);
@@ -843,6 +973,47 @@ public:
         }
     }
 
+    /*! \brief Impose an operator evaluating the rows in parallel
+     *
+     * \see setParallelAssembly
+     *
+     * \param op Operator to impose (A term)
+     * \param num right hand side of the term (b term)
+     * \param id Equation id in the system that we are imposing
+     * \param it iterator that define where you want to impose
+     *
+     */
+    template<typename T, typename bop, typename iterator>
+    void impose_git_parallel(const T &op,
+                             bop & num,
+                             long int id,
+                             iterator & it) {
+        typedef typename std::remove_const<typename std::remove_reference<decltype(it.get())>::type>::type key_type;
+
+        std::vector<key_type> keys;
+
+        while (it.isNext()) {
+            keys.push_back(it.get());
+            ++it;
+        }
+
+        auto row_f = [&](const key_type & key, sparse_row_accumulator<typename Sys_eqs::stype> & cols) -> long int {
+            typename Sys_eqs::stype coeff = 1.0;
+            op.template value_nz<Sys_eqs>(p_map, key, cols, coeff, 0);
+
+            return p_map.template getProp<0>(key) * Sys_eqs::nvar + id;
+        };
+
+        sparse_matrix_add_rows(A.getMatrixRows(), keys, row_f);
+
+        for (size_t k = 0; k < keys.size(); k++) {
+            b(p_map.template getProp<0>(keys[k]) * Sys_eqs::nvar + id) = num.get(keys[k]);
+        }
+
+        row += keys.size();
+        row_b += keys.size();
+    }
+
 };
 
 #include "DCPSE/DCPSE_op/EqnsStruct.hpp"
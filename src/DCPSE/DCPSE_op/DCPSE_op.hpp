@@ -11,6 +11,7 @@
 
 #include "Decomposition/CartDecomposition.hpp"
 #include "DCPSE/Dcpse.hpp"
+#include "DCPSE/DcpseSpMV.hpp"
 #include "Operators/Vector/vector_dist_operators.hpp"
 
 const double dcpse_oversampling_factor = 1.9;
@@ -61,7 +62,10 @@ public:
      */
     template<typename r_type=typename std::remove_reference<decltype(o1.value(vect_dist_key_dx()))>::type>
     inline r_type value(const vect_dist_key_dx &key) const {
-        return dcp.computeDifferentialOperator(key, o1);
+        // computed once per particle when the same derivative is used by more pairs of assign
+        return vector_dist_assign_cse::eval<r_type,vector_dist_expression_op>(&dcp, o1, key.getKey(), [&]() -> r_type {
+            return dcp.computeDifferentialOperator(key, o1);
+        });
     }
 
     template<typename Sys_eqs, typename pmap_type, typename unordered_map_type, typename coeff_type>
@@ -145,13 +149,15 @@ public:
      */
     template<typename r_type=VectorS<dims, stype> >
     inline r_type value(const vect_dist_key_dx &key) const {
-        VectorS<dims, stype> v_grad;
+        return vector_dist_assign_cse::eval<r_type,vector_dist_expression_op>(&dcp, o1, key.getKey(), [&]() -> r_type {
+            VectorS<dims, stype> v_grad;
 
-        for (int i = 0; i < dims; i++) {
-            v_grad.get(i) = dcp[i].computeDifferentialOperator(key, o1);
-        }
+            for (int i = 0; i < dims; i++) {
+                v_grad.get(i) = dcp[i].computeDifferentialOperator(key, o1);
+            }
 
-        return v_grad;
+            return v_grad;
+        });
     }
 
     template<typename Sys_eqs, typename pmap_type, typename unordered_map_type, typename coeff_type>
@@ -658,11 +664,22 @@ public:
  * \return Operator Dx which is a function on Vector_dist_Expressions
  *
  */
-class Derivative_x {
+template<typename kernel_type = void>
+class Derivative_x_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dx and objects and computes DCPSE Kernels.
      *
      *
@@ -676,47 +693,73 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_x(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_x_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                 double oversampling_factor = dcpse_oversampling_factor,
+                 support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_x_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   const std::string &checkpoint,
                  double oversampling_factor = dcpse_oversampling_factor,
                  support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
         p.zero();
         p.get(0) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
 
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernelNN(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernelNN<prp>(particles, k);
 
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
@@ -728,13 +771,46 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
 
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
+
 };
 
+//! Derivative_x with the kernels stored in the position type of the particles (see Derivative_x_T to choose the storage type)
+typedef Derivative_x_T<> Derivative_x;
+
 /*! \brief Class for Creating the DCPSE Operator Dy and objects and computes DCPSE Kernels.
  *
  *
@@ -747,11 +823,21 @@ public:
  * \return Operator Dy which is a function on Vector_dist_Expressions
  *
  */
-class Derivative_y {
+template<typename kernel_type = void>
+class Derivative_y_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
 
     /*! \brief Constructor for Creating the DCPSE Operator Dy and objects and computes DCPSE Kernels.
      *
@@ -766,46 +852,72 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_y(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_y_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
                  double oversampling_factor = dcpse_oversampling_factor,
                  support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
         p.zero();
         p.get(1) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
         dcpse_ptr++;
 
     }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_y_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   const std::string &checkpoint,
+                 double oversampling_factor = dcpse_oversampling_factor,
+                 support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(1) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
+    }
+
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
 
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse2 = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse2 = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse2->template DrawKernel<prp>(particles, k);
 
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
@@ -817,12 +929,45 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_y with the kernels stored in the position type of the particles (see Derivative_y_T to choose the storage type)
+typedef Derivative_y_T<> Derivative_y;
+
 /*! \brief Class for Creating the DCPSE Operator Dz and objects and computes DCPSE Kernels.
  *
  *
@@ -835,11 +980,22 @@ public:
  * \return Operator Dz which is a function on Vector_dist_Expressions
  *
  */
-class Derivative_z {
+template<typename kernel_type = void>
+class Derivative_z_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dz and objects and computes DCPSE Kernels.
      *
      *
@@ -853,25 +1009,51 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_z(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_z_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                 double oversampling_factor = dcpse_oversampling_factor,
+                 support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(2) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_z_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   const std::string &checkpoint,
                  double oversampling_factor = dcpse_oversampling_factor,
                  support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
         p.zero();
         p.get(2) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
@@ -883,20 +1065,53 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
 
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
+
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
 };
 
+//! Derivative_z with the kernels stored in the position type of the particles (see Derivative_z_T to choose the storage type)
+typedef Derivative_z_T<> Derivative_z;
+
 /*! \brief Class for Creating the Gradient Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -911,11 +1126,22 @@ public:
      * \return Operator Grad which is a function on Vector_dist_Expressions
      *
      */
-class Gradient {
+template<typename kernel_type = void>
+class Gradient_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operators, one first derivative for each direction
+     *
+     * \return pointer to the array of dims operators
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the Gradient Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -931,35 +1157,73 @@ public:
      *
      */
     template<typename particles_type>
-    Gradient(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Gradient_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+             double oversampling_factor = dcpse_oversampling_factor,
+             support_options opt = support_options::RADIUS) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (int i = 0; i < particles_type::dims; i++) {
+            Point<particles_type::dims, unsigned int> p;
+            p.zero();
+            p.get(i) = 1;
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
+        }
+
+        // The operators share the supports and the moment matrix
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, particles_type::dims);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Gradient_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+               const std::string &checkpoint,
              double oversampling_factor = dcpse_oversampling_factor,
              support_options opt = support_options::RADIUS) {
-        typedef Dcpse<particles_type::dims, particles_type> DCPSE_type;
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
 
         dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             Point<particles_type::dims, unsigned int> p;
             p.zero();
             p.get(i) = 1;
-            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
             dcpse_ptr++;
         }
+
+        // The operators share the supports and the moment matrix, they are loaded from the checkpoint if it match
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, particles_type::dims, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
         for (int i = 0; i < particles_type::dims; i++) {
-            delete &(((Dcpse<particles_type::dims, particles_type> *) dcpse)[i]);
+            delete &(((Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse)[i]);
         }
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE_V>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE_V>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE_V>(arg,
                                                                                  *(dcpse_type(*)[operand_type::vtype::dims]) dcpse);
@@ -967,7 +1231,7 @@ public:
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             dcpse_ptr[i].template DrawKernel<prp>(particles, i, k);
@@ -982,15 +1246,46 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
-        for (int i = 0; i < particles_type::dims; i++) {
-            dcpse_ptr[i].initializeUpdate(particles);
-        }
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(particles, dcpse_ptr, particles_type::dims);
+
+    }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyIncremental(particles, dcpse_ptr, particles_type::dims, skin, tol);
+    }
 
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, particles_type::dims, checkpoint);
     }
 
 
 };
+
+//! Gradient with the kernels stored in the position type of the particles (see Gradient_T to choose the storage type)
+typedef Gradient_T<> Gradient;
 /*! \brief Class for Creating the DCPSE 2D Curl Operator
      *
      *  Creates object which work in 2 dimension and computes DCPSE Kernels for Dx_i as required.
@@ -1005,7 +1300,8 @@ public:
      * \return Operator which is a function on Vector_dist_Expressions
      *
      */
-class Curl2D {
+template<typename kernel_type = void>
+class Curl2D_T {
 
     void *dcpse;
 public:
@@ -1024,34 +1320,78 @@ public:
      *
      */
     template<typename particles_type>
-    Curl2D(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Curl2D_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+           double oversampling_factor = dcpse_oversampling_factor, support_options opt = support_options::RADIUS) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(1) = 1;
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                   dcpse_family_member());
+        dcpse_ptr++;
+        p.zero();
+        p.get(0) = 1;
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                   dcpse_family_member());
+        dcpse_ptr++;
+
+        // The operators share the supports and the moment matrix
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, 2);
+
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Curl2D_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+             const std::string &checkpoint,
            double oversampling_factor = dcpse_oversampling_factor, support_options opt = support_options::RADIUS) {
-        typedef Dcpse<particles_type::dims, particles_type> DCPSE_type;
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
 
         dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         Point<particles_type::dims, unsigned int> p;
         p.zero();
         p.get(1) = 1;
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                   dcpse_family_member());
         dcpse_ptr++;
         p.zero();
         p.get(0) = 1;
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                   dcpse_family_member());
         dcpse_ptr++;
 
+        // The operators share the supports and the moment matrix, they are loaded from the checkpoint if it match
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, 2, checkpoint);
+
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE_V_CURL2D>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE_V_CURL2D>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE_V_CURL2D>(arg,
                                                                                         *(dcpse_type(*)[operand_type::vtype::dims]) dcpse);
     }
 };
+
+//! Curl2D with the kernels stored in the position type of the particles (see Curl2D_T to choose the storage type)
+typedef Curl2D_T<> Curl2D;
 /*! \brief Class for Creating the DCPSE Laplacian Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -1066,11 +1406,22 @@ public:
      * \return Operator which is a function on Vector_dist_Expressions
      *
      */
-class Laplacian {
+template<typename kernel_type = void>
+class Laplacian_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operators, one second derivative for each direction
+     *
+     * \return pointer to the array of dims operators
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Laplacian Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -1086,28 +1437,66 @@ public:
      *
      */
     template<typename particles_type>
-    Laplacian(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Laplacian_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+              double oversampling_factor = dcpse_oversampling_factor,
+              support_options opt = support_options::RADIUS) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (int i = 0; i < particles_type::dims; i++) {
+            Point<particles_type::dims, unsigned int> p;
+            p.zero();
+            p.get(i) = 2;
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
+        }
+
+        // The operators share the supports and the moment matrix
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, particles_type::dims);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Laplacian_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                const std::string &checkpoint,
               double oversampling_factor = dcpse_oversampling_factor,
               support_options opt = support_options::RADIUS) {
-        typedef Dcpse<particles_type::dims, particles_type> DCPSE_type;
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
 
         dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             Point<particles_type::dims, unsigned int> p;
             p.zero();
             p.get(i) = 2;
-            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
             dcpse_ptr++;
         }
+
+        // The operators share the supports and the moment matrix, they are loaded from the checkpoint if it match
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, particles_type::dims, checkpoint);
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE_V_SUM>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE_V_SUM>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE_V_SUM>(arg,
                                                                                      *(dcpse_type(*)[operand_type::vtype::dims]) dcpse);
@@ -1116,7 +1505,7 @@ public:
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             dcpse_ptr[i].checkMomenta(particles);
@@ -1126,7 +1515,7 @@ public:
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             dcpse_ptr[i].template DrawKernel<prp>(particles, k);
@@ -1135,7 +1524,7 @@ public:
     }
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
     /*! \brief Method for Updating the DCPSE Operator by recomputing DCPSE Kernels.
      *
@@ -1144,16 +1533,47 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
-        for (int i = 0; i < particles_type::dims; i++) {
-            dcpse_ptr[i].initializeUpdate(particles);
-        }
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(particles, dcpse_ptr, particles_type::dims);
+
+    }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyIncremental(particles, dcpse_ptr, particles_type::dims, skin, tol);
+    }
 
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, particles_type::dims, checkpoint);
     }
 
 
 };
 
+//! Laplacian with the kernels stored in the position type of the particles (see Laplacian_T to choose the storage type)
+typedef Laplacian_T<> Laplacian;
+
 /*! \brief Class for Creating the DCPSE Divergence Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -1168,7 +1588,8 @@ public:
      * \return Operator which is a function on Vector_dist_Expressions. Computes Divergence of Vectors
      *
      */
-class Divergence {
+template<typename kernel_type = void>
+class Divergence_T {
 
     void *dcpse;
 
@@ -1188,28 +1609,66 @@ public:
      *
      */
     template<typename particles_type>
-    Divergence(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Divergence_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+               double oversampling_factor = dcpse_oversampling_factor,
+               support_options opt = support_options::RADIUS) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (int i = 0; i < particles_type::dims; i++) {
+            Point<particles_type::dims, unsigned int> p;
+            p.zero();
+            p.get(i) = 1;
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
+        }
+
+        // The operators share the supports and the moment matrix
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, particles_type::dims);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Divergence_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                 const std::string &checkpoint,
                double oversampling_factor = dcpse_oversampling_factor,
                support_options opt = support_options::RADIUS) {
-        typedef Dcpse<particles_type::dims, particles_type> DCPSE_type;
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
 
         dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             Point<particles_type::dims, unsigned int> p;
             p.zero();
             p.get(i) = 1;
-            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
             dcpse_ptr++;
         }
+
+        // The operators share the supports and the moment matrix, they are loaded from the checkpoint if it match
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, particles_type::dims, checkpoint);
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE_V_DIV>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE_V_DIV>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE_V_DIV>(arg,
                                                                                      *(dcpse_type(*)[operand_type::vtype::dims]) dcpse);
@@ -1222,15 +1681,46 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
-        for (int i = 0; i < particles_type::dims; i++) {
-            dcpse_ptr[i].initializeUpdate(particles);
-        }
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(particles, dcpse_ptr, particles_type::dims);
 
     }
 
-};
-
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyIncremental(particles, dcpse_ptr, particles_type::dims, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, particles_type::dims, checkpoint);
+    }
+
+};
+
+//! Divergence with the kernels stored in the position type of the particles (see Divergence_T to choose the storage type)
+typedef Divergence_T<> Divergence;
+
 /*! \brief Class for Creating the DCPSE Advection Operator
      *
      *  Creates object which work on any dimension and computes DCPSE Kernels for Dx_i in each dimension.
@@ -1245,7 +1735,8 @@ public:
      * \return Operator which is a function on Vector_dist_Expressions. Computes Advection of Vectors Adv(v,u) = v.Grad(u)
      *
      */
-class Advection {
+template<typename kernel_type = void>
+class Advection_T {
 
     void *dcpse;
 
@@ -1265,30 +1756,70 @@ public:
      *
      */
     template<typename particles_type>
-    Advection(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Advection_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+              double oversampling_factor = dcpse_oversampling_factor,
+              support_options opt = support_options::RADIUS) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (int i = 0; i < particles_type::dims; i++) {
+            Point<particles_type::dims, unsigned int> p;
+            p.zero();
+            p.get(i) = 1;
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
+        }
+
+        // The operators share the supports and the moment matrix
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, particles_type::dims);
+
+
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Advection_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                const std::string &checkpoint,
               double oversampling_factor = dcpse_oversampling_factor,
               support_options opt = support_options::RADIUS) {
-        typedef Dcpse<particles_type::dims, particles_type> DCPSE_type;
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
 
         dcpse = new unsigned char[particles_type::dims * sizeof(DCPSE_type)];
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             Point<particles_type::dims, unsigned int> p;
             p.zero();
             p.get(i) = 1;
-            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
             dcpse_ptr++;
         }
 
+        // The operators share the supports and the moment matrix, they are loaded from the checkpoint if it match
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, particles_type::dims, checkpoint);
+
 
     }
 
     template<typename operand_type1, typename operand_type2>
-    vector_dist_expression_op<operand_type1, std::pair<operand_type2, Dcpse<operand_type2::vtype::dims, typename operand_type2::vtype>>, VECT_DCPSE_V_DOT>
+    vector_dist_expression_op<operand_type1, std::pair<operand_type2, Dcpse<operand_type2::vtype::dims, typename operand_type2::vtype, kernel_type>>, VECT_DCPSE_V_DOT>
     operator()(operand_type1 arg, operand_type2 arg2) {
-        typedef Dcpse<operand_type2::vtype::dims, typename operand_type2::vtype> dcpse_type;
+        typedef Dcpse<operand_type2::vtype::dims, typename operand_type2::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type1, std::pair<operand_type2, dcpse_type>, VECT_DCPSE_V_DOT>(arg,
                                                                                                                 arg2,
@@ -1297,7 +1828,7 @@ public:
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             dcpse_ptr[i].checkMomenta(particles);
@@ -1307,7 +1838,7 @@ public:
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         for (int i = 0; i < particles_type::dims; i++) {
             dcpse_ptr[i].template DrawKernel<prp>(particles, i, k);
@@ -1322,16 +1853,236 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
-        for (int i = 0; i < particles_type::dims; i++) {
-            dcpse_ptr[i].initializeUpdate(particles);
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(particles, dcpse_ptr, particles_type::dims);
+
+    }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyIncremental(particles, dcpse_ptr, particles_type::dims, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, particles_type::dims, checkpoint);
+    }
+
+
+};
+
+//! Advection with the kernels stored in the position type of the particles (see Advection_T to choose the storage type)
+typedef Advection_T<> Advection;
+
+/*! \brief Class for Creating a family of DCPSE Operators that share supports and moment matrices
+ *
+ * The operators are given as a list of differential signatures. Operators whose signatures have the same
+ * order are computed together: the support search, the Vandermonde and the moment matrix are done once per
+ * particle, and the coefficients of all of them are obtained from one factorization
+ *
+ * \verbatim
+   DcpseFamily ops(particles, {{1,0}, {0,1}, {2,0}, {0,2}}, 2, rCut);
+
+   v = ops(0, P) + ops(1, P);
+   lap = ops(2, P) + ops(3, P);
+ * \endverbatim
+ *
+ * \param parts particle set
+ * \param signatures differential signatures of the operators
+ * \param ord order of convergence of the operators
+ * \param rCut Argument for cell list construction
+ * \param oversampling_factor multiplier to the minimum no. of particles required by the operator in support
+ * \param support_options default:N_particles, Radius can be used to select all particles inside rCut. Overrides oversampling.
+ *
+ */
+template<typename kernel_type = void>
+class DcpseFamily_T {
+
+    void *dcpse;
+
+    size_t nOps;
+
+public:
+    /*! \brief Get the DCPSE operators
+     *
+     * \return pointer to the DCPSE operators (one for each signature)
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
+    /*! \brief Constructor for Creating the DCPSE Operators and computes DCPSE Kernels.
+     *
+     *
+     * \param parts particle set
+     * \param signatures differential signatures of the operators
+     * \param ord order of convergence of the operators
+     * \param rCut Argument for cell list construction
+     * \param oversampling_factor multiplier to the minimum no. of particles required by the operator in support
+     * \param support_options default:N_particles, Radius can be used to select all particles inside rCut. Overrides oversampling.
+     *
+     */
+    template<typename particles_type>
+    DcpseFamily_T(particles_type &parts,
+                const std::vector<Point<particles_type::dims, unsigned int>> &signatures,
+                unsigned int ord, typename particles_type::stype rCut,
+                double oversampling_factor = dcpse_oversampling_factor,
+                support_options opt = support_options::RADIUS)
+    :nOps(signatures.size())
+    {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[nOps * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (size_t i = 0; i < nOps; i++) {
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, signatures[i], ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
         }
 
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(parts, (DCPSE_type *) dcpse, nOps);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    DcpseFamily_T(particles_type &parts,
+                const std::vector<Point<particles_type::dims, unsigned int>> &signatures,
+                unsigned int ord, typename particles_type::stype rCut,
+                  const std::string &checkpoint,
+                double oversampling_factor = dcpse_oversampling_factor,
+                support_options opt = support_options::RADIUS)
+    :nOps(signatures.size())
+    {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        dcpse = new unsigned char[nOps * sizeof(DCPSE_type)];
+
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+
+        for (size_t i = 0; i < nOps; i++) {
+            new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, signatures[i], ord, rCut, oversampling_factor, opt,
+                                                                       dcpse_family_member());
+            dcpse_ptr++;
+        }
+
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (DCPSE_type *) dcpse, nOps, checkpoint);
+    }
+
+    template<typename particles_type>
+    void deallocate(particles_type &parts) {
+        typedef Dcpse<particles_type::dims, particles_type, kernel_type> DCPSE_type;
+
+        DCPSE_type *dcpse_ptr = (DCPSE_type *) dcpse;
+        for (size_t i = 0; i < nOps; i++) {
+            dcpse_ptr[i].~DCPSE_type();
+        }
+        delete [] (unsigned char *) dcpse;
+    }
+
+    /*! \brief Get the operator i applied to arg
+     *
+     * \param i operator (index in the list of signatures)
+     * \param arg operand
+     *
+     * \return the expression
+     *
+     */
+    template<typename operand_type>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
+    operator()(size_t i, operand_type arg) {
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
+
+        return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, ((dcpse_type *) dcpse)[i]);
+    }
+
+    /*! \brief Get the number of operators
+     *
+     * \return the number of operators
+     *
+     */
+    size_t size() const {
+        return nOps;
+    }
+
+    /*! \brief Method for Updating the DCPSE Operators by recomputing DCPSE Kernels.
+     *
+     *
+     * \param parts particle set
+     */
+    template<typename particles_type>
+    void update(particles_type &particles) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamily(particles, dcpse_ptr, nOps);
+    }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyIncremental(particles, dcpse_ptr, nOps, skin, tol);
     }
 
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, nOps, checkpoint);
+    }
 
 };
 
+//! DcpseFamily with the kernels stored in the position type of the particles (see DcpseFamily_T to choose the storage type)
+typedef DcpseFamily_T<> DcpseFamily;
+
 /*! \brief Class for Creating the DCPSE Operator Dxy and objects and computes DCPSE Kernels.
      *
      *
@@ -1344,11 +2095,22 @@ public:
      * \return Operator Dxy which is a function on Vector_dist_Expressions
      *
      */
-class Derivative_xy {
+template<typename kernel_type = void>
+class Derivative_xy_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dxy and objects and computes DCPSE Kernels.
      *
      *
@@ -1362,7 +2124,7 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_xy(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_xy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1370,31 +2132,58 @@ public:
         p.get(0) = 1;
         p.get(1) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
         dcpse_ptr++;
 
     }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_xy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 1;
+        p.get(1) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
+    }
+
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         dcpse_ptr[0].template DrawKernel<prp>(particles, k);
 
@@ -1402,7 +2191,7 @@ public:
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
@@ -1414,11 +2203,44 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
+
+//! Derivative_xy with the kernels stored in the position type of the particles (see Derivative_xy_T to choose the storage type)
+typedef Derivative_xy_T<> Derivative_xy;
 /*! \brief Class for Creating the DCPSE Operator Dyz and objects and computes DCPSE Kernels.
      *
      *
@@ -1431,11 +2253,22 @@ public:
      * \return Operator Dyz which is a function on Vector_dist_Expressions
      *
      */
-class Derivative_yz {
+template<typename kernel_type = void>
+class Derivative_yz_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dyz and objects and computes DCPSE Kernels.
      *
      *
@@ -1449,7 +2282,7 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_yz(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_yz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1457,31 +2290,58 @@ public:
         p.get(1) = 1;
         p.get(2) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
         dcpse_ptr++;
 
     }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_yz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(1) = 1;
+        p.get(2) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
+    }
+
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         dcpse_ptr[0].template DrawKernel<prp>(particles, k);
 
@@ -1489,7 +2349,7 @@ public:
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
@@ -1501,11 +2361,44 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
+
+//! Derivative_yz with the kernels stored in the position type of the particles (see Derivative_yz_T to choose the storage type)
+typedef Derivative_yz_T<> Derivative_yz;
 /*! \brief Class for Creating the DCPSE Operator Dxz and objects and computes DCPSE Kernels.
      *
      *
@@ -1518,11 +2411,22 @@ public:
      * \return Operator Dxz which is a function on Vector_dist_Expressions
      *
      */
-class Derivative_xz {
+template<typename kernel_type = void>
+class Derivative_xz_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dxz and objects and computes DCPSE Kernels.
      *
      *
@@ -1536,7 +2440,7 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_xz(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_xz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1544,31 +2448,58 @@ public:
         p.get(0) = 1;
         p.get(2) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
 
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
-        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        new(dcpse_ptr) Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
         dcpse_ptr++;
 
     }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_xz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 1;
+        p.get(2) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
+    }
+
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        Dcpse<particles_type::dims, particles_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
 
         dcpse_ptr[0].template DrawKernel<prp>(particles, k);
 
@@ -1576,7 +2507,7 @@ public:
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
@@ -1588,12 +2519,45 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_xz with the kernels stored in the position type of the particles (see Derivative_xz_T to choose the storage type)
+typedef Derivative_xz_T<> Derivative_xz;
+
 /*! \brief Constructor for Creating the DCPSE Operator Dxx and objects and computes DCPSE Kernels.
      *
      *
@@ -1606,11 +2570,22 @@ public:
      * \return Operator Dxx which is a function on Vector_dist_Expressions
      *
      */
-class Derivative_xx {
+template<typename kernel_type = void>
+class Derivative_xx_T {
 
     void *dcpse;
 
-public:
+public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Class for Creating the DCPSE Operator Dxx and objects and computes DCPSE Kernels.
      *
      *
@@ -1624,7 +2599,30 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_xx(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_xx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 2;
+        p.get(1) = 0;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_xx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1632,32 +2630,36 @@ public:
         p.get(0) = 2;
         p.get(1) = 0;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1669,12 +2671,45 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_xx with the kernels stored in the position type of the particles (see Derivative_xx_T to choose the storage type)
+typedef Derivative_xx_T<> Derivative_xx;
+
 /*! \brief Class for Creating the DCPSE Operator Dyy and objects and computes DCPSE Kernels.
  *
  *
@@ -1687,11 +2722,22 @@ public:
  * \return Operator Dyy which is a function on Vector_dist_Expressions
  *
  */
-class Derivative_yy {
+template<typename kernel_type = void>
+class Derivative_yy_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dyy and objects and computes DCPSE Kernels.
      *
      *
@@ -1705,7 +2751,30 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_yy(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_yy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 0;
+        p.get(1) = 2;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_yy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1713,32 +2782,36 @@ public:
         p.get(0) = 0;
         p.get(1) = 2;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1750,11 +2823,44 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
+
+//! Derivative_yy with the kernels stored in the position type of the particles (see Derivative_yy_T to choose the storage type)
+typedef Derivative_yy_T<> Derivative_yy;
 /*! \brief Class for Creating the DCPSE Operator Dzz and objects and computes DCPSE Kernels.
      *
      *
@@ -1767,11 +2873,22 @@ public:
      * \return Operator Dzz which is a function on Vector_dist_Expressions
      *
      */
-class Derivative_zz {
+template<typename kernel_type = void>
+class Derivative_zz_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
     /*! \brief Constructor for Creating the DCPSE Operator Dzz and objects and computes DCPSE Kernels.
      *
      *
@@ -1785,39 +2902,65 @@ public:
      *
      */
     template<typename particles_type>
-    Derivative_zz(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_zz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                  double oversampling_factor = dcpse_oversampling_factor,
+                  support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(2) = 2;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_zz_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                    const std::string &checkpoint,
                   double oversampling_factor = dcpse_oversampling_factor,
                   support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
         p.zero();
         p.get(2) = 2;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename particles_type>
     void deallocate(particles_type &parts) {
-        delete (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        delete (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
     }
 
     template<typename operand_type>
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1829,21 +2972,87 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_zz with the kernels stored in the position type of the particles (see Derivative_zz_T to choose the storage type)
+typedef Derivative_zz_T<> Derivative_zz;
+
 
-class Derivative_xxx {
+template<typename kernel_type = void>
+class Derivative_xxx_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
+    template<typename particles_type>
+    Derivative_xxx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   double oversampling_factor = dcpse_oversampling_factor,
+                   support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 3;
+        p.get(1) = 0;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
     template<typename particles_type>
-    Derivative_xxx(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_xxx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                     const std::string &checkpoint,
                    double oversampling_factor = dcpse_oversampling_factor,
                    support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1851,28 +3060,32 @@ public:
         p.get(0) = 3;
         p.get(1) = 0;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename operand_type>
 
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1884,21 +3097,87 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_xxx with the kernels stored in the position type of the particles (see Derivative_xxx_T to choose the storage type)
+typedef Derivative_xxx_T<> Derivative_xxx;
 
-class Derivative_xxy {
+
+template<typename kernel_type = void>
+class Derivative_xxy_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
+    template<typename particles_type>
+    Derivative_xxy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   double oversampling_factor = dcpse_oversampling_factor,
+                   support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 2;
+        p.get(1) = 1;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
     template<typename particles_type>
-    Derivative_xxy(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_xxy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                     const std::string &checkpoint,
                    double oversampling_factor = dcpse_oversampling_factor,
                    support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1906,28 +3185,32 @@ public:
         p.get(0) = 2;
         p.get(1) = 1;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename operand_type>
 
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1939,21 +3222,87 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_xxy with the kernels stored in the position type of the particles (see Derivative_xxy_T to choose the storage type)
+typedef Derivative_xxy_T<> Derivative_xxy;
+
 
-class Derivative_yyx {
+template<typename kernel_type = void>
+class Derivative_yyx_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
+
+    template<typename particles_type>
+    Derivative_yyx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                   double oversampling_factor = dcpse_oversampling_factor,
+                   support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 1;
+        p.get(1) = 2;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
 
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
     template<typename particles_type>
-    Derivative_yyx(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_yyx_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                     const std::string &checkpoint,
                    double oversampling_factor = dcpse_oversampling_factor,
                    support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -1961,28 +3310,32 @@ public:
         p.get(0) = 1;
         p.get(1) = 2;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename operand_type>
 
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -1994,21 +3347,64 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_yyx with the kernels stored in the position type of the particles (see Derivative_yyx_T to choose the storage type)
+typedef Derivative_yyx_T<> Derivative_yyx;
 
-class Derivative_yyy {
+
+template<typename kernel_type = void>
+class Derivative_yyy_T {
 
     void *dcpse;
 
 public:
+    /*! \brief Get the DCPSE operator
+     *
+     * \return pointer to the DCPSE operator
+     *
+     */
+    template<typename particles_type>
+    Dcpse<particles_type::dims, particles_type, kernel_type> * getDcpse() {
+        return (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+    }
 
     template<typename particles_type>
-    Derivative_yyy(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+    Derivative_yyy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
                    double oversampling_factor = dcpse_oversampling_factor,
                    support_options opt = support_options::RADIUS) {
         Point<particles_type::dims, unsigned int> p;
@@ -2016,28 +3412,55 @@ public:
         p.get(0) = 0;
         p.get(1) = 3;
 
-        dcpse = new Dcpse<particles_type::dims, particles_type>(parts, p, ord, rCut, oversampling_factor, opt);
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt);
+    }
+
+    /*! \brief Constructor that load the DCPSE Kernels from a checkpoint
+     *
+     * The kernels are loaded from the per-processor file checkpoint if it has been written for the same
+     * particles, decomposition and parameters. Otherwise they are computed and the checkpoint is written
+     *
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * The other parameters are the same of the standard constructor
+     *
+     */
+    template<typename particles_type>
+    Derivative_yyy_T(particles_type &parts, unsigned int ord, typename particles_type::stype rCut,
+                     const std::string &checkpoint,
+                   double oversampling_factor = dcpse_oversampling_factor,
+                   support_options opt = support_options::RADIUS) {
+        Point<particles_type::dims, unsigned int> p;
+        p.zero();
+        p.get(0) = 0;
+        p.get(1) = 3;
+
+        dcpse = new Dcpse<particles_type::dims, particles_type, kernel_type>(parts, p, ord, rCut, oversampling_factor, opt,
+                                                                             dcpse_family_member());
+
+        // Load the kernels from the checkpoint if it match the particles, otherwise compute and save them
+        Dcpse<particles_type::dims, particles_type, kernel_type>::initializeFamilyCheckpoint(parts, (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse, 1, checkpoint);
     }
 
     template<typename operand_type>
 
-    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype>, VECT_DCPSE>
+    vector_dist_expression_op<operand_type, Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type>, VECT_DCPSE>
     operator()(operand_type arg) {
-        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype> dcpse_type;
+        typedef Dcpse<operand_type::vtype::dims, typename operand_type::vtype, kernel_type> dcpse_type;
 
         return vector_dist_expression_op<operand_type, dcpse_type, VECT_DCPSE>(arg, *(dcpse_type *) dcpse);
     }
 
     template<typename particles_type>
     void checkMomenta(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->checkMomenta(particles);
 
     }
 
     template<unsigned int prp, typename particles_type>
     void DrawKernel(particles_type &particles, int k) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->template DrawKernel<prp>(particles, k);
 
     }
@@ -2049,12 +3472,45 @@ public:
      */
     template<typename particles_type>
     void update(particles_type &particles) {
-        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type> *) dcpse;
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
         dcpse_temp->initializeUpdate(particles);
 
     }
+
+    /*! \brief Method for Updating the DCPSE Operator recomputing only the DCPSE Kernels of the particles that moved.
+     *
+     * The supports are kept until a particle moved more than skin/2 (see Dcpse::initializeUpdateIncremental)
+     *
+     * \param parts particle set
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     */
+    template<typename particles_type>
+    bool updateIncremental(particles_type &particles, typename particles_type::stype skin,
+                           typename particles_type::stype tol = 0) {
+        auto dcpse_temp = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return dcpse_temp->initializeUpdateIncremental(particles, skin, tol);
+    }
+
+    /*! \brief Save the DCPSE Kernels in a per-processor checkpoint file
+     *
+     * \param parts particle set
+     * \param checkpoint name of the checkpoint file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     */
+    template<typename particles_type>
+    bool save(particles_type &particles, const std::string &checkpoint) {
+        Dcpse<particles_type::dims, particles_type, kernel_type> *dcpse_ptr = (Dcpse<particles_type::dims, particles_type, kernel_type> *) dcpse;
+        return Dcpse<particles_type::dims, particles_type, kernel_type>::saveFamily(particles, dcpse_ptr, 1, checkpoint);
+    }
 };
 
+//! Derivative_yyy with the kernels stored in the position type of the particles (see Derivative_yyy_T to choose the storage type)
+typedef Derivative_yyy_T<> Derivative_yyy;
+
 
 
 //template<typename operand_type1, typename operand_type2/*, typename sfinae=typename std::enable_if<
@@ -20,6 +20,7 @@
 #include "util/util_debug.hpp"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <tuple>
 #include "../DCPSE_op.hpp"
 #include "../DCPSE_Solver.hpp"
 #include "Operators/Vector/vector_dist_operators.hpp"
@@ -604,6 +605,237 @@ BOOST_AUTO_TEST_SUITE(dcpse_op_suite_tests)
 
        // domain.write("Dirichlet_anasol");
     }
+    BOOST_AUTO_TEST_CASE(dcpse_poisson_parallel_assembly) {
+        const size_t sz[2] = {41,41};
+        Box<2, double> box({0, 0}, {1, 1});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        double spacing = box.getHigh(0) / (sz[0] - 1);
+        Ghost<2, double> ghost(spacing * 3.1);
+        double rCut = 3.1 * spacing;
+
+        vector_dist<2, double, aggregate<double,double,double,double>> domain(0, box, bc, ghost);
+
+        auto it = domain.getGridIterator(sz);
+        while (it.isNext()) {
+            domain.add();
+
+            auto key = it.get();
+            domain.getLastPos()[0] = key.get(0) * it.getSpacing(0);
+            domain.getLastPos()[1] = key.get(1) * it.getSpacing(1);
+
+            ++it;
+        }
+
+        domain.map();
+        domain.ghost_get<0>();
+
+        Laplacian Lap(domain, 2, rCut, 1.9, support_options::RADIUS);
+
+        openfpm::vector<aggregate<int>> bulk;
+        openfpm::vector<aggregate<int>> boundary;
+
+        Box<2, double> inner({box.getLow(0) + spacing / 2.0, box.getLow(1) + spacing / 2.0},
+                             {box.getHigh(0) - spacing / 2.0, box.getHigh(1) - spacing / 2.0});
+
+        auto it2 = domain.getDomainIterator();
+        while (it2.isNext()) {
+            auto p = it2.get();
+            Point<2, double> xp = domain.getPos(p);
+            domain.getProp<1>(p) = -2*M_PI*M_PI*sin(M_PI*xp.get(0))*sin(M_PI*xp.get(1));
+
+            if (inner.isInside(xp) == true) {
+                bulk.add();
+                bulk.last().get<0>() = p.getKey();
+            } else {
+                boundary.add();
+                boundary.last().get<0>() = p.getKey();
+                domain.getProp<1>(p) = 0.0;
+            }
+            ++it2;
+        }
+
+        auto v = getV<0>(domain);
+        auto sol = getV<2>(domain);
+        auto sol_par = getV<3>(domain);
+
+        // The same system assembled row by row and with the parallel two-pass assembly
+        DCPSE_scheme<equations2d1,decltype(domain)> Solver(domain);
+        Solver.impose(Lap(v), bulk, prop_id<1>());
+        Solver.impose(v, boundary, prop_id<1>());
+
+        DCPSE_scheme<equations2d1,decltype(domain)> Solver_par(domain);
+        Solver_par.setParallelAssembly(true);
+        Solver_par.impose(Lap(v), bulk, prop_id<1>());
+        Solver_par.impose(v, boundary, prop_id<1>());
+
+        // the serial rows are triplets, the parallel ones are CSR blocks
+        auto & trpl = Solver.getA(options_solver::STANDARD).getMatrixTriplets();
+        auto & rows_par = Solver_par.getA(options_solver::STANDARD).getMatrixRows();
+
+        BOOST_REQUIRE_EQUAL(Solver_par.getA(options_solver::STANDARD).getMatrixTriplets().size(), 0ul);
+
+        std::vector<std::tuple<long int,long int,double>> nz;
+        std::vector<std::tuple<long int,long int,double>> nz_par;
+
+        for (size_t i = 0 ; i < trpl.size() ; i++) {
+            nz.push_back(std::make_tuple((long int)trpl.get(i).row(), (long int)trpl.get(i).col(), trpl.get(i).value()));
+        }
+
+        rows_par.forEachNonZero([&](long int r, long int c, double v) {nz_par.push_back(std::make_tuple(r, c, v));});
+
+        std::sort(nz.begin(), nz.end());
+        std::sort(nz_par.begin(), nz_par.end());
+
+        BOOST_REQUIRE(nz == nz_par);
+
+        // The right hand side must be the same too
+        Solver.solve(sol);
+        Solver_par.solve(sol_par);
+
+        double worst = 0.0;
+        auto it3 = domain.getDomainIterator();
+        while (it3.isNext()) {
+            auto p = it3.get();
+            worst = std::max(worst, fabs(domain.getProp<2>(p) - domain.getProp<3>(p)));
+            ++it3;
+        }
+
+        BOOST_REQUIRE(worst < 1e-12);
+    }
+
+    /*! \brief Solve a Poisson problem with two right-hand-sides with solve_multi and check it against
+     *         two separate solves
+     *
+     * \param solver solver to use
+     * \param tol maximum difference between the solutions
+     *
+     */
+    template<typename Sys_eqs, typename SolverType>
+    void dcpse_poisson_multi_rhs(SolverType & solver, double tol) {
+        const size_t sz[2] = {31,31};
+        Box<2, double> box({0, 0}, {1, 1});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        double spacing = box.getHigh(0) / (sz[0] - 1);
+        Ghost<2, double> ghost(spacing * 3.1);
+        double rCut = 3.1 * spacing;
+
+        vector_dist<2, double, aggregate<double,double,double,double,double,double,double>> domain(0, box, bc, ghost);
+
+        auto it = domain.getGridIterator(sz);
+        while (it.isNext()) {
+            domain.add();
+
+            auto key = it.get();
+            domain.getLastPos()[0] = key.get(0) * it.getSpacing(0);
+            domain.getLastPos()[1] = key.get(1) * it.getSpacing(1);
+
+            ++it;
+        }
+
+        domain.map();
+        domain.ghost_get<0>();
+
+        Laplacian Lap(domain, 2, rCut, 1.9, support_options::RADIUS);
+
+        openfpm::vector<aggregate<int>> bulk;
+        openfpm::vector<aggregate<int>> boundary;
+
+        Box<2, double> inner({box.getLow(0) + spacing / 2.0, box.getLow(1) + spacing / 2.0},
+                             {box.getHigh(0) - spacing / 2.0, box.getHigh(1) - spacing / 2.0});
+
+        auto it2 = domain.getDomainIterator();
+        while (it2.isNext()) {
+            auto p = it2.get();
+            Point<2, double> xp = domain.getPos(p);
+
+            if (inner.isInside(xp) == true) {
+                domain.getProp<1>(p) = -2*M_PI*M_PI*sin(M_PI*xp.get(0))*sin(M_PI*xp.get(1));
+                domain.getProp<2>(p) = 6.0*xp.get(0)*xp.get(1);
+                bulk.add();
+                bulk.last().get<0>() = p.getKey();
+            } else {
+                domain.getProp<1>(p) = 0.0;
+                domain.getProp<2>(p) = xp.get(0)*xp.get(1);
+                boundary.add();
+                boundary.last().get<0>() = p.getKey();
+            }
+            ++it2;
+        }
+
+        auto v = getV<0>(domain);
+        auto sol0 = getV<3>(domain);
+        auto sol1 = getV<4>(domain);
+        auto ref0 = getV<5>(domain);
+        auto ref1 = getV<6>(domain);
+
+        // Only the right-hand-side change between the two systems
+        DCPSE_scheme<Sys_eqs,decltype(domain)> Solver(domain);
+        Solver.impose(Lap(v), bulk, prop_id<1>());
+        Solver.impose(v, boundary, prop_id<1>());
+        Solver.solve_multi_with_solver(solver,[&](size_t k){Solver.impose_b(bulk,prop_id<2>());
+                                                            Solver.impose_b(boundary,prop_id<2>());},
+                                       sol0,sol1);
+
+        DCPSE_scheme<Sys_eqs,decltype(domain)> Solver0(domain);
+        Solver0.impose(Lap(v), bulk, prop_id<1>());
+        Solver0.impose(v, boundary, prop_id<1>());
+        Solver0.solve_with_solver(solver,ref0);
+
+        DCPSE_scheme<Sys_eqs,decltype(domain)> Solver1(domain);
+        Solver1.impose(Lap(v), bulk, prop_id<2>());
+        Solver1.impose(v, boundary, prop_id<2>());
+        Solver1.solve_with_solver(solver,ref1);
+
+        double worst0 = 0.0;
+        double worst1 = 0.0;
+        double norm1 = 0.0;
+        auto it3 = domain.getDomainIterator();
+        while (it3.isNext()) {
+            auto p = it3.get();
+            worst0 = std::max(worst0, fabs(domain.getProp<3>(p) - domain.getProp<5>(p)));
+            worst1 = std::max(worst1, fabs(domain.getProp<4>(p) - domain.getProp<6>(p)));
+            norm1 = std::max(norm1, fabs(domain.getProp<6>(p)));
+            ++it3;
+        }
+
+        auto & v_cl = create_vcluster();
+        v_cl.max(worst0);
+        v_cl.max(worst1);
+        v_cl.max(norm1);
+        v_cl.execute();
+
+        // the second right-hand-side must really produce a different solution
+        BOOST_REQUIRE(norm1 > 0.1);
+        BOOST_REQUIRE(worst0 < tol);
+        BOOST_REQUIRE(worst1 < tol);
+    }
+
+    BOOST_AUTO_TEST_CASE(dcpse_poisson_multi_rhs) {
+        petsc_solver<double> solver;
+        solver.setSolver(KSPGMRES);
+        solver.setPreconditioner(PCJACOBI);
+        solver.setRelTol(1e-12);
+        solver.setAbsTol(1e-14);
+
+        dcpse_poisson_multi_rhs<equations2d1>(solver,1e-8);
+    }
+
+#if defined(HAVE_SUITESPARSE)
+
+    BOOST_AUTO_TEST_CASE(dcpse_poisson_multi_rhs_umfpack) {
+        auto & v_cl = create_vcluster();
+
+        // umfpack is not a parallel solver
+        if (v_cl.getProcessingUnits() != 1)
+        {return;}
+
+        umfpack_solver<double> solver;
+
+        dcpse_poisson_multi_rhs<equations2d1E>(solver,1e-10);
+    }
+
+#endif
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     BOOST_AUTO_TEST_CASE(dcpse_poisson_Periodic) {
@@ -14,6 +14,9 @@
 #include "Vandermonde.hpp"
 #include "DcpseDiagonalScalingMatrix.hpp"
 #include "DcpseRhs.hpp"
+#include "DcpseMomentSolver.hpp"
+#include <fstream>
+#include <cstdint>
 
 template<bool cond>
 struct is_scalar {
@@ -35,11 +38,24 @@ struct is_scalar<false> {
 	};
 };
 
-template<unsigned int dim, typename vector_type>
+//! Tag for the Dcpse constructor that does not compute the kernels (see Dcpse::initializeFamily)
+struct dcpse_family_member {};
+
+/*! \brief DCPSE operator
+ *
+ * \tparam dim dimensionality
+ * \tparam vector_type particles type
+ * \tparam kernel_storage type used to store the kernels (void for the position type of the particles).
+ *         The moment systems are always solved, and the operator applications accumulated, in the
+ *         position type: storing the kernels in float halve the memory traffic of the operator application
+ *
+ */
+template<unsigned int dim, typename vector_type, typename kernel_storage = void>
 class Dcpse {
 public:
 
     typedef typename vector_type::stype T;
+    typedef typename std::conditional<std::is_same<kernel_storage, void>::value, T, kernel_storage>::type kernel_type;
     typedef typename vector_type::value_type part_type;
     typedef vector_type vtype;
 
@@ -58,13 +74,31 @@ private:
     const unsigned int differentialOrder;
     const MonomialBasis<dim> monomialBasis;
     //std::vector<EMatrix<T, Eigen::Dynamic, 1>> localCoefficients; // Each MPI rank has just access to the local ones
-    std::vector<Support> localSupports; // Each MPI rank has just access to the local ones
+    // Supports are stored in CSR form aligned with calcKernels: the keys of the support of the particle k
+    // are supportKeys1D.get(kerOffsets.get(k) + j) with j < supportSizes.get(k)
+    openfpm::vector<unsigned int> supportSizes; // Each MPI rank has just access to the local ones
+    openfpm::vector<unsigned int> supportKeys1D;
     std::vector<T> localEps; // Each MPI rank has just access to the local ones
     std::vector<T> localEpsInvPow; // Each MPI rank has just access to the local ones
     std::vector<T> localSumA;
 
     openfpm::vector<size_t> kerOffsets;
-    openfpm::vector<T> calcKernels;
+    openfpm::vector<kernel_type> calcKernels;
+
+    // Positions (local and ghost particles) used by the incremental update, at the last construction
+    // of the candidate supports and at the last computation of the kernels
+    std::vector<Point<dim, T>> refPos;
+    std::vector<Point<dim, T>> kerPos;
+
+    // Candidate supports of the incremental update in CSR form (same indexing as supportSizes): the
+    // particles nearer than rCut + candSkin at the positions refPos. candSkin is negative when the
+    // candidates have not been built
+    openfpm::vector<size_t> candOffsets;
+    openfpm::vector<unsigned int> candKeys;
+    T candSkin = -1;
+
+    // map counter of the particles at the last construction of the kernels
+    size_t refMapCtr = 0;
 
     vector_type & particles;
     double rCut;
@@ -99,12 +133,117 @@ public:
         particles.ghost_get_subset();
         if (supportSizeFactor < 1) 
         {
-            initializeAdaptive(particles, convergenceOrder, rCut);
+            initializeAdaptive(particles, convergenceOrder, rCut, supportSizeFactor);
         } 
         else 
         {
             initializeStaticSize(particles, convergenceOrder, rCut, supportSizeFactor);
         }
+
+        storeReferencePositions(particles);
+    }
+
+    /*! \brief Constructor that only set the parameters of the operator
+     *
+     * The kernels are computed later, together with the other operators of a family, by initializeFamily
+     *
+     */
+    Dcpse(vector_type &particles,
+          Point<dim, unsigned int> differentialSignature,
+          unsigned int convergenceOrder,
+          T rCut,
+          T supportSizeFactor,
+          support_options opt,
+          dcpse_family_member)
+		:particles(particles),
+            differentialSignature(differentialSignature),
+            differentialOrder(Monomial<dim>(differentialSignature).order()),
+            monomialBasis(differentialSignature.asArray(), convergenceOrder),
+            rCut(rCut),
+            convergenceOrder(convergenceOrder),
+            supportSizeFactor(supportSizeFactor),
+            opt(opt)
+    {
+        particles.ghost_get_subset();
+    }
+
+    /*! \brief Compute (or recompute after a map) the kernels of several operators on the same particles
+     *
+     * Operators with the same monomial basis (differential signatures of the same order), support options,
+     * rCut and oversampling factor are grouped. For each group the supports, eps and the moment matrix are
+     * computed once per particle, and the coefficients of all the operators of the group are obtained
+     * from a single factorization. Operators of different groups are computed independently.
+     *
+     * \param particles set of particles
+     * \param ops operators
+     * \param nOps number of operators
+     *
+     */
+    static void initializeFamily(vector_type &particles, Dcpse * ops, size_t nOps)
+    {
+        std::vector<std::vector<Dcpse *>> groups;
+        getFamilies(ops, nOps, groups);
+
+        for (size_t g = 0 ; g < groups.size() ; g++) {
+            std::vector<Dcpse *> & group = groups[g];
+            Dcpse & lead = *group[0];
+
+            for (size_t k = 0 ; k < group.size() ; k++) {
+#ifdef SE_CLASS1
+                group[k]->update_ctr=particles.getMapCtr();
+#endif
+                group[k]->clearKernels();
+            }
+
+            bool adaptive = lead.supportSizeFactor < 1;
+            unsigned int requiredSupportSize = lead.monomialBasis.size();
+            if (adaptive == false) {
+                requiredSupportSize = lead.monomialBasis.size() * lead.supportSizeFactor;
+            }
+
+            initializeKernels(particles, group.data(), group.size(), requiredSupportSize, adaptive);
+
+            for (size_t k = 0 ; k < group.size() ; k++)
+            {group[k]->storeReferencePositions(particles);}
+        }
+    }
+
+    /*! \brief Group the operators that can be computed together (see isSameFamily)
+     *
+     * \param ops operators
+     * \param nOps number of operators
+     * \param groups groups of operators, in the order of their first member
+     *
+     */
+    static void getFamilies(Dcpse * ops, size_t nOps, std::vector<std::vector<Dcpse *>> & groups)
+    {
+        std::vector<bool> done(nOps, false);
+        groups.clear();
+
+        for (size_t i = 0 ; i < nOps ; i++) {
+            if (done[i] == true) {continue;}
+
+            groups.emplace_back();
+            for (size_t j = i ; j < nOps ; j++) {
+                if (done[j] == false && ops[i].isSameFamily(ops[j])) {
+                    groups.back().push_back(&ops[j]);
+                    done[j] = true;
+                }
+            }
+        }
+    }
+
+    /*! \brief Check if the supports and the moment matrix of this operator can be shared with another one
+     *
+     * \param other operator
+     *
+     * \return true if the two operators can be computed together
+     *
+     */
+    bool isSameFamily(const Dcpse & other) const
+    {
+        return monomialBasis == other.monomialBasis && opt == other.opt &&
+               rCut == other.rCut && supportSizeFactor == other.supportSizeFactor;
     }
 
 
@@ -112,27 +251,23 @@ public:
     template<unsigned int prp>
     void DrawKernel(vector_type &particles, int k)
     {
-        Support support = localSupports[k];
-        size_t xpK = k;
         size_t kerOff = kerOffsets.get(k);
-        auto & keys = support.getKeys();
-        for (int i = 0 ; i < keys.size() ; i++)
+        size_t supportSize = supportSizes.get(k);
+        for (int i = 0 ; i < supportSize ; i++)
         {
-        	size_t xqK = keys[i];
-            particles.template getProp<prp>(xqK) += calcKernels.get(kerOff+i);
+        	size_t xqK = supportKeys1D.get(kerOff+i);
+            particles.template getProp<prp>(xqK) += (T)calcKernels.get(kerOff+i);
         }
     }
 
     template<unsigned int prp>
     void DrawKernelNN(vector_type &particles, int k)
     {
-        Support support = localSupports[k];
-        size_t xpK = k;
         size_t kerOff = kerOffsets.get(k);
-        auto & keys = support.getKeys();
-        for (int i = 0 ; i < keys.size() ; i++)
+        size_t supportSize = supportSizes.get(k);
+        for (int i = 0 ; i < supportSize ; i++)
         {
-        	size_t xqK = keys[i];
+        	size_t xqK = supportKeys1D.get(kerOff+i);
             particles.template getProp<prp>(xqK) = 1.0;
         }
     }
@@ -140,14 +275,12 @@ public:
     template<unsigned int prp>
     void DrawKernel(vector_type &particles, int k, int i)
     {
-        Support support = localSupports[k];
-        size_t xpK = k;
         size_t kerOff = kerOffsets.get(k);
-        auto & keys = support.getKeys();
-        for (int i = 0 ; i < keys.size() ; i++)
+        size_t supportSize = supportSizes.get(k);
+        for (int i = 0 ; i < supportSize ; i++)
         {
-        	size_t xqK = keys[i];
-            particles.template getProp<prp>(xqK)[i] += calcKernels.get(kerOff+i);
+        	size_t xqK = supportKeys1D.get(kerOff+i);
+            particles.template getProp<prp>(xqK)[i] += (T)calcKernels.get(kerOff+i);
         }
     }
 
@@ -165,40 +298,34 @@ public:
             momenta.template get<1>(i) = -3000000000.0;
         }
 
+        std::vector<T> mbValues(monomialBasis.size());
+
         auto it = particles.getDomainIterator();
-        auto supportsIt = localSupports.begin();
-        auto epsIt = localEps.begin();
+        size_t xpK = 0;
         while (it.isNext())
         {
-            double eps = *epsIt;
+            double eps = localEps[xpK];
 
             for (int i = 0 ; i < momenta.size() ; i++)
             {
                 momenta_accu.template get<0>(i) =  0.0;
             }
 
-            Support support = *supportsIt;
-            size_t xpK = support.getReferencePointKey();
-            Point<dim, T> xp = particles.getPos(support.getReferencePointKey());
+            Point<dim, T> xp = particles.getPos(xpK);
             size_t kerOff = kerOffsets.get(xpK);
-            auto & keys = support.getKeys();
-            for (int i = 0 ; i < keys.size() ; i++)
+            size_t supportSize = supportSizes.get(xpK);
+            for (int i = 0 ; i < supportSize ; i++)
             {
-            	size_t xqK = keys[i];
+            	size_t xqK = supportKeys1D.get(kerOff+i);
                 Point<dim, T> xq = particles.getPosOrig(xqK);
                 Point<dim, T> normalizedArg = (xp - xq) / eps;
 
-                auto ker = calcKernels.get(kerOff+i);
+                T ker = calcKernels.get(kerOff+i);
 
-                int counter = 0;
-                for (const Monomial<dim> &m : monomialBasis.getElements())
+                monomialBasis.evaluate(normalizedArg, mbValues.data());
+                for (int counter = 0 ; counter < monomialBasis.size() ; counter++)
                 {
-                    T mbValue = m.evaluate(normalizedArg);
-
-
-                    momenta_accu.template get<0>(counter) += mbValue * ker;
-
-                    ++counter;
+                    momenta_accu.template get<0>(counter) += mbValues[counter] * ker;
                 }
 
             }
@@ -218,8 +345,7 @@ public:
 
             //
             ++it;
-            ++supportsIt;
-            ++epsIt;
+            ++xpK;
         }
 
         for (int i = 0 ; i < momenta.size() ; i++)
@@ -244,24 +370,20 @@ public:
         }
 
         auto it = particles.getDomainIterator();
-        auto supportsIt = localSupports.begin();
-        auto epsItInvPow = localEpsInvPow.begin();
+        size_t xpK = 0;
         while (it.isNext()) {
-            double epsInvPow = *epsItInvPow;
+            double epsInvPow = localEpsInvPow[xpK];
 
             T Dfxp = 0;
-            Support support = *supportsIt;
-            size_t xpK = support.getReferencePointKey();
-            Point<dim, typename vector_type::stype> xp = particles.getPos(support.getReferencePointKey());
             T fxp = sign * particles.template getProp<fValuePos>(xpK);
             size_t kerOff = kerOffsets.get(xpK);
-            auto & keys = support.getKeys();
-            for (int i = 0 ; i < keys.size() ; i++)
+            size_t supportSize = supportSizes.get(xpK);
+            for (int i = 0 ; i < supportSize ; i++)
             {
-            	size_t xqK = keys[i];
+            	size_t xqK = supportKeys1D.get(kerOff+i);
                 T fxq = particles.template getProp<fValuePos>(xqK);
 
-                Dfxp += (fxq + fxp) * calcKernels.get(kerOff+i);
+                Dfxp += (fxq + fxp) * (T)calcKernels.get(kerOff+i);
             }
             Dfxp *= epsInvPow;
             //
@@ -270,8 +392,7 @@ public:
             particles.template getProp<DfValuePos>(xpK) = Dfxp;
             //
             ++it;
-            ++supportsIt;
-            ++epsItInvPow;
+            ++xpK;
         }
     }
 
@@ -283,7 +404,7 @@ public:
      */
     inline int getNumNN(const vect_dist_key_dx &key)
     {
-        return localSupports[key.getKey()].size();
+        return supportSizes.get(key.getKey());
     }
 
     /*! \brief Get the coefficent j (Neighbour) of the particle key
@@ -307,10 +428,26 @@ public:
  */
     inline size_t getIndexNN(const vect_dist_key_dx &key, int j)
     {
-        return localSupports[key.getKey()].getKeys()[j];
+        return supportKeys1D.get(kerOffsets.get(key.getKey()) + j);
     }
 
 
+    /*! \brief Get a view of the support of a particle
+     *
+     * \param key particle
+     *
+     * \return the support
+     *
+     */
+    inline SupportView getSupport(const vect_dist_key_dx &key) const
+    {
+        size_t supportSize = supportSizes.get(key.getKey());
+        if (supportSize == 0)
+        {return SupportView(key.getKey(), NULL, 0);}
+
+        return SupportView(key.getKey(), &supportKeys1D.get(kerOffsets.get(key.getKey())), supportSize);
+    }
+
     inline T getSign()
     {
         T sign = 1.0;
@@ -359,17 +496,15 @@ public:
 #endif
 
         expr_type Dfxp = 0;
-        Support support = localSupports[key.getKey()];
-        size_t xpK = support.getReferencePointKey();
-        Point<dim, T> xp = particles.getPos(xpK);
+        size_t xpK = key.getKey();
         expr_type fxp = sign * o1.value(key);
         size_t kerOff = kerOffsets.get(xpK);
-        auto & keys = support.getKeys();
-        for (int i = 0 ; i < keys.size() ; i++)
+        size_t supportSize = supportSizes.get(xpK);
+        for (int i = 0 ; i < supportSize ; i++)
         {
-        	size_t xqK = keys[i];
+        	size_t xqK = supportKeys1D.get(kerOff+i);
             expr_type fxq = o1.value(vect_dist_key_dx(xqK));
-            Dfxp = Dfxp + (fxq + fxp) * calcKernels.get(kerOff+i);
+            Dfxp = Dfxp + (fxq + fxp) * (T)calcKernels.get(kerOff+i);
         }
         Dfxp = Dfxp * epsInvPow;
         //
@@ -415,17 +550,15 @@ public:
 #endif
 
         expr_type Dfxp = 0;
-        Support support = localSupports[key.getKey()];
-        size_t xpK = support.getReferencePointKey();
-        Point<dim, T> xp = particles.getPos(xpK);
+        size_t xpK = key.getKey();
         expr_type fxp = sign * o1.value(key)[i];
         size_t kerOff = kerOffsets.get(xpK);
-        auto & keys = support.getKeys();
-        for (int j = 0 ; j < keys.size() ; j++)
+        size_t supportSize = supportSizes.get(xpK);
+        for (int j = 0 ; j < supportSize ; j++)
         {
-        	size_t xqK = keys[j];
+        	size_t xqK = supportKeys1D.get(kerOff+j);
             expr_type fxq = o1.value(vect_dist_key_dx(xqK))[i];
-            Dfxp = Dfxp + (fxq + fxp) * calcKernels.get(kerOff+j);
+            Dfxp = Dfxp + (fxq + fxp) * (T)calcKernels.get(kerOff+j);
         }
         Dfxp = Dfxp * epsInvPow;
         //
@@ -434,155 +567,748 @@ public:
         return Dfxp;
     }
 
+    /*! \brief Update the operator after the particles moved, recomputing only what changed
+     *
+     * It work like a Verlet list with a skin. The candidate supports contain the particles nearer
+     * than rCut + skin, and as long as no particle moved more than skin/2 since they have been built
+     * they contain every particle that is now nearer than rCut. At every update the supports are
+     * filtered again from the candidates with the current positions, so particles entering or leaving
+     * the rCut sphere are added to or removed from the supports, and the kernels are recomputed for the
+     * particles whose support changed, or for which the particle itself or one particle of its support
+     * moved more than tol. The result is the same operator a full construction would give.
+     *
+     * The operator is fully rebuilt if the particles have been redistributed with a map, the number of
+     * local or ghost particles changed, or one particle moved more than skin/2 since the candidates
+     * have been built. The candidates are built from the current positions at the first call (or when
+     * the skin changes).
+     *
+     * Only supports built with support_options::RADIUS can be updated incrementally. With
+     * support_options::N_PARTICLES the operator is rebuilt as soon as one particle moved more than tol.
+     *
+     * Between two updates the ghost must keep the same particles with up to date positions
+     * (ghost_get with SKIP_LABELLING), and it must be at least rCut + skin wide
+     *
+     * \param particles set of particles
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operator has been rebuilt
+     *
+     */
+    bool initializeUpdateIncremental(vector_type &particles, T skin, T tol = 0)
+    {
+        return initializeFamilyIncremental(particles, this, 1, skin, tol);
+    }
+
+    /*! \brief Incremental update (see initializeUpdateIncremental) of several operators on the same particles
+     *
+     * The operators of the same family (see isSameFamily) share supports, candidates and reference positions:
+     * the rebuild check, the candidates and the detection of the moved particles are done once per family,
+     * and only the moment systems are solved for the right hand sides of all the operators of the family.
+     * If one of the operators must be rebuilt, all of them are rebuilt together with initializeFamily
+     *
+     * \param particles set of particles
+     * \param ops operators
+     * \param nOps number of operators
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the update has been incremental, false if the operators have been rebuilt
+     *
+     */
+    static bool initializeFamilyIncremental(vector_type &particles, Dcpse * ops, size_t nOps, T skin, T tol = 0)
+    {
+        size_t nAll = particles.size_local_with_ghost();
+
+        std::vector<std::vector<Dcpse *>> groups;
+        getFamilies(ops, nOps, groups);
+
+        // Members updated separately do not share the reference positions, they are rebuilt together
+        bool rebuild = false;
+        for (size_t g = 0 ; g < groups.size() && rebuild == false ; g++)
+        {
+            Dcpse & lead = *groups[g][0];
+
+            for (size_t k = 1 ; k < groups[g].size() && rebuild == false ; k++)
+            {rebuild = lead.isSynchronized(*groups[g][k]) == false;}
+
+            if (rebuild == false)
+            {rebuild = lead.needsRebuild(particles, nAll, skin, tol);}
+        }
+
+        if (rebuild == true)
+        {
+            initializeFamily(particles, ops, nOps);
+            for (size_t g = 0 ; g < groups.size() ; g++)
+            {
+                groups[g][0]->buildCandidates(particles, skin);
+                shareCandidates(groups[g]);
+            }
+
+            return false;
+        }
+
+        for (size_t g = 0 ; g < groups.size() ; g++)
+        {
+            Dcpse & lead = *groups[g][0];
+
+            if (lead.opt == support_options::N_PARTICLES)
+            {continue;}
+
+            if (lead.candSkin != skin)
+            {
+                lead.buildCandidates(particles, skin);
+                shareCandidates(groups[g]);
+            }
+
+#ifdef SE_CLASS1
+            for (size_t k = 0 ; k < groups[g].size() ; k++)
+            {groups[g][k]->update_ctr=particles.getMapCtr();}
+#endif
+            updateMovedKernels(particles, groups[g].data(), groups[g].size(), nAll, tol);
+        }
+
+        return true;
+    }
+
+    /*! \brief Save the operator in a per-processor binary file
+     *
+     * \param particles set of particles on which the operator has been computed
+     * \param file name of the file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     *
+     */
+    bool save(vector_type &particles, const std::string &file)
+    {
+        return saveFamily(particles, this, 1, file);
+    }
+
+    /*! \brief Load the operator from a file written by save
+     *
+     * The operator is loaded only if the file has been written for the same particle positions (local
+     * and ghost), decomposition, number of processors and operator parameters
+     *
+     * \param particles set of particles
+     * \param file name of the file (the processor id is appended)
+     *
+     * \return true if the operator has been loaded, false if the file does not exist or does not match
+     *
+     */
+    bool load(vector_type &particles, const std::string &file)
+    {
+        return loadFamily(particles, this, 1, file);
+    }
+
+    /*! \brief Save several operators in a per-processor binary file
+     *
+     * \param particles set of particles on which the operators have been computed
+     * \param ops operators
+     * \param nOps number of operators
+     * \param file name of the file (the processor id is appended)
+     *
+     * \return true if the file has been written
+     *
+     */
+    static bool saveFamily(vector_type &particles, Dcpse * ops, size_t nOps, const std::string &file)
+    {
+        std::ofstream out(getCheckpointFile(file), std::ios::binary);
+        if (!out.is_open())
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error: cannot write the DCPSE checkpoint " << getCheckpointFile(file) << std::endl;
+            return false;
+        }
+
+        uint64_t header[3] = {checkpointMagic, getCheckpointHash(particles, ops, nOps), nOps};
+        out.write((const char *)header, sizeof(header));
+
+        for (size_t k = 0 ; k < nOps ; k++)
+        {ops[k].writeState(out);}
+
+        return out.good();
+    }
+
+    /*! \brief Load several operators from a file written by saveFamily
+     *
+     * \param particles set of particles
+     * \param ops operators
+     * \param nOps number of operators
+     * \param file name of the file (the processor id is appended)
+     *
+     * \return true if all the operators have been loaded
+     *
+     */
+    static bool loadFamily(vector_type &particles, Dcpse * ops, size_t nOps, const std::string &file)
+    {
+        std::ifstream in(getCheckpointFile(file), std::ios::binary);
+        if (!in.is_open())
+        {return false;}
+
+        uint64_t header[3];
+        in.read((char *)header, sizeof(header));
+
+        if (!in.good() || header[0] != checkpointMagic || header[2] != nOps ||
+            header[1] != getCheckpointHash(particles, ops, nOps))
+        {return false;}
+
+        for (size_t k = 0 ; k < nOps ; k++)
+        {
+            if (ops[k].readState(in) == false)
+            {
+                for (size_t j = 0 ; j <= k ; j++)
+                {ops[j].clearKernels();}
+
+                return false;
+            }
+
+#ifdef SE_CLASS1
+            ops[k].update_ctr=particles.getMapCtr();
+#endif
+            ops[k].storeReferencePositions(particles);
+        }
+
+        return true;
+    }
+
+    /*! \brief Load the operators from a checkpoint if it match the particles, otherwise compute them
+     *         (see initializeFamily) and write the checkpoint
+     *
+     * \param particles set of particles
+     * \param ops operators
+     * \param nOps number of operators
+     * \param file name of the checkpoint (the processor id is appended)
+     *
+     * \return true if the operators have been loaded from the checkpoint
+     *
+     */
+    static bool initializeFamilyCheckpoint(vector_type &particles, Dcpse * ops, size_t nOps, const std::string &file)
+    {
+        if (loadFamily(particles, ops, nOps, file) == true)
+        {return true;}
+
+        initializeFamily(particles, ops, nOps);
+        saveFamily(particles, ops, nOps, file);
+
+        return false;
+    }
+
     void initializeUpdate(vector_type &particles)
     {
 #ifdef SE_CLASS1
         update_ctr=particles.getMapCtr();
 #endif
 
-        localSupports.clear();
-        localSupports.resize(particles.size_local_orig());
+        clearKernels();
+
+        if (supportSizeFactor < 1) {
+            initializeKernels(particles, monomialBasis.size(), true);
+        } else {
+            unsigned int requiredSupportSize = monomialBasis.size() * supportSizeFactor;
+
+            initializeKernels(particles, requiredSupportSize, false);
+        }
+
+        storeReferencePositions(particles);
+    }
+
+private:
+
+    //! "DCPSECKP" identify the checkpoint files
+    static const uint64_t checkpointMagic = 0x504B434553504344ull;
+
+    /*! \brief Name of the checkpoint file of this processor
+     *
+     */
+    static std::string getCheckpointFile(const std::string &file)
+    {
+        return file + "_" + std::to_string(create_vcluster().getProcessUnitID());
+    }
+
+    //! FNV-1a hash of a sequence of bytes
+    static void hashBytes(uint64_t &hash, const void * data, size_t size)
+    {
+        const unsigned char * bytes = (const unsigned char *)data;
+        for (size_t i = 0 ; i < size ; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    /*! \brief Hash that identify the particles (positions of local and ghost particles, decomposition and
+     *         number of processors) and the parameters of the operators
+     *
+     */
+    static uint64_t getCheckpointHash(vector_type &particles, Dcpse * ops, size_t nOps)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        auto & v_cl = create_vcluster();
+        size_t procs[2] = {v_cl.getProcessUnitID(), v_cl.getProcessingUnits()};
+        hashBytes(hash, procs, sizeof(procs));
+
+        auto & dec = particles.getDecomposition();
+        for (size_t i = 0 ; i < dec.getNSubDomain() ; i++)
+        {
+            auto box = dec.getSubDomain(i);
+            for (size_t j = 0 ; j < dim ; j++)
+            {
+                T bounds[2] = {box.getLow(j), box.getHigh(j)};
+                hashBytes(hash, bounds, sizeof(bounds));
+            }
+        }
+
+        size_t sizes[2] = {particles.size_local_orig(), particles.size_local_with_ghost()};
+        hashBytes(hash, sizes, sizeof(sizes));
+
+        for (size_t i = 0 ; i < sizes[1] ; i++)
+        {
+            Point<dim, T> xp = particles.getPosOrig(i);
+            for (size_t j = 0 ; j < dim ; j++)
+            {
+                T x = xp.get(j);
+                hashBytes(hash, &x, sizeof(x));
+            }
+        }
+
+        for (size_t k = 0 ; k < nOps ; k++)
+        {
+            for (size_t j = 0 ; j < dim ; j++)
+            {
+                unsigned int s = ops[k].differentialSignature.get(j);
+                hashBytes(hash, &s, sizeof(s));
+            }
+
+            double params[3] = {(double)ops[k].convergenceOrder, ops[k].rCut, ops[k].supportSizeFactor};
+            int opt = ops[k].opt;
+            size_t kSize = sizeof(kernel_type);
+            hashBytes(hash, params, sizeof(params));
+            hashBytes(hash, &opt, sizeof(opt));
+            hashBytes(hash, &kSize, sizeof(kSize));
+        }
+
+        return hash;
+    }
+
+    /*! \brief Write supports, eps and kernels of the operator
+     *
+     */
+    void writeState(std::ofstream &out) const
+    {
+        uint64_t n;
+
+        n = supportSizes.size();
+        out.write((const char *)&n, sizeof(n));
+        if (n != 0) {out.write((const char *)&supportSizes.get(0), n * sizeof(unsigned int));}
+        if (n != 0) {out.write((const char *)&kerOffsets.get(0), n * sizeof(size_t));}
+        if (n != 0) {out.write((const char *)localEps.data(), n * sizeof(T));}
+        if (n != 0) {out.write((const char *)localEpsInvPow.data(), n * sizeof(T));}
+
+        n = calcKernels.size();
+        out.write((const char *)&n, sizeof(n));
+        if (n != 0) {out.write((const char *)&supportKeys1D.get(0), n * sizeof(unsigned int));}
+        if (n != 0) {out.write((const char *)&calcKernels.get(0), n * sizeof(kernel_type));}
+    }
+
+    /*! \brief Read supports, eps and kernels written by writeState
+     *
+     * \return true if the state has been read
+     *
+     */
+    bool readState(std::ifstream &in)
+    {
+        uint64_t n;
+
+        clearKernels();
+
+        in.read((char *)&n, sizeof(n));
+        if (!in.good()) {return false;}
+
+        supportSizes.resize(n);
+        kerOffsets.resize(n);
+        localEps.resize(n);
+        localEpsInvPow.resize(n);
+        if (n != 0) {in.read((char *)&supportSizes.get(0), n * sizeof(unsigned int));}
+        if (n != 0) {in.read((char *)&kerOffsets.get(0), n * sizeof(size_t));}
+        if (n != 0) {in.read((char *)localEps.data(), n * sizeof(T));}
+        if (n != 0) {in.read((char *)localEpsInvPow.data(), n * sizeof(T));}
+
+        in.read((char *)&n, sizeof(n));
+        if (!in.good()) {return false;}
+
+        supportKeys1D.resize(n);
+        calcKernels.resize(n);
+        if (n != 0) {in.read((char *)&supportKeys1D.get(0), n * sizeof(unsigned int));}
+        if (n != 0) {in.read((char *)&calcKernels.get(0), n * sizeof(kernel_type));}
+
+        return in.good();
+    }
+
+    void clearKernels()
+    {
+        supportSizes.clear();
+        supportKeys1D.clear();
         localEps.clear();
-        localEps.resize(particles.size_local_orig());
         localEpsInvPow.clear();
-        localEpsInvPow.resize(particles.size_local_orig());
         calcKernels.clear();
         kerOffsets.clear();
-        kerOffsets.resize(particles.size_local_orig());
-        kerOffsets.fill(-1);
+        refPos.clear();
+        kerPos.clear();
+        candOffsets.clear();
+        candKeys.clear();
+        candSkin = -1;
+    }
 
-        SupportBuilder<vector_type> supportBuilder(particles, differentialSignature, rCut);
-        unsigned int requiredSupportSize = monomialBasis.size() * supportSizeFactor;
+    /*! \brief Square of the distance between two points
+     *
+     */
+    static T distance2(const Point<dim, T> & a, const Point<dim, T> & b)
+    {
+        T d2 = 0;
+        for (unsigned int i = 0 ; i < dim ; i++)
+        {d2 += (a.get(i) - b.get(i)) * (a.get(i) - b.get(i));}
+
+        return d2;
+    }
+
+    /*! \brief Store the current positions and map counter as the reference of the incremental update
+     *
+     * It is called every time the kernels are computed from scratch. The candidate supports are
+     * invalidated, they are built by the next incremental update
+     *
+     * \param particles set of particles
+     *
+     */
+    void storeReferencePositions(vector_type &particles)
+    {
+        size_t nAll = particles.size_local_with_ghost();
+
+        refPos.resize(nAll);
+        for (size_t i = 0 ; i < nAll ; i++)
+        {refPos[i] = particles.getPosOrig(i);}
+
+        kerPos = refPos;
+        refMapCtr = particles.getMapCtr();
+
+        candOffsets.clear();
+        candKeys.clear();
+        candSkin = -1;
+    }
+
+    /*! \brief Build the candidate supports: for every domain particle the particles nearer than rCut + skin
+     *
+     * The current positions become the reference for the skin/2 displacement check
+     *
+     * \param particles set of particles
+     * \param skin skin distance
+     *
+     */
+    void buildCandidates(vector_type &particles, T skin)
+    {
+        size_t nAll = particles.size_local_with_ghost();
+
+        refPos.resize(nAll);
+        for (size_t i = 0 ; i < nAll ; i++)
+        {refPos[i] = particles.getPosOrig(i);}
+
+        candSkin = skin;
+
+        if (opt == support_options::N_PARTICLES)
+        {return;}
+
+        SupportBuilder<vector_type> supportBuilder(particles, differentialSignature, rCut + skin);
+
+        std::vector<vect_dist_key_dx> keys;
+        std::vector<vect_dist_key_dx> keysOrig;
 
         auto it = particles.getDomainIterator();
         while (it.isNext()) {
-            // Get the points in the support of the DCPSE kernel and store the support for reuse
-            //Support<vector_type> support = supportBuilder.getSupport(it, requiredSupportSize,opt);
-            Support support = supportBuilder.getSupport(it, requiredSupportSize,opt);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(support.size(), monomialBasis.size());
+            keys.push_back(it.get());
+            keysOrig.push_back(it.getOrig());
+            ++it;
+        }
 
-            auto key_o = particles.getOriginKey(it.get());
+        std::vector<Support> candidates(keys.size());
 
-            // Vandermonde matrix computation
-            Vandermonde<dim, T, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>>
-                    vandermonde(support, monomialBasis,particles);
-            vandermonde.getMatrix(V);
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(dynamic,64)
+#endif
+        for (size_t i = 0 ; i < keys.size() ; i++)
+        {candidates[i] = supportBuilder.getSupport(keys[i], keysOrig[i], 0, support_options::RADIUS);}
+
+        candOffsets.resize(particles.size_local_orig());
+        size_t nCand = 0;
+        for (size_t i = 0 ; i < keys.size() ; i++) {
+            candOffsets.get(particles.getOriginKey(keys[i]).getKey()) = nCand;
+            nCand += candidates[i].size();
+        }
 
-            T eps = vandermonde.getEps();
-
-            localSupports[key_o.getKey()] = support;
-            localEps[key_o.getKey()] = eps;
-            localEpsInvPow[key_o.getKey()] = 1.0 / openfpm::math::intpowlog(eps,differentialOrder);
-            // Compute the diagonal matrix E
-            DcpseDiagonalScalingMatrix<dim> diagonalScalingMatrix(monomialBasis);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> E(support.size(), support.size());
-            diagonalScalingMatrix.buildMatrix(E, support, eps, particles);
-            // Compute intermediate matrix B
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> B = E * V;
-            // Compute matrix A
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
-
-            // Compute RHS vector b
-            DcpseRhs<dim> rhs(monomialBasis, differentialSignature);
-            EMatrix<T, Eigen::Dynamic, 1> b(monomialBasis.size(), 1);
-            rhs.template getVector<T>(b);
-            // Get the vector where to store the coefficients...
-            EMatrix<T, Eigen::Dynamic, 1> a(monomialBasis.size(), 1);
-            // ...solve the linear system...
-            a = A.colPivHouseholderQr().solve(b);
-            // ...and store the solution for later reuse
-            kerOffsets.get(key_o.getKey()) = calcKernels.size();
-
-            Point<dim, T> xp = particles.getPosOrig(key_o);
-
-            for (auto &xqK : support.getKeys())
-            {
-                Point<dim, T> xq = particles.getPosOrig(xqK);
-                Point<dim, T> normalizedArg = (xp - xq) / eps;
+        candKeys.resize(nCand);
+        for (size_t i = 0 ; i < keys.size() ; i++) {
+            size_t off = candOffsets.get(particles.getOriginKey(keys[i]).getKey());
+            auto & cKeys = candidates[i].getKeys();
+            for (size_t j = 0 ; j < cKeys.size() ; j++)
+            {candKeys.get(off + j) = cKeys[j];}
+        }
+    }
 
-                calcKernels.add(computeKernel(normalizedArg, a));
-            }
-            //
-            ++it;
+    /*! \brief Copy the candidates of the first operator of a family to the others
+     *
+     * \param group operators of the family
+     *
+     */
+    static void shareCandidates(std::vector<Dcpse *> & group)
+    {
+        Dcpse & lead = *group[0];
+
+        for (size_t k = 1 ; k < group.size() ; k++)
+        {
+            group[k]->refPos = lead.refPos;
+            group[k]->candSkin = lead.candSkin;
+            group[k]->candOffsets = lead.candOffsets;
+            group[k]->candKeys = lead.candKeys;
         }
     }
 
-private:
+    /*! \brief Check if another operator of the family has the same reference positions and candidates
+     *
+     * \param other operator
+     *
+     * \return true if the two operators can be updated together
+     *
+     */
+    bool isSynchronized(const Dcpse & other) const
+    {
+        if (refMapCtr != other.refMapCtr || candSkin != other.candSkin ||
+            refPos.size() != other.refPos.size() || kerPos.size() != other.kerPos.size() ||
+            kerOffsets.size() != other.kerOffsets.size() || candKeys.size() != other.candKeys.size())
+        {return false;}
 
-    void initializeAdaptive(vector_type &particles,
-                            unsigned int convergenceOrder,
-                            T rCut) {
-        SupportBuilder<vector_type>
-                supportBuilder(particles, differentialSignature, rCut);
-        unsigned int requiredSupportSize = monomialBasis.size();
+        for (size_t i = 0 ; i < kerPos.size() ; i++)
+        {
+            if (distance2(kerPos[i], other.kerPos[i]) != 0)
+            {return false;}
+        }
 
-        localSupports.resize(particles.size_local_orig());
-        localEps.resize(particles.size_local_orig());
-        localEpsInvPow.resize(particles.size_local_orig());
-        kerOffsets.resize(particles.size_local_orig());
-        kerOffsets.fill(-1);
+        for (size_t i = 0 ; i < refPos.size() ; i++)
+        {
+            if (distance2(refPos[i], other.refPos[i]) != 0)
+            {return false;}
+        }
 
+        return true;
+    }
+
+    /*! \brief Check if the operator must be rebuilt
+     *
+     * The operator is rebuilt if the particles have been redistributed with a map, the number of
+     * particles changed, or one particle moved more than half of the skin since the candidate supports
+     * have been built. With support_options::N_PARTICLES it is rebuilt as soon as one particle moved
+     * more than tol
+     *
+     * \param particles set of particles
+     * \param nAll number of local and ghost particles
+     * \param skin skin distance
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return true if the operator must be rebuilt
+     *
+     */
+    bool needsRebuild(vector_type &particles, size_t nAll, T skin, T tol) const
+    {
+        if ((size_t)particles.getMapCtr() != refMapCtr || kerPos.size() != nAll ||
+            supportSizes.size() != particles.size_local_orig())
+        {return true;}
+
+        if (opt == support_options::N_PARTICLES)
+        {
+            for (size_t i = 0 ; i < nAll ; i++)
+            {
+                if (distance2(particles.getPosOrig(i), kerPos[i]) > tol * tol)
+                {return true;}
+            }
+
+            return false;
+        }
+
+        // The candidates are built from the current positions
+        if (candSkin != skin)
+        {return false;}
+
+        T halfSkin2 = skin * skin / 4;
+        for (size_t i = 0 ; i < nAll ; i++)
+        {
+            if (distance2(particles.getPosOrig(i), refPos[i]) > halfSkin2)
+            {return true;}
+        }
+
+        return false;
+    }
+
+    /*! \brief Filter the supports from the candidates with the current positions, and recompute the kernels
+     *         of the particles whose support changed or for which the particle itself or one particle of its
+     *         support moved more than tol since the last computation
+     *
+     * The operators are a family updated together: the supports and the moved particles are computed once
+     * with the candidates of the first operator, and the moment system of every updated particle is solved
+     * once for the right hand sides of all the operators
+     *
+     * \param particles set of particles
+     * \param ops operators of the family
+     * \param nOps number of operators
+     * \param nAll number of local and ghost particles
+     * \param tol displacement under which a particle is considered at rest
+     *
+     * \return the number of particles whose kernels have been recomputed
+     *
+     */
+    static size_t updateMovedKernels(vector_type &particles, Dcpse ** ops, size_t nOps, size_t nAll, T tol)
+    {
+        Dcpse & lead = *ops[0];
+
+        T tol2 = tol * tol;
+        T rCut2 = lead.rCut * lead.rCut;
+        std::vector<unsigned char> moved(nAll);
+        for (size_t i = 0 ; i < nAll ; i++)
+        {moved[i] = distance2(particles.getPosOrig(i), lead.kerPos[i]) > tol2;}
+
+        std::vector<size_t> keysOrig;
         auto it = particles.getDomainIterator();
         while (it.isNext()) {
-            const T condVTOL = 1e2;
+            keysOrig.push_back(particles.getOriginKey(it.get()).getKey());
+            ++it;
+        }
 
-            // Get the points in the support of the DCPSE kernel and store the support for reuse
-            Support support = supportBuilder.getSupport(it, requiredSupportSize,opt);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(support.size(), monomialBasis.size());
+        // New supports, unchanged supports keep their order (and so their kernels)
+        std::vector<std::vector<size_t>> supports(keysOrig.size());
+        std::vector<unsigned char> update(keysOrig.size());
 
-            // Vandermonde matrix computation
-            Vandermonde<dim, T, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>>
-                    vandermonde(support, monomialBasis, particles);
-            vandermonde.getMatrix(V);
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(dynamic,64)
+#endif
+        for (size_t i = 0 ; i < keysOrig.size() ; i++) {
+            size_t xpK = keysOrig[i];
+            Point<dim, T> xp = particles.getPosOrig(xpK);
+
+            size_t cOff = lead.candOffsets.get(xpK);
+            size_t cEnd = (i + 1 < keysOrig.size())?lead.candOffsets.get(keysOrig[i+1]):lead.candKeys.size();
+
+            std::vector<size_t> & support = supports[i];
+            for (size_t j = cOff ; j < cEnd ; j++) {
+                size_t xqK = lead.candKeys.get(j);
+                if (distance2(xp, particles.getPosOrig(xqK)) < rCut2)
+                {support.push_back(xqK);}
+            }
+
+            size_t kerOff = lead.kerOffsets.get(xpK);
+            size_t supportSize = lead.supportSizes.get(xpK);
+
+            std::vector<size_t> oldSupport(supportSize);
+            for (size_t j = 0 ; j < supportSize ; j++)
+            {oldSupport[j] = lead.supportKeys1D.get(kerOff + j);}
+
+            std::vector<size_t> newSorted = support;
+            std::vector<size_t> oldSorted = oldSupport;
+            std::sort(newSorted.begin(), newSorted.end());
+            std::sort(oldSorted.begin(), oldSorted.end());
+
+            bool changed = newSorted != oldSorted;
+            if (changed == false)
+            {support = oldSupport;}
+
+            bool upd = changed || moved[xpK];
+            for (size_t j = 0 ; j < support.size() && upd == false ; j++)
+            {upd = moved[support[j]];}
+
+            update[i] = upd;
+        }
+
+        // New CSR layout, the same for all the operators of the family
+        openfpm::vector<size_t> newOffsets;
+        newOffsets.resize(lead.kerOffsets.size());
+        size_t nKernels = 0;
+        for (size_t i = 0 ; i < keysOrig.size() ; i++) {
+            newOffsets.get(keysOrig[i]) = nKernels;
+            nKernels += supports[i].size();
+        }
+
+        openfpm::vector<unsigned int> newKeys;
+        newKeys.resize(nKernels);
+        for (size_t i = 0 ; i < keysOrig.size() ; i++) {
+            size_t off = newOffsets.get(keysOrig[i]);
+            for (size_t j = 0 ; j < supports[i].size() ; j++)
+            {newKeys.get(off + j) = supports[i][j];}
+        }
+
+        // The kernels of the particles that are not updated are copied
+        for (size_t k = 0 ; k < nOps ; k++) {
+            Dcpse & op = *ops[k];
 
-            T condV = conditionNumber(V, condVTOL);
-            T eps = vandermonde.getEps();
-
-            if (condV > condVTOL) {
-                requiredSupportSize *= 2;
-                std::cout
-                        << "INFO: Increasing, requiredSupportSize = " << requiredSupportSize
-                        << std::endl; // debug
-                continue;
-            } else {
-                requiredSupportSize = monomialBasis.size();
+            openfpm::vector<kernel_type> newKernels;
+            newKernels.resize(nKernels);
+
+            for (size_t i = 0 ; i < keysOrig.size() ; i++) {
+                size_t xpK = keysOrig[i];
+
+                if (update[i] == false) {
+                    size_t off = newOffsets.get(xpK);
+                    size_t oldOff = op.kerOffsets.get(xpK);
+                    for (size_t j = 0 ; j < supports[i].size() ; j++)
+                    {newKernels.get(off + j) = op.calcKernels.get(oldOff + j);}
+                }
+
+                op.supportSizes.get(xpK) = supports[i].size();
             }
 
-            auto key_o = particles.getOriginKey(it.get());
-            localSupports[key_o.getKey()] = support;
-            localEps[key_o.getKey()] = eps;
-            localEpsInvPow[key_o.getKey()] = 1.0 / openfpm::math::intpowlog(eps,differentialOrder);
-            // Compute the diagonal matrix E
-            DcpseDiagonalScalingMatrix<dim> diagonalScalingMatrix(monomialBasis);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> E(support.size(), support.size());
-            diagonalScalingMatrix.buildMatrix(E, support, eps,particles);
-            // Compute intermediate matrix B
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> B = E * V;
-            // Compute matrix A
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
-            // Compute RHS vector b
-            DcpseRhs<dim> rhs(monomialBasis, differentialSignature);
-            EMatrix<T, Eigen::Dynamic, 1> b(monomialBasis.size(), 1);
-            rhs.template getVector<T>(b);
-            // Get the vector where to store the coefficients...
-            EMatrix<T, Eigen::Dynamic, 1> a(monomialBasis.size(), 1);
-            // ...solve the linear system...
-            a = A.colPivHouseholderQr().solve(b);
-            // ...and store the solution for later reuse
-            kerOffsets.get(key_o.getKey()) = calcKernels.size();
-
-            Point<dim, T> xp = particles.getPosOrig(key_o);
-
-            for (auto &xqK : support.getKeys())
-            {
-                Point<dim, T> xq = particles.getPosOrig(xqK);
-                Point<dim, T> normalizedArg = (xp - xq) / eps;
+            op.calcKernels.swap(newKernels);
+            op.kerOffsets = newOffsets;
+            op.supportKeys1D = newKeys;
+        }
+
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> b;
+        getRhs(ops, nOps, b);
+
+        DcpseDiagonalScalingMatrix<dim> diagonalScalingMatrix(lead.monomialBasis);
+        DcpseMomentSolver<T> momentSolver(lead.monomialBasis.size());
+
+        size_t nUpdated = 0;
+
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(dynamic,64) reduction(+:nUpdated)
+#endif
+        for (size_t i = 0 ; i < keysOrig.size() ; i++) {
+            if (update[i] == false)
+            {continue;}
+
+            computeParticleKernels(particles, ops, nOps, keysOrig[i], Support(keysOrig[i], supports[i]), b,
+                                   momentSolver, diagonalScalingMatrix);
+            nUpdated++;
+        }
 
-                calcKernels.add(computeKernel(normalizedArg, a));
+        for (size_t k = 0 ; k < nOps ; k++) {
+            for (size_t i = 0 ; i < nAll ; i++)
+            {
+                if (moved[i])
+                {ops[k]->kerPos[i] = particles.getPosOrig(i);}
             }
-            //
-            ++it;
         }
+
+        return nUpdated;
+    }
+
+    void initializeAdaptive(vector_type &particles,
+                            unsigned int convergenceOrder,
+                            T rCut,
+                            T supportSizeFactor) {
+#ifdef SE_CLASS1
+        this->update_ctr=particles.getMapCtr();
+#endif
+        unsigned int requiredSupportSize = monomialBasis.size();
+
+        this->rCut=rCut;
+        this->supportSizeFactor=supportSizeFactor;
+        this->convergenceOrder=convergenceOrder;
+        initializeKernels(particles, requiredSupportSize, true);
     }
 
 
@@ -596,95 +1322,386 @@ private:
         this->rCut=rCut;
         this->supportSizeFactor=supportSizeFactor;
         this->convergenceOrder=convergenceOrder;
-        SupportBuilder<vector_type>
-                supportBuilder(particles, differentialSignature, rCut);
         unsigned int requiredSupportSize = monomialBasis.size() * supportSizeFactor;
 
-        localSupports.resize(particles.size_local_orig());
-        localEps.resize(particles.size_local_orig());
-        localEpsInvPow.resize(particles.size_local_orig());
-        kerOffsets.resize(particles.size_local_orig());
+        initializeKernels(particles, requiredSupportSize, false);
+    }
+
+    /*! \brief Compute supports and kernels of all the domain particles
+     *
+     * \param particles set of particles
+     * \param requiredSupportSize minimum number of particles in the support
+     * \param adaptive if true the support is enlarged until the Vandermonde matrix is well conditioned
+     *
+     */
+    void initializeKernels(vector_type &particles,
+                           unsigned int requiredSupportSize,
+                           bool adaptive)
+    {
+        Dcpse * op = this;
+        initializeKernels(particles, &op, 1, requiredSupportSize, adaptive);
+    }
+
+    /*! \brief Compute supports and kernels of all the domain particles for a group of operators
+     *
+     * All the operators of the group must have the same monomial basis (differential signatures of the
+     * same order and same convergence order). Supports, eps and the moment matrix depend only on the
+     * basis, so they are computed once per particle and the moment system is factorized once and solved
+     * for the right hand sides of all the operators.
+     *
+     * The construction is done in two passes that are independent per particle, and run on
+     * several threads when OpenMP is available. The first pass computes the supports, an exclusive
+     * prefix sum over the support sizes (in domain iteration order) then gives kerOffsets, and the
+     * second pass solves the moment systems and writes the kernels in place. In the second pass the
+     * particles with the same support size are solved in batches (see computeBatchKernels). The layout of
+     * kerOffsets/calcKernels is the same as the one produced by a serial construction
+     *
+     * \param particles set of particles
+     * \param ops operators of the group
+     * \param nOps number of operators in the group
+     * \param requiredSupportSize minimum number of particles in the support
+     * \param adaptive if true the support is enlarged until the Vandermonde matrix is well conditioned
+     *
+     */
+    static void initializeKernels(vector_type &particles,
+                                  Dcpse ** ops,
+                                  size_t nOps,
+                                  unsigned int requiredSupportSize,
+                                  bool adaptive)
+    {
+        Dcpse & op0 = *ops[0];
+        const MonomialBasis<dim> & monomialBasis = op0.monomialBasis;
+
+        SupportBuilder<vector_type>
+                supportBuilder(particles, op0.differentialSignature, op0.rCut);
+
+        for (size_t k = 0 ; k < nOps ; k++) {
+            ops[k]->supportSizes.resize(particles.size_local_orig());
+            ops[k]->supportSizes.fill(0);
+            ops[k]->localEps.resize(particles.size_local_orig());
+            ops[k]->localEpsInvPow.resize(particles.size_local_orig());
+            ops[k]->kerOffsets.resize(particles.size_local_orig());
+            ops[k]->kerOffsets.fill(-1);
+        }
+
+        // Collect the keys of the domain particles, so that they can be distributed across threads
+        std::vector<vect_dist_key_dx> keys;
+        std::vector<vect_dist_key_dx> keysOrig;
 
         auto it = particles.getDomainIterator();
         while (it.isNext()) {
+            keys.push_back(it.get());
+            keysOrig.push_back(it.getOrig());
+            ++it;
+        }
+
+        // Supports in the domain iteration order, they are moved into the CSR storage after the first pass
+        std::vector<Support> supports(keys.size());
+
+        // Supports enlarged by the adaptive construction, reported after the parallel region
+        size_t nEnlarged = 0;
+        unsigned int maxSupportSize = 0;
+
+        // First pass: supports
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(dynamic,64) reduction(+:nEnlarged) reduction(max:maxSupportSize)
+#endif
+        for (size_t i = 0 ; i < keys.size() ; i++) {
+            const T condVTOL = 1e2;
+            unsigned int supportSize = requiredSupportSize;
+
             // Get the points in the support of the DCPSE kernel and store the support for reuse
-            Support support = supportBuilder.getSupport(it, requiredSupportSize,opt);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(support.size(), monomialBasis.size());
+            Support support = supportBuilder.getSupport(keys[i], keysOrig[i], supportSize, op0.opt);
+
+            while (adaptive) {
+                EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(support.size(), monomialBasis.size());
+
+                // Vandermonde matrix computation
+                Vandermonde<dim, T, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>>
+                        vandermonde(support, monomialBasis, particles);
+                vandermonde.getMatrix(V);
+
+                T condV = op0.conditionNumber(V, condVTOL);
+
+                if (condV <= condVTOL) {
+                    break;
+                }
+
+                supportSize *= 2;
+                support = supportBuilder.getSupport(keys[i], keysOrig[i], supportSize, op0.opt);
+            }
+
+            if (supportSize != requiredSupportSize) {
+                nEnlarged++;
+                maxSupportSize = std::max(maxSupportSize, supportSize);
+            }
+
+            supports[i] = support;
+        }
+
+        if (nEnlarged != 0) {
+            std::cout << "INFO: cond(V) greater than TOL, support increased for " << nEnlarged
+                      << " particles, requiredSupportSize up to " << maxSupportSize << std::endl;
+        }
+
+        // Offsets of the kernels, in the same order a serial construction would add them
+        size_t nKernels = 0;
+        for (size_t i = 0 ; i < keys.size() ; i++) {
+            auto key_o = particles.getOriginKey(keys[i]);
+            op0.kerOffsets.get(key_o.getKey()) = nKernels;
+            op0.supportSizes.get(key_o.getKey()) = supports[i].size();
+            nKernels += supports[i].size();
+        }
+        op0.calcKernels.resize(nKernels);
+        op0.supportKeys1D.resize(nKernels);
+
+        for (size_t k = 1 ; k < nOps ; k++) {
+            ops[k]->kerOffsets = op0.kerOffsets;
+            ops[k]->supportSizes = op0.supportSizes;
+            ops[k]->calcKernels.resize(nKernels);
+            ops[k]->supportKeys1D.resize(nKernels);
+        }
 
-            auto key_o = particles.getOriginKey(it.get());
+        // The right hand sides are the same for all the particles, one column for each operator
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> b;
+        getRhs(ops, nOps, b);
+
+        DcpseDiagonalScalingMatrix<dim> diagonalScalingMatrix(monomialBasis);
+        DcpseMomentSolver<T> momentSolver(monomialBasis.size());
+
+        // Particles with the same support size are grouped in batches, solved together by the moment solver
+        std::vector<size_t> order(keys.size());
+        for (size_t i = 0 ; i < order.size() ; i++) {order[i] = i;}
+        std::stable_sort(order.begin(), order.end(), [&](size_t i, size_t j) {return supports[i].size() < supports[j].size();});
+
+        std::vector<size_t> batchStart;
+        for (size_t i = 0 ; i < order.size() ; i++) {
+            if (batchStart.size() == 0 || i - batchStart.back() == dcpse_moment_batch_size ||
+                supports[order[i]].size() != supports[order[i-1]].size())
+            {batchStart.push_back(i);}
+        }
+        batchStart.push_back(order.size());
+
+        // Second pass: moment systems and kernels
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(dynamic,4)
+#endif
+        for (size_t k = 0 ; k < batchStart.size() - 1 ; k++) {
+            computeBatchKernels(particles, ops, nOps, keys, supports, &order[batchStart[k]],
+                                batchStart[k+1] - batchStart[k], b, momentSolver, diagonalScalingMatrix);
+        }
+    }
+
+    /*! \brief Solve the moment systems of a batch of particles with the same support size and write
+     *         their kernels in place
+     *
+     * kerOffsets of the operators must be already set
+     *
+     * \param particles set of particles
+     * \param ops operators of the group
+     * \param nOps number of operators
+     * \param keys domain keys of the particles
+     * \param supports supports of the particles (same order as keys)
+     * \param batch indexes in keys of the particles of the batch
+     * \param nb number of particles in the batch
+     * \param b right hand sides (see getRhs)
+     * \param momentSolver solver for the moment systems
+     * \param diagonalScalingMatrix scaling matrix
+     *
+     */
+    static void computeBatchKernels(vector_type &particles,
+                                    Dcpse ** ops,
+                                    size_t nOps,
+                                    const std::vector<vect_dist_key_dx> & keys,
+                                    const std::vector<Support> & supports,
+                                    const size_t * batch,
+                                    size_t nb,
+                                    const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                                    const DcpseMomentSolver<T> & momentSolver,
+                                    DcpseDiagonalScalingMatrix<dim> & diagonalScalingMatrix)
+    {
+        Dcpse & op0 = *ops[0];
+        const MonomialBasis<dim> & monomialBasis = op0.monomialBasis;
+        const size_t n = monomialBasis.size();
+        const size_t m = supports[batch[0]].size();
+
+        // Scaled Vandermonde matrices of the batch, interleaved (see DcpseMomentSolver::solveBatch)
+        std::vector<T> B(m * n * nb);
+        std::vector<T> a(n * nOps * nb);
+        std::vector<T> eps(nb);
+
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(m, n);
+        EMatrix<T, Eigen::Dynamic, 1> E(m, 1);
+
+        for (size_t p = 0 ; p < nb ; p++) {
+            const Support & support = supports[batch[p]];
+            size_t xpK = particles.getOriginKey(keys[batch[p]]).getKey();
 
-            // Vandermonde matrix computation
             Vandermonde<dim, T, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>>
                     vandermonde(support, monomialBasis,particles);
             vandermonde.getMatrix(V);
 
-            T eps = vandermonde.getEps();
-
-            localSupports[key_o.getKey()] = support;
-            localEps[key_o.getKey()] = eps;
-            localEpsInvPow[key_o.getKey()] = 1.0 / openfpm::math::intpowlog(eps,differentialOrder);
-            // Compute the diagonal matrix E
-            DcpseDiagonalScalingMatrix<dim> diagonalScalingMatrix(monomialBasis);
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> E(support.size(), support.size());
-            diagonalScalingMatrix.buildMatrix(E, support, eps, particles);
-            // Compute intermediate matrix B
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> B = E * V;
-            // Compute matrix A
-            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
-
-            // Compute RHS vector b
-            DcpseRhs<dim> rhs(monomialBasis, differentialSignature);
-            EMatrix<T, Eigen::Dynamic, 1> b(monomialBasis.size(), 1);
-            rhs.template getVector<T>(b);
-            // Get the vector where to store the coefficients...
-            EMatrix<T, Eigen::Dynamic, 1> a(monomialBasis.size(), 1);
-            // ...solve the linear system...
-            a = A.colPivHouseholderQr().solve(b);
-            // ...and store the solution for later reuse
-            kerOffsets.get(key_o.getKey()) = calcKernels.size();
-
-            Point<dim, T> xp = particles.getPosOrig(key_o);
-
-            for (auto &xqK : support.getKeys())
+            eps[p] = vandermonde.getEps();
+            for (size_t k = 0 ; k < nOps ; k++) {
+                ops[k]->localEps[xpK] = eps[p];
+                ops[k]->localEpsInvPow[xpK] = 1.0 / openfpm::math::intpowlog(eps[p],ops[k]->differentialOrder);
+            }
+
+            diagonalScalingMatrix.buildDiagonal(E, support, eps[p], particles);
+
+            for (size_t r = 0 ; r < m ; r++) {
+                for (size_t i = 0 ; i < n ; i++)
+                {B[(r*n + i)*nb + p] = E(r) * V(r,i);}
+            }
+        }
+
+        momentSolver.solveBatch(B.data(), m, nb, b, a.data());
+
+        std::vector<T> mbValues(n);
+        std::vector<T> ap(n);
+
+        for (size_t p = 0 ; p < nb ; p++) {
+            const Support & support = supports[batch[p]];
+            size_t xpK = particles.getOriginKey(keys[batch[p]]).getKey();
+            size_t kerOff = op0.kerOffsets.get(xpK);
+
+            Point<dim, T> xp = particles.getPosOrig(xpK);
+
+            auto & supportKeys = support.getKeys();
+            for (size_t j = 0 ; j < supportKeys.size() ; j++)
             {
-                Point<dim, T> xq = particles.getPosOrig(xqK);
-                Point<dim, T> normalizedArg = (xp - xq) / eps;
+                Point<dim, T> xq = particles.getPosOrig(supportKeys[j]);
+                Point<dim, T> normalizedArg = (xp - xq) / eps[p];
+                T expFactor = exp(-norm2(normalizedArg));
+                monomialBasis.evaluate(normalizedArg, mbValues.data());
+
+                for (size_t k = 0 ; k < nOps ; k++) {
+                    for (size_t i = 0 ; i < n ; i++)
+                    {ap[i] = a[(i*nOps + k)*nb + p];}
 
-                calcKernels.add(computeKernel(normalizedArg, a));
+                    ops[k]->supportKeys1D.get(kerOff + j) = supportKeys[j];
+                    ops[k]->calcKernels.get(kerOff + j) = op0.computeKernel(ap.data(), mbValues.data(), expFactor);
+                }
             }
-            //
-            ++it;
         }
     }
 
+    /*! \brief Right hand sides of the moment systems of a group of operators (one column for each operator)
+     *
+     * \param ops operators of the group
+     * \param nOps number of operators
+     * \param b right hand sides
+     *
+     */
+    static void getRhs(Dcpse ** ops, size_t nOps, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b)
+    {
+        const MonomialBasis<dim> & monomialBasis = ops[0]->monomialBasis;
+
+        b.resize(monomialBasis.size(), nOps);
+        for (size_t k = 0 ; k < nOps ; k++) {
+            DcpseRhs<dim> rhs(monomialBasis, ops[k]->differentialSignature);
+            EMatrix<T, Eigen::Dynamic, 1> bk(monomialBasis.size(), 1);
+            rhs.template getVector<T>(bk);
+            b.col(k) = bk;
+        }
+    }
+
+    /*! \brief Solve the moment systems of one particle and write its kernels in place
+     *
+     * kerOffsets of the operators must be already set
+     *
+     * \param particles set of particles
+     * \param ops operators of the group
+     * \param nOps number of operators
+     * \param xpK particle (original key)
+     * \param support support of the particle
+     * \param b right hand sides (see getRhs)
+     * \param momentSolver solver for the moment systems
+     * \param diagonalScalingMatrix scaling matrix
+     *
+     */
+    static void computeParticleKernels(vector_type &particles,
+                                       Dcpse ** ops,
+                                       size_t nOps,
+                                       size_t xpK,
+                                       const Support & support,
+                                       const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                                       const DcpseMomentSolver<T> & momentSolver,
+                                       DcpseDiagonalScalingMatrix<dim> & diagonalScalingMatrix)
+    {
+        Dcpse & op0 = *ops[0];
+        const MonomialBasis<dim> & monomialBasis = op0.monomialBasis;
 
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> V(support.getKeys().size(), monomialBasis.size());
 
+        // Vandermonde matrix computation
+        Vandermonde<dim, T, EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>>
+                vandermonde(support, monomialBasis,particles);
+        vandermonde.getMatrix(V);
 
-    T computeKernel(Point<dim, T> x, EMatrix<T, Eigen::Dynamic, 1> & a) const {
+        T eps = vandermonde.getEps();
+
+        for (size_t k = 0 ; k < nOps ; k++) {
+            ops[k]->localEps[xpK] = eps;
+            ops[k]->localEpsInvPow[xpK] = 1.0 / openfpm::math::intpowlog(eps,ops[k]->differentialOrder);
+        }
+        // Compute the diagonal of the scaling matrix E
+        EMatrix<T, Eigen::Dynamic, 1> E(support.getKeys().size(), 1);
+        diagonalScalingMatrix.buildDiagonal(E, support, eps, particles);
+        // Compute intermediate matrix B
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> B = E.asDiagonal() * V;
+
+        // Get the matrix where to store the coefficients (one column for each operator)...
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> a(monomialBasis.size(), nOps);
+        // ...solve the linear systems B^T B a = b with one factorization...
+        momentSolver.solve(B, b, a);
+        // ...and store the solution for later reuse
+        size_t kerOff = op0.kerOffsets.get(xpK);
+
+        Point<dim, T> xp = particles.getPosOrig(xpK);
+        std::vector<T> mbValues(monomialBasis.size());
+
+        auto & supportKeys = support.getKeys();
+        for (size_t j = 0 ; j < supportKeys.size() ; j++)
+        {
+            Point<dim, T> xq = particles.getPosOrig(supportKeys[j]);
+            Point<dim, T> normalizedArg = (xp - xq) / eps;
+            T expFactor = exp(-norm2(normalizedArg));
+            monomialBasis.evaluate(normalizedArg, mbValues.data());
+
+            for (size_t k = 0 ; k < nOps ; k++) {
+                ops[k]->supportKeys1D.get(kerOff + j) = supportKeys[j];
+                ops[k]->calcKernels.get(kerOff + j) = op0.computeKernel(&a(0, k), mbValues.data(), expFactor);
+            }
+        }
+    }
+
+    /*! \brief Compute the kernel from the monomial basis evaluated in the normalized argument x
+     *
+     * \param a coefficients
+     * \param mbValues monomial basis evaluated in x
+     * \param expFactor exp(-|x|^2)
+     *
+     */
+    T computeKernel(const T * a, const T * mbValues, T expFactor) const {
         T res = 0;
-        unsigned int counter = 0;
-        T expFactor = exp(-norm2(x));
-        for (const Monomial<dim> &m : monomialBasis.getElements()) {
-            T coeff = a(counter);
-            T mbValue = m.evaluate(x);
-            res += coeff * mbValue * expFactor;
-            ++counter;
+        for (unsigned int counter = 0; counter < monomialBasis.size(); ++counter) {
+            res += a[counter] * mbValues[counter];
         }
-        return res;
+        return res * expFactor;
     }
 
 
+    /*! \brief Condition number of V
+     *
+     * It is called from the threads of the construction, so it does not print: the supports
+     * enlarged because of an ill-conditioned V are reported once by initializeKernels
+     *
+     */
     T conditionNumber(const EMatrix<T, -1, -1> &V, T condTOL) const {
         Eigen::JacobiSVD<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> svd(V);
         T cond = svd.singularValues()(0)
                  / svd.singularValues()(svd.singularValues().size() - 1);
-        if (cond > condTOL) {
-            std::cout
-                    << "WARNING: cond(V) = " << cond
-                    << " is greater than TOL = " << condTOL
-                    << ",  numPoints(V) = " << V.rows()
-                    << std::endl; // debug
-        }
         return cond;
     }
 
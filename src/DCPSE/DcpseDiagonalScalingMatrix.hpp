@@ -19,7 +19,7 @@ public:
     DcpseDiagonalScalingMatrix(const MonomialBasis<dim> &monomialBasis) : monomialBasis(monomialBasis) {}
 
     template <typename T, typename MatrixType, typename vector_type>
-    void buildMatrix(MatrixType &M, Support support, T eps, vector_type & particles)
+    void buildMatrix(MatrixType &M, const Support & support, T eps, vector_type & particles)
     {
         // Check that all the dimension constraints are met
         assert(support.size() >= monomialBasis.size());
@@ -41,6 +41,32 @@ public:
         }
     }
 
+    /*! \brief Build only the diagonal of the scaling matrix
+     *
+     * \param d vector where to store the diagonal (support size x 1)
+     * \param support support of the particle
+     * \param eps scaling factor
+     * \param particles set of particles
+     *
+     */
+    template <typename T, typename VectorType, typename vector_type>
+    void buildDiagonal(VectorType &d, const Support & support, T eps, vector_type & particles)
+    {
+        assert(d.rows() == support.getKeys().size());
+
+        Point<dim,typename vector_type::stype> ref_p = particles.getPosOrig(support.getReferencePointKey());
+
+        int i = 0;
+        for (const auto& pt : support.getKeys())
+        {
+        	Point<dim,typename vector_type::stype> p = ref_p;
+        	p -= particles.getPosOrig(pt);
+
+            d(i) = exp(- norm2(p) / (2.0 * eps * eps));
+            ++i;
+        }
+    }
+
 };
 
 #endif //OPENFPM_PDATA_DCPSEDIAGONALSCALINGMATRIX_HPP
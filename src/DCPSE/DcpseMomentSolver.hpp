@@ -0,0 +1,416 @@
+//
+// DcpseMomentSolver.hpp
+//
+// Created on: Oct 18, 2026
+//
+
+#ifndef OPENFPM_PDATA_DCPSEMOMENTSOLVER_HPP
+#define OPENFPM_PDATA_DCPSEMOMENTSOLVER_HPP
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include "DMatrix/EMatrix.hpp"
+
+/*! \brief Solve the DCPSE moment system A a = b with A = B^T B when the factorization with fixed size fail
+ *
+ * It use dynamic matrices and column pivoting QR. b and a can have several columns (one for each right hand side)
+ *
+ * \return false if the system is rank deficient (the solution is the one computed by QR for a singular system)
+ *
+ */
+template<typename T>
+bool dcpse_moment_solver_qr(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & B,
+                            const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & a)
+{
+    EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
+    Eigen::ColPivHouseholderQR<EMatrix<T, Eigen::Dynamic, Eigen::Dynamic>> qr(A);
+    a = qr.solve(b);
+    return qr.rank() == A.cols();
+}
+
+/*! \brief Criterion to accept the factorization without pivoting of a moment system
+ *
+ * The ratio between the smallest and the biggest pivot (the diagonal D of A = L D L^T) is the estimate of
+ * the reciprocal condition number. The single and the batch solvers use the same criterion, so a particle
+ * is solved in the same way by both
+ *
+ * \param dMin smallest pivot
+ * \param dMax biggest pivot
+ * \param rcondTol tolerance
+ *
+ * \return true if the factorization can be used
+ *
+ */
+template<typename T>
+inline bool dcpse_moment_pivots_ok(T dMin, T dMax, T rcondTol)
+{
+    return dMin > 0 && dMin > rcondTol * dMax;
+}
+
+/*! \brief Apply dcpse_moment_pivots_ok to a Cholesky factorization A = L L^T (the pivots are the squares of diag(L))
+ *
+ */
+template<typename llt_type, typename T>
+inline bool dcpse_moment_llt_ok(const llt_type & llt, T rcondTol)
+{
+    if (llt.info() != Eigen::Success)
+    {return false;}
+
+    auto d = llt.matrixLLT().diagonal().cwiseAbs2();
+    return dcpse_moment_pivots_ok<T>(d.minCoeff(), d.maxCoeff(), rcondTol);
+}
+
+/*! \brief Solve the DCPSE moment system A a = b with A = B^T B for a fixed size N
+ *
+ * A is assembled and factorized with stack allocated matrices using Cholesky (the LDLT without pivoting).
+ * If the factorization fails or the system is ill-conditioned, it fall back to column pivoting QR
+ *
+ * \tparam T type of the coefficients
+ * \tparam N size of the moment system
+ *
+ */
+template<typename T, int N>
+struct dcpse_moment_solver_fixed
+{
+    static bool solve(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & B,
+                      const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                      EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & a,
+                      T rcondTol)
+    {
+        Eigen::Matrix<T, N, N> A;
+        A.noalias() = B.transpose() * B;
+
+        Eigen::LLT<Eigen::Matrix<T, N, N>> llt(A);
+
+        if (dcpse_moment_llt_ok(llt, rcondTol))
+        {
+            Eigen::Matrix<T, N, Eigen::Dynamic> bf = b;
+            a = llt.solve(bf);
+            return true;
+        }
+
+        dcpse_moment_solver_qr(B, b, a);
+        return false;
+    }
+};
+
+/*! \brief Same as dcpse_moment_solver_fixed for systems whose size is known only at runtime
+ *
+ */
+template<typename T>
+struct dcpse_moment_solver_fixed<T, Eigen::Dynamic>
+{
+    static bool solve(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & B,
+                      const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                      EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & a,
+                      T rcondTol)
+    {
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
+        Eigen::LLT<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> llt(A);
+
+        if (dcpse_moment_llt_ok(llt, rcondTol))
+        {
+            a = llt.solve(b);
+            return true;
+        }
+
+        dcpse_moment_solver_qr(B, b, a);
+        return false;
+    }
+};
+
+/*! \brief Select at runtime the fixed size implementation for a moment system of size n
+ *
+ * \tparam T type of the coefficients
+ * \tparam N list of the sizes that have a fixed size implementation
+ *
+ */
+template<typename T, int ... N>
+struct dcpse_moment_solver_select
+{
+    typedef bool (* solve_type)(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> &,
+                                const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> &,
+                                EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> &,
+                                T);
+
+    static solve_type select(unsigned int n)
+    {
+        return &dcpse_moment_solver_fixed<T, Eigen::Dynamic>::solve;
+    }
+};
+
+template<typename T, int N, int ... Nr>
+struct dcpse_moment_solver_select<T, N, Nr ...>
+{
+    typedef typename dcpse_moment_solver_select<T>::solve_type solve_type;
+
+    static solve_type select(unsigned int n)
+    {
+        if (n == N)
+        {return &dcpse_moment_solver_fixed<T, N>::solve;}
+
+        return dcpse_moment_solver_select<T, Nr ...>::select(n);
+    }
+};
+
+/*! \brief Sizes of the monomial basis with a fixed size solver
+ *
+ * They are the sizes of the basis of first and second derivatives in 2D and 3D
+ * for convergence orders from 1 to 4
+ *
+ */
+template<typename T>
+struct dcpse_moment_solver_sizes
+{
+    typedef dcpse_moment_solver_select<T, 3, 4, 5, 6, 9, 10, 14, 15, 19, 20> type;
+};
+
+//! Maximum number of moment systems solved together by DcpseMomentSolver::solveBatch
+constexpr unsigned int dcpse_moment_batch_size = 16;
+
+/*! \brief Solver engine for the DCPSE moment systems
+ *
+ * All the particles of a DCPSE operator solve a system of the same size (the size of the
+ * monomial basis). The engine select once the implementation for that size, so that every
+ * particle of the operator is solved with fixed-size, stack allocated and vectorized Cholesky (LDLT without pivoting),
+ * with a fall-back to column pivoting QR for ill-conditioned systems. Particles with the same
+ * support size can also be solved together in batches (see solveBatch)
+ *
+ * \tparam T type of the coefficients
+ *
+ */
+template<typename T>
+class DcpseMomentSolver
+{
+    typedef typename dcpse_moment_solver_sizes<T>::type::solve_type solve_type;
+
+    //! size of the moment system
+    unsigned int n;
+
+    //! ratio between the smallest and the biggest pivot under which we fall back to QR (see dcpse_moment_pivots_ok)
+    T rcondTol;
+
+    //! implementation selected for the size n
+    solve_type solveImpl;
+
+public:
+
+    /*! \brief Constructor
+     *
+     * \param n size of the moment system (size of the monomial basis)
+     * \param rcondTol pivot ratio (estimate of the reciprocal condition number) under which the system is solved with QR
+     *
+     */
+    DcpseMomentSolver(unsigned int n, T rcondTol = 1e4 * std::numeric_limits<T>::epsilon())
+    :n(n),rcondTol(rcondTol)
+    {
+        solveImpl = dcpse_moment_solver_sizes<T>::type::select(n);
+    }
+
+    /*! \brief Solve the moment system B^T B a = b
+     *
+     * \param B scaled Vandermonde matrix (support size x n)
+     * \param b right hand side
+     * \param a solution
+     *
+     * \return true if the system has been solved without pivoting, false if it fall back to QR
+     *
+     */
+    bool solve(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & B,
+               const EMatrix<T, Eigen::Dynamic, 1> & b,
+               EMatrix<T, Eigen::Dynamic, 1> & a) const
+    {
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> bm = b;
+        EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> am(n, 1);
+
+        bool ret = solveImpl(B, bm, am, rcondTol);
+        a = am;
+        return ret;
+    }
+
+    /*! \brief Solve the moment system B^T B a = b for several right hand sides with one factorization
+     *
+     * \param B scaled Vandermonde matrix (support size x n)
+     * \param b right hand sides (n x number of right hand sides)
+     * \param a solutions (n x number of right hand sides)
+     *
+     * \return true if the system has been solved without pivoting, false if it fall back to QR
+     *
+     */
+    bool solve(const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & B,
+               const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+               EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & a) const
+    {
+        return solveImpl(B, b, a, rcondTol);
+    }
+
+    /*! \brief Solve together the moment systems B_p^T B_p a_p = b of a batch of particles with the same support size
+     *
+     * The matrices are stored interleaved, the entry (r,i) of the particle p is B[(r*n + i)*nb + p], so that
+     * the assembly of B_p^T B_p and the LDLT factorization run over the particles of the batch in the inner
+     * loop (the compiler vectorize it). The systems rejected by dcpse_moment_pivots_ok are solved again with
+     * column pivoting QR
+     *
+     * \param B scaled Vandermonde matrices (m x n for each particle, interleaved)
+     * \param m support size
+     * \param nb number of particles in the batch (at most dcpse_moment_batch_size)
+     * \param b right hand sides (n x number of right hand sides), the same for all the particles
+     * \param a solutions, the entry i of the right hand side k of the particle p is a[(i*b.cols() + k)*nb + p]
+     *
+     * \return the number of systems solved without pivoting
+     *
+     */
+    unsigned int solveBatch(const T * B,
+                            unsigned int m,
+                            unsigned int nb,
+                            const EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> & b,
+                            T * a) const
+    {
+        const unsigned int W = dcpse_moment_batch_size;
+        const unsigned int nRhs = b.cols();
+
+        // A = B^T B (only the lower triangle) overwritten by L and D
+        std::vector<T> A(n * n * W, 0);
+        for (unsigned int r = 0 ; r < m ; r++)
+        {
+            for (unsigned int i = 0 ; i < n ; i++)
+            {
+                const T * Bri = &B[(r*n + i)*nb];
+                for (unsigned int j = 0 ; j <= i ; j++)
+                {
+                    const T * Brj = &B[(r*n + j)*nb];
+                    T * Aij = &A[(i*n + j)*W];
+                    for (unsigned int p = 0 ; p < nb ; p++)
+                    {Aij[p] += Bri[p] * Brj[p];}
+                }
+            }
+        }
+
+        T dMin[W];
+        T dMax[W];
+        for (unsigned int p = 0 ; p < nb ; p++)
+        {
+            dMin[p] = std::numeric_limits<T>::max();
+            dMax[p] = 0;
+        }
+
+        // LDLT without pivoting, L has unit diagonal and D is stored on the diagonal
+        T tmp[W];
+        for (unsigned int j = 0 ; j < n ; j++)
+        {
+            T * Ajj = &A[(j*n + j)*W];
+            for (unsigned int k = 0 ; k < j ; k++)
+            {
+                const T * Ajk = &A[(j*n + k)*W];
+                const T * Akk = &A[(k*n + k)*W];
+                for (unsigned int p = 0 ; p < nb ; p++)
+                {Ajj[p] -= Ajk[p] * Ajk[p] * Akk[p];}
+            }
+
+            for (unsigned int p = 0 ; p < nb ; p++)
+            {
+                dMin[p] = std::min(dMin[p], Ajj[p]);
+                dMax[p] = std::max(dMax[p], Ajj[p]);
+                tmp[p] = (Ajj[p] > 0)?(T)1.0 / Ajj[p]:(T)0.0;
+            }
+
+            for (unsigned int i = j + 1 ; i < n ; i++)
+            {
+                T * Aij = &A[(i*n + j)*W];
+                for (unsigned int k = 0 ; k < j ; k++)
+                {
+                    const T * Aik = &A[(i*n + k)*W];
+                    const T * Ajk = &A[(j*n + k)*W];
+                    const T * Akk = &A[(k*n + k)*W];
+                    for (unsigned int p = 0 ; p < nb ; p++)
+                    {Aij[p] -= Aik[p] * Ajk[p] * Akk[p];}
+                }
+
+                for (unsigned int p = 0 ; p < nb ; p++)
+                {Aij[p] *= tmp[p];}
+            }
+        }
+
+        // Forward substitution, scaling with D and backward substitution for every right hand side
+        for (unsigned int k = 0 ; k < nRhs ; k++)
+        {
+            for (unsigned int i = 0 ; i < n ; i++)
+            {
+                T * ai = &a[(i*nRhs + k)*nb];
+                for (unsigned int p = 0 ; p < nb ; p++)
+                {ai[p] = b(i,k);}
+
+                for (unsigned int j = 0 ; j < i ; j++)
+                {
+                    const T * Aij = &A[(i*n + j)*W];
+                    const T * aj = &a[(j*nRhs + k)*nb];
+                    for (unsigned int p = 0 ; p < nb ; p++)
+                    {ai[p] -= Aij[p] * aj[p];}
+                }
+            }
+
+            for (unsigned int i = 0 ; i < n ; i++)
+            {
+                T * ai = &a[(i*nRhs + k)*nb];
+                const T * Aii = &A[(i*n + i)*W];
+                for (unsigned int p = 0 ; p < nb ; p++)
+                {ai[p] = (Aii[p] > 0)?ai[p] / Aii[p]:(T)0.0;}
+            }
+
+            for (int i = n - 1 ; i >= 0 ; i--)
+            {
+                T * ai = &a[(i*nRhs + k)*nb];
+                for (unsigned int j = i + 1 ; j < n ; j++)
+                {
+                    const T * Aji = &A[(j*n + i)*W];
+                    const T * aj = &a[(j*nRhs + k)*nb];
+                    for (unsigned int p = 0 ; p < nb ; p++)
+                    {ai[p] -= Aji[p] * aj[p];}
+                }
+            }
+        }
+
+        // Fall back to QR for the systems that are not well conditioned
+        unsigned int nLdlt = 0;
+        for (unsigned int p = 0 ; p < nb ; p++)
+        {
+            if (dcpse_moment_pivots_ok(dMin[p], dMax[p], rcondTol))
+            {
+                nLdlt++;
+                continue;
+            }
+
+            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> Bp(m, n);
+            for (unsigned int r = 0 ; r < m ; r++)
+            {
+                for (unsigned int i = 0 ; i < n ; i++)
+                {Bp(r,i) = B[(r*n + i)*nb + p];}
+            }
+
+            EMatrix<T, Eigen::Dynamic, Eigen::Dynamic> ap(n, nRhs);
+            dcpse_moment_solver_qr(Bp, b, ap);
+
+            for (unsigned int i = 0 ; i < n ; i++)
+            {
+                for (unsigned int k = 0 ; k < nRhs ; k++)
+                {a[(i*nRhs + k)*nb + p] = ap(i,k);}
+            }
+        }
+
+        return nLdlt;
+    }
+
+    /*! \brief Get the size of the moment system
+     *
+     * \return the size of the system
+     *
+     */
+    unsigned int size() const
+    {
+        return n;
+    }
+};
+
+#endif //OPENFPM_PDATA_DCPSEMOMENTSOLVER_HPP
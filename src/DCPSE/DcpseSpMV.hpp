@@ -0,0 +1,377 @@
+//
+// DcpseSpMV.hpp
+//
+// Created on: Oct 18, 2026
+//
+
+#ifndef OPENFPM_PDATA_DCPSESPMV_HPP
+#define OPENFPM_PDATA_DCPSESPMV_HPP
+
+#include <vector>
+#include <algorithm>
+#include "Vector/vector_dist.hpp"
+
+/*! \brief Store the results of a row of the SpMV into the properties prp ...
+ *
+ * \tparam prp properties where to store the operators (one for each operator)
+ *
+ */
+template<unsigned int ... prp>
+struct dcpse_spmv_store
+{
+    template<typename vector_type, typename T>
+    static inline void store(vector_type & particles, size_t p, const T * acc)
+    {}
+};
+
+template<unsigned int prp, unsigned int ... prpr>
+struct dcpse_spmv_store<prp, prpr ...>
+{
+    template<typename vector_type, typename T>
+    static inline void store(vector_type & particles, size_t p, const T * acc)
+    {
+        particles.template getProp<prp>(p) = acc[0];
+        dcpse_spmv_store<prpr ...>::store(particles, p, acc + 1);
+    }
+};
+
+/*! \brief DCPSE operators exported as a local sparse matrix
+ *
+ * Once the kernels of a DCPSE operator are computed, its application is a linear map from the values
+ * on local+ghost particles to the values on local particles. This class export one or more
+ * operators in CSR form, rows are the local particles and columns are local+ghost particle indexes.
+ *
+ * Operators added to the same object share one sparsity pattern (the union of their supports), the
+ * coefficients are interleaved, so that applying all of them is a single pass over the stencil
+ *
+ * \verbatim
+   Derivative_x Dx(particles, 2, rCut);
+   Derivative_y Dy(particles, 2, rCut);
+   Laplacian Lap(particles, 2, rCut);
+
+   DcpseSpMV<double> mat;
+   mat.addOperator(particles, Dx.getDcpse<decltype(particles)>());
+   mat.addOperator(particles, Dy.getDcpse<decltype(particles)>());
+   mat.addOperator(particles, Lap.getDcpse<decltype(particles)>(), decltype(particles)::dims);
+
+   particles.ghost_get<0>();
+   mat.apply<0, 1, 2, 3>(particles);
+ * \endverbatim
+ *
+ * The matrix must be rebuilt (clear and addOperator) every time the operators are updated
+ *
+ * \tparam T type of the coefficients
+ *
+ */
+template<typename T>
+class DcpseSpMV
+{
+    //! row offsets (number of local particles + 1)
+    openfpm::vector<size_t> rowOffsets;
+
+    //! column (local+ghost particle) of each non-zero
+    openfpm::vector<unsigned int> cols;
+
+    //! coefficients, nOps for each non-zero
+    openfpm::vector<T> vals;
+
+    //! number of operators
+    size_t nOps = 0;
+
+    //! number of columns (local + ghost particles)
+    size_t nCols = 0;
+
+    /*! \brief Add to a row the coefficients of a DCPSE operator
+     *
+     * \param p particle (row)
+     * \param dcpse operator
+     * \param row (column, coefficient) pairs of the row
+     *
+     */
+    template<typename Dcpse_type>
+    void getOperatorRow(size_t p,
+                        Dcpse_type & dcpse,
+                        std::vector<std::pair<unsigned int, T>> & row)
+    {
+        vect_dist_key_dx key(p);
+
+        T epsInvPow = dcpse.getEpsilonInvPrefactor(key);
+        T sign = dcpse.getSign();
+        T diag = 0;
+
+        int nn = dcpse.getNumNN(key);
+        for (int j = 0 ; j < nn ; j++)
+        {
+            T coeff = dcpse.getCoeffNN(key, j) * epsInvPow;
+            row.push_back(std::make_pair((unsigned int)dcpse.getIndexNN(key, j), coeff));
+            diag += coeff;
+        }
+
+        row.push_back(std::make_pair((unsigned int)p, sign * diag));
+    }
+
+    /*! \brief Sort a row by column and merge the duplicated columns
+     *
+     */
+    static void compressRow(std::vector<std::pair<unsigned int, T>> & row)
+    {
+        std::sort(row.begin(), row.end(),
+                  [](const std::pair<unsigned int, T> & a, const std::pair<unsigned int, T> & b)
+                  {return a.first < b.first;});
+
+        size_t last = 0;
+        for (size_t i = 1 ; i < row.size() ; i++)
+        {
+            if (row[i].first == row[last].first)
+            {row[last].second += row[i].second;}
+            else
+            {row[++last] = row[i];}
+        }
+
+        if (row.size() != 0)
+        {row.resize(last + 1);}
+    }
+
+public:
+
+    /*! \brief Remove all the operators
+     *
+     */
+    void clear()
+    {
+        rowOffsets.clear();
+        cols.clear();
+        vals.clear();
+        nOps = 0;
+        nCols = 0;
+    }
+
+    /*! \brief Add an operator to the matrix
+     *
+     * The operator is the sum of n DCPSE operators (n = 1 for a single derivative, n = dims for the
+     * Laplacian, ...). The sparsity pattern is extended to the union with the support of the operator
+     *
+     * \param particles particle set on which the operators have been computed
+     * \param dcpse pointer to the DCPSE operators to sum
+     * \param n number of DCPSE operators to sum
+     *
+     * \return the index of the operator in the matrix
+     *
+     */
+    template<typename vector_type, typename Dcpse_type>
+    size_t addOperator(vector_type & particles, Dcpse_type * dcpse, size_t n = 1)
+    {
+        size_t nRows = particles.size_local();
+        size_t nColsNew = particles.size_local_with_ghost();
+
+        if (nOps != 0 && rowOffsets.size() != nRows + 1)
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error: the operators have been computed on a different number of particles" << std::endl;
+            return nOps;
+        }
+
+        openfpm::vector<size_t> newRowOffsets;
+        openfpm::vector<unsigned int> newCols;
+        openfpm::vector<T> newVals;
+
+        newRowOffsets.resize(nRows + 1);
+        newRowOffsets.get(0) = 0;
+
+        size_t nOpsNew = nOps + 1;
+        std::vector<std::pair<unsigned int, T>> row;
+
+        for (size_t p = 0 ; p < nRows ; p++)
+        {
+            row.clear();
+            for (size_t k = 0 ; k < n ; k++)
+            {getOperatorRow(p, dcpse[k], row);}
+            compressRow(row);
+
+            // merge the row of the new operator with the current pattern, both sorted by column
+            size_t i = (nOps == 0)?0:rowOffsets.get(p);
+            size_t iEnd = (nOps == 0)?0:rowOffsets.get(p + 1);
+            size_t j = 0;
+
+            while (i < iEnd || j < row.size())
+            {
+                if (j == row.size() || (i < iEnd && cols.get(i) < row[j].first))
+                {
+                    newCols.add(cols.get(i));
+                    for (size_t o = 0 ; o < nOps ; o++)
+                    {newVals.add(vals.get(i * nOps + o));}
+                    newVals.add(0);
+                    i++;
+                }
+                else if (i == iEnd || row[j].first < cols.get(i))
+                {
+                    newCols.add(row[j].first);
+                    for (size_t o = 0 ; o < nOps ; o++)
+                    {newVals.add(0);}
+                    newVals.add(row[j].second);
+                    j++;
+                }
+                else
+                {
+                    newCols.add(cols.get(i));
+                    for (size_t o = 0 ; o < nOps ; o++)
+                    {newVals.add(vals.get(i * nOps + o));}
+                    newVals.add(row[j].second);
+                    i++;
+                    j++;
+                }
+            }
+
+            newRowOffsets.get(p + 1) = newCols.size();
+        }
+
+        rowOffsets.swap(newRowOffsets);
+        cols.swap(newCols);
+        vals.swap(newVals);
+        nCols = nColsNew;
+        nOps = nOpsNew;
+
+        return nOps - 1;
+    }
+
+    /*! \brief Apply all the operators to the property prpIn and store the results in prpOut ...
+     *
+     * The ghost of prpIn must be up to date. One output property must be given for each operator
+     * in the order they have been added
+     *
+     * \tparam prpIn input property
+     * \tparam prpOut output properties
+     *
+     * \param particles particle set
+     *
+     */
+    template<unsigned int prpIn, unsigned int ... prpOut, typename vector_type>
+    void apply(vector_type & particles) const
+    {
+        if (sizeof...(prpOut) != nOps)
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error: " << nOps << " output properties are required" << std::endl;
+            return;
+        }
+
+        size_t nRows = (rowOffsets.size() == 0)?0:rowOffsets.size() - 1;
+        constexpr size_t nOut = sizeof...(prpOut);
+
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (size_t p = 0 ; p < nRows ; p++)
+        {
+            T acc[nOut];
+            for (size_t o = 0 ; o < nOut ; o++)
+            {acc[o] = 0;}
+
+            size_t start = rowOffsets.get(p);
+            size_t stop = rowOffsets.get(p + 1);
+            for (size_t i = start ; i < stop ; i++)
+            {
+                T f = particles.template getProp<prpIn>(cols.get(i));
+                const T * v = &vals.get(i * nOut);
+
+#ifdef HAVE_OPENMP
+                #pragma omp simd
+#endif
+                for (size_t o = 0 ; o < nOut ; o++)
+                {acc[o] += v[o] * f;}
+            }
+
+            dcpse_spmv_store<prpOut ...>::store(particles, p, acc);
+        }
+    }
+
+    /*! \brief Apply all the operators to a plain array
+     *
+     * \param x input values, one for each local+ghost particle
+     * \param y output values, nOps for each local particle (y[p*nOps + o] is the operator o on the particle p)
+     *
+     */
+    void apply(const T * x, T * y) const
+    {
+        size_t nRows = (rowOffsets.size() == 0)?0:rowOffsets.size() - 1;
+
+#ifdef HAVE_OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (size_t p = 0 ; p < nRows ; p++)
+        {
+            T * acc = y + p * nOps;
+            for (size_t o = 0 ; o < nOps ; o++)
+            {acc[o] = 0;}
+
+            size_t start = rowOffsets.get(p);
+            size_t stop = rowOffsets.get(p + 1);
+            for (size_t i = start ; i < stop ; i++)
+            {
+                T f = x[cols.get(i)];
+                const T * v = &vals.get(i * nOps);
+
+                for (size_t o = 0 ; o < nOps ; o++)
+                {acc[o] += v[o] * f;}
+            }
+        }
+    }
+
+    /*! \brief Get the number of operators
+     *
+     * \return the number of operators
+     *
+     */
+    size_t getNOperators() const
+    {
+        return nOps;
+    }
+
+    /*! \brief Get the number of rows (local particles)
+     *
+     * \return the number of rows
+     *
+     */
+    size_t getNRows() const
+    {
+        return (rowOffsets.size() == 0)?0:rowOffsets.size() - 1;
+    }
+
+    /*! \brief Get the number of columns (local + ghost particles)
+     *
+     * \return the number of columns
+     *
+     */
+    size_t getNCols() const
+    {
+        return nCols;
+    }
+
+    /*! \brief Get the number of non-zeros of the shared pattern
+     *
+     * \return the number of non-zeros
+     *
+     */
+    size_t getNNZ() const
+    {
+        return cols.size();
+    }
+
+    //! Row offsets of the CSR
+    const openfpm::vector<size_t> & getRowOffsets() const
+    {
+        return rowOffsets;
+    }
+
+    //! Columns of the CSR
+    const openfpm::vector<unsigned int> & getColumns() const
+    {
+        return cols;
+    }
+
+    //! Coefficients of the CSR, getNOperators() for each non-zero
+    const openfpm::vector<T> & getValues() const
+    {
+        return vals;
+    }
+};
+
+#endif //OPENFPM_PDATA_DCPSESPMV_HPP
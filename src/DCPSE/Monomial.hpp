@@ -38,6 +38,8 @@ public:
 
     unsigned int getExponent(unsigned int i) const;
 
+    unsigned int getScalar() const;
+
     void setExponent(unsigned int i, unsigned int value);
 
     template<typename T>
@@ -128,6 +130,12 @@ unsigned int Monomial<dim>::getExponent(unsigned int i) const
     return exponents.value(i);
 }
 
+template<unsigned int dim>
+unsigned int Monomial<dim>::getScalar() const
+{
+    return scalar;
+}
+
 template<unsigned int dim>
 void Monomial<dim>::setExponent(unsigned int i, unsigned int value)
 {
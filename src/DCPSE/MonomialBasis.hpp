@@ -6,6 +6,8 @@
 #define OPENFPM_PDATA_MONOMIALBASIS_H
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <Grid/grid_sm.hpp>
 #include <Grid/iterators/grid_key_dx_iterator_sub_bc.hpp>
 #include "Monomial.hpp"
@@ -16,6 +18,13 @@ class MonomialBasis
 private:
     std::vector<Monomial<dim>> basis;
 
+    // Evaluation plan. The closure of the basis (all the monomials that divide an element of the basis) is
+    // ordered by degree, so that every monomial of the closure is a previous one (evalParent) times one
+    // coordinate (evalDir). evalIndex is the position of each element of the basis in the closure
+    std::vector<unsigned int> evalParent;
+    std::vector<unsigned int> evalDir;
+    std::vector<unsigned int> evalIndex;
+
 public:
     MonomialBasis(const std::vector<unsigned int> &degrees, unsigned int convergenceOrder);
 
@@ -23,7 +32,10 @@ public:
 
 //    explicit MonomialBasis(Point<dim, unsigned int> degrees, unsigned int convergenceOrder);
 
-    explicit MonomialBasis(const std::vector<Monomial<dim>> &basis) : basis(basis) {}
+    explicit MonomialBasis(const std::vector<Monomial<dim>> &basis) : basis(basis)
+    {
+        buildEvaluationPlan();
+    }
 
     MonomialBasis(const MonomialBasis &other);
 
@@ -39,6 +51,11 @@ public:
 
     MonomialBasis<dim> getDerivative(Point<dim, unsigned int> differentialOrder) const;
 
+    template<typename T>
+    void evaluate(const Point<dim, T> &x, T *values) const;
+
+    unsigned int getMaxOrder() const;
+
     bool operator==(const MonomialBasis &other) const;
 
     template<typename charT, typename traits>
@@ -56,6 +73,8 @@ public:
 
 private:
     void generateBasis(std::vector<unsigned int> m, unsigned int r);
+
+    void buildEvaluationPlan();
 };
 
 //// Definitions below
@@ -64,6 +83,7 @@ template<unsigned int dim>
 MonomialBasis<dim>::MonomialBasis(const std::vector<unsigned int> &degrees, unsigned int convergenceOrder)
 {
     generateBasis(degrees, convergenceOrder);
+    buildEvaluationPlan();
 }
 
 template<unsigned int dim>
@@ -74,12 +94,18 @@ template<unsigned int dim>
 MonomialBasis<dim>::MonomialBasis(const MonomialBasis &other)
 {
     basis = other.basis; // Here it works because both std::vector and Monomial perform a deep copy.
+    evalParent = other.evalParent;
+    evalDir = other.evalDir;
+    evalIndex = other.evalIndex;
 }
 
 template<unsigned int dim>
 MonomialBasis<dim> &MonomialBasis<dim>::operator=(const MonomialBasis &other)
 {
     basis = other.basis; // Here it works because both std::vector and Monomial perform a deep copy.
+    evalParent = other.evalParent;
+    evalDir = other.evalDir;
+    evalIndex = other.evalIndex;
     return *this;
 }
 
@@ -158,6 +184,148 @@ MonomialBasis<dim> MonomialBasis<dim>::getDerivative(const Point<dim, unsigned i
     return MonomialBasis<dim>(derivatives);
 }
 
+template<unsigned int dim>
+void MonomialBasis<dim>::buildEvaluationPlan()
+{
+    evalParent.clear();
+    evalDir.clear();
+    evalIndex.clear();
+
+    unsigned int maxExp = 0;
+    for (const auto &monomial : basis)
+    {
+        for (unsigned int i = 0; i < dim; ++i)
+        {
+            maxExp = std::max(maxExp, monomial.getExponent(i));
+        }
+    }
+    const size_t base = maxExp + 1;
+
+    // Collect the closure of the basis, each monomial is identified by a linearization of its exponents
+    std::vector<std::pair<unsigned int, size_t>> closure; // (order, linearized exponents)
+    std::map<size_t, unsigned int> closureId;
+    for (const auto &monomial : basis)
+    {
+        size_t sz[dim];
+        for (unsigned int i = 0; i < dim; ++i)
+        {
+            sz[i] = monomial.getExponent(i) + 1;
+        }
+
+        grid_sm<dim, void> g(sz);
+        grid_key_dx_iterator<dim> it(g);
+        while (it.isNext())
+        {
+            auto key = it.get();
+            size_t lin = 0;
+            size_t mul = 1;
+            unsigned int order = 0;
+            for (unsigned int i = 0; i < dim; ++i)
+            {
+                lin += key.get(i) * mul;
+                mul *= base;
+                order += key.get(i);
+            }
+            if (closureId.find(lin) == closureId.end())
+            {
+                closureId[lin] = 0;
+                closure.push_back(std::make_pair(order, lin));
+            }
+            ++it;
+        }
+    }
+    std::sort(closure.begin(), closure.end());
+
+    // The parent of every monomial in the closure is obtained removing one power of the first non-zero exponent
+    for (unsigned int c = 0; c < closure.size(); ++c)
+    {
+        closureId[closure[c].second] = c;
+
+        size_t lin = closure[c].second;
+        size_t mul = 1;
+        unsigned int d = 0;
+        for (; d < dim && closure[c].first != 0; ++d)
+        {
+            if ((lin / mul) % base != 0)
+            {break;}
+            mul *= base;
+        }
+
+        if (closure[c].first == 0)
+        {
+            evalParent.push_back(0);
+            evalDir.push_back(0);
+        }
+        else
+        {
+            evalParent.push_back(closureId[lin - mul]);
+            evalDir.push_back(d);
+        }
+    }
+
+    for (const auto &monomial : basis)
+    {
+        size_t lin = 0;
+        size_t mul = 1;
+        for (unsigned int i = 0; i < dim; ++i)
+        {
+            lin += monomial.getExponent(i) * mul;
+            mul *= base;
+        }
+        evalIndex.push_back(closureId[lin]);
+    }
+}
+
+/*! \brief Evaluate all the monomials of the basis on a point
+ *
+ * It uses the evaluation plan, so every monomial cost one multiplication of a previously
+ * computed one and no power is computed
+ *
+ * \param x point where to evaluate
+ * \param values array where to store the values (at least size() elements)
+ *
+ */
+template<unsigned int dim>
+template<typename T>
+void MonomialBasis<dim>::evaluate(const Point<dim, T> &x, T *values) const
+{
+    const unsigned int stackSize = 128;
+    T stackBuf[stackSize];
+    std::vector<T> heapBuf;
+
+    T *closureValues = stackBuf;
+    if (evalParent.size() > stackSize)
+    {
+        heapBuf.resize(evalParent.size());
+        closureValues = heapBuf.data();
+    }
+
+    if (evalParent.size() != 0)
+    {
+        closureValues[0] = 1;
+    }
+    for (unsigned int c = 1; c < evalParent.size(); ++c)
+    {
+        closureValues[c] = closureValues[evalParent[c]] * x.value(evalDir[c]);
+    }
+
+    for (unsigned int i = 0; i < basis.size(); ++i)
+    {
+        values[i] = basis[i].getScalar() * closureValues[evalIndex[i]];
+    }
+}
+
+template<unsigned int dim>
+unsigned int MonomialBasis<dim>::getMaxOrder() const
+{
+    unsigned int maxOrder = 0;
+    for (const auto &monomial : basis)
+    {
+        maxOrder = std::max(maxOrder, monomial.order());
+    }
+    return maxOrder;
+}
+
 template<unsigned int dim>
 bool MonomialBasis<dim>::operator==(const MonomialBasis &other) const
 {
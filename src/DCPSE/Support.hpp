@@ -34,7 +34,7 @@ public:
       keys(other.keys)
      {}
 
-    size_t size()
+    size_t size() const
     {
         return keys.size();
     }
@@ -50,5 +50,49 @@ public:
 	}
 };
 
+/*! \brief Non-owning view of a support stored in CSR form
+ *
+ * The keys are stored as 32-bit indexes in an array shared by all the particles
+ *
+ */
+class SupportView
+{
+private:
+
+    size_t referencePointKey;
+    const unsigned int * keys;
+    size_t n;
+
+public:
+
+    SupportView(size_t referencePoint, const unsigned int * keys, size_t n)
+    :referencePointKey(referencePoint),keys(keys),n(n)
+    {}
+
+    size_t size() const
+    {
+        return n;
+    }
+
+    size_t getReferencePointKey() const
+    {
+        return referencePointKey;
+    }
+
+    size_t getKey(size_t i) const
+    {
+        return keys[i];
+    }
+
+    const unsigned int * begin() const
+    {
+        return keys;
+    }
+
+    const unsigned int * end() const
+    {
+        return keys + n;
+    }
+};
 
 #endif //OPENFPM_PDATA_SUPPORT_HPP
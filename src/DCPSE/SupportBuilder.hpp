@@ -13,6 +13,7 @@
 #include <Vector/vector_dist.hpp>
 #include "Support.hpp"
 #include <utility>
+#include <queue>
 
 enum support_options
 {
@@ -36,23 +37,47 @@ public:
 
     template<typename iterator_type>
     Support getSupport(iterator_type itPoint, unsigned int requiredSize, support_options opt)
+    {
+        return getSupport(itPoint.get(), itPoint.getOrig(), requiredSize, opt);
+    }
+
+    /*! \brief Get the support of a particle given its key
+     *
+     * It does not modify the builder, so it can be called concurrently from several threads
+     *
+     * \param p key of the particle
+     * \param pOrig original key of the particle (equal to p when domain is not a subset)
+     * \param requiredSize minimum number of particles in the support
+     * \param opt support options
+     *
+     * \return the support
+     *
+     */
+    Support getSupport(vect_dist_key_dx p, vect_dist_key_dx pOrig, unsigned int requiredSize, support_options opt)
     {
         // Get spatial position from point iterator
-        vect_dist_key_dx p = itPoint.get();
-        vect_dist_key_dx pOrig = itPoint.getOrig();
         Point<vector_type::dims, typename vector_type::stype> pos = domain.getPos(p.getKey());
 
         // Get cell containing current point and add it to the set of cell keys
         grid_key_dx<vector_type::dims> curCellKey = cellList.getCellGrid(pos); // Here get the key of the cell where the current point is
-        std::set<grid_key_dx<vector_type::dims>> supportCells;
-        supportCells.insert(curCellKey);
 
-        // Make sure to consider a set of cells providing enough points for the support
-        enlargeSetOfCellsUntilSize(supportCells, requiredSize + 1,opt); // NOTE: this +1 is because we then remove the point itself
+        std::vector<size_t> supportKeys;
+
+        if (opt == support_options::N_PARTICLES)
+        {
+            supportKeys = getNearestPoints(curCellKey, p, pOrig, requiredSize);
+        }
+        else
+        {
+            std::set<grid_key_dx<vector_type::dims>> supportCells;
+            supportCells.insert(curCellKey);
 
-        // Now return all the points from the support into a vector
+            // Make sure to consider a set of cells providing enough points for the support
+            enlargeSetOfCellsUntilSize(supportCells, requiredSize + 1,opt); // NOTE: this +1 is because we then remove the point itself
 
-        std::vector<size_t> supportKeys = getPointsInSetOfCells(supportCells,p,pOrig,requiredSize,opt);
+            // Now return all the points from the support into a vector
+            supportKeys = getPointsInSetOfCells(supportCells,p,pOrig,requiredSize,opt);
+        }
 
         auto p_o = domain.getOriginKey(p.getKey());
         std::remove(supportKeys.begin(), supportKeys.end(), p_o.getKey());
@@ -70,6 +95,8 @@ private:
 
     std::vector<size_t> getPointsInSetOfCells(std::set<grid_key_dx<vector_type::dims>> set, vect_dist_key_dx & p,  vect_dist_key_dx & pOrig, size_t requiredSupportSize, support_options opt);
 
+    std::vector<size_t> getNearestPoints(const grid_key_dx<vector_type::dims> &curCellKey, vect_dist_key_dx & p, vect_dist_key_dx & pOrig, size_t requiredSupportSize);
+
     bool isCellKeyInBounds(grid_key_dx<vector_type::dims> key);
 };
 
@@ -234,6 +261,134 @@ std::vector<size_t> SupportBuilder<vector_type>::getPointsInSetOfCells(std::set<
     return points;
 }
 
+/*! \brief Get the requiredSupportSize nearest particles of p
+ *
+ * The cells around the cell of p are visited shell by shell (a shell is the set of cells at the
+ * same Chebyshev distance from the central one), keeping the nearest particles found in a bounded
+ * max-heap. The particles in the shell r+1 are at least r cell sizes far from p, so the search stops
+ * as soon as the heap is full and its farthest particle is nearer than that
+ *
+ * \param curCellKey cell that contains p
+ * \param p particle
+ * \param pOrig original key of the particle (it is excluded from the support)
+ * \param requiredSupportSize number of particles to find
+ *
+ * \return the keys of the nearest particles ordered by distance
+ *
+ */
+template<typename vector_type>
+std::vector<size_t> SupportBuilder<vector_type>::getNearestPoints(const grid_key_dx<vector_type::dims> &curCellKey,
+                                                                  vect_dist_key_dx & p,
+                                                                  vect_dist_key_dx & pOrig,
+                                                                  size_t requiredSupportSize)
+{
+    struct reord
+    {
+        typename vector_type::stype dist;
+        size_t offset;
+
+        bool operator<(const reord & p) const
+        {return this->dist < p.dist;}
+    };
+
+    std::priority_queue<reord> nearest;
+    Point<vector_type::dims,typename vector_type::stype> xp = domain.getPos(p);
+    grid_key_dx<vector_type::dims> cell = curCellKey;
+
+    // Smallest cell size and biggest shell that contain cells
+    typename vector_type::stype minCellSize = cellList.getCellBox().getHigh(0);
+    const size_t *cellGridSize = cellList.getGrid().getSize();
+    long int maxShell = 0;
+    for (size_t i = 0; i < vector_type::dims; ++i)
+    {
+        minCellSize = std::min(minCellSize, (typename vector_type::stype)cellList.getCellBox().getHigh(i));
+        maxShell = std::max(maxShell, (long int)curCellKey.get(i));
+        maxShell = std::max(maxShell, (long int)cellGridSize[i] - 1 - (long int)curCellKey.get(i));
+    }
+
+    for (long int r = 0 ; r <= maxShell ; r++)
+    {
+        // The shell r is visited as a set of disjoint slabs: the slab d contains the cells whose first
+        // coordinate at distance r from the central cell is the d-th, so every cell of the shell is
+        // visited once and the cells inside it are never visited again
+        size_t nSlabs = (r == 0)?1:vector_type::dims;
+        for (size_t d = 0 ; d < nSlabs ; d++)
+        {
+            size_t sz[vector_type::dims];
+            for (size_t i = 0 ; i < vector_type::dims ; i++)
+            {
+                if (r == 0)     {sz[i] = 1;}
+                else if (i < d) {sz[i] = 2*r-1;}
+                else if (i == d) {sz[i] = 2;}
+                else            {sz[i] = 2*r+1;}
+            }
+
+            grid_sm<vector_type::dims,void> g(sz);
+            grid_key_dx_iterator<vector_type::dims> g_k(g);
+            while(g_k.isNext())
+            {
+                auto s_key = g_k.get();
+
+                grid_key_dx<vector_type::dims> key;
+                for (size_t i = 0 ; i < vector_type::dims ; i++)
+                {
+                    long int off;
+                    if (r == 0)     {off = 0;}
+                    else if (i < d) {off = s_key.get(i) - (r-1);}
+                    else if (i == d) {off = (s_key.get(i) == 0)?-r:r;}
+                    else            {off = s_key.get(i) - r;}
+
+                    key.set_d(i, cell.get(i) + off);
+                }
+
+                if (isCellKeyInBounds(key))
+                {
+                    const size_t cellLinId = getCellLinId(key);
+                    const size_t elemsInCell = getNumElementsInCell(key);
+                    for (size_t k = 0; k < elemsInCell; ++k)
+                    {
+                        size_t el = cellList.get(cellLinId, k);
+
+                        if (pOrig.getKey() == el)   {continue;}
+
+                        Point<vector_type::dims,typename vector_type::stype> xq = domain.getPosOrig(el);
+
+                        reord pr;
+
+                        pr.dist = xp.distance(xq);
+                        pr.offset = el;
+
+                        if (nearest.size() < requiredSupportSize)
+                        {
+                            nearest.push(pr);
+                        }
+                        else if (pr.dist < nearest.top().dist)
+                        {
+                            nearest.pop();
+                            nearest.push(pr);
+                        }
+                    }
+                }
+
+                ++g_k;
+            }
+        }
+
+        // The particles in the next shell cannot be nearer than the ones we have
+        if (nearest.size() == requiredSupportSize && nearest.top().dist <= r * minCellSize)
+        {break;}
+    }
+
+    std::vector<size_t> points(nearest.size());
+    for (long int i = nearest.size() - 1 ; i >= 0 ; i--)
+    {
+        points[i] = nearest.top().offset;
+        nearest.pop();
+    }
+
+    return points;
+}
+
 template<typename vector_type>
 SupportBuilder<vector_type>::SupportBuilder(vector_type &domain, unsigned int *differentialSignature, typename vector_type::stype rCut)
         : SupportBuilder(domain, Point<vector_type::dims, unsigned int>(differentialSignature), rCut) {}
@@ -12,9 +12,21 @@ class VandermondeRowBuilder
 {
 private:
     const MonomialBasis<dim> monomialBasis;
+    std::vector<T> values;
+    std::vector<unsigned int> orders;
+    std::vector<T> epsPow;
 
 public:
-    VandermondeRowBuilder(const MonomialBasis<dim> &monomialBasis) : monomialBasis(monomialBasis) {}
+    VandermondeRowBuilder(const MonomialBasis<dim> &monomialBasis)
+    : monomialBasis(monomialBasis),
+      values(monomialBasis.size()),
+      epsPow(monomialBasis.getMaxOrder() + 1)
+    {
+        for (auto& basisElement : monomialBasis.getElements())
+        {
+            orders.push_back(basisElement.order());
+        }
+    }
 
     template <typename MatrixType>
     void buildRow(MatrixType &M, unsigned int row, Point<dim, T> x, T eps);
@@ -24,13 +36,18 @@ template<unsigned int dim, typename T>
 template <typename MatrixType>
 void VandermondeRowBuilder<dim, T>::buildRow(MatrixType &M, unsigned int row, Point<dim, T> x, T eps)
 {
-    unsigned int col = 0;
-    for (auto& basisElement : monomialBasis.getElements())
+    // All the monomials are evaluated in one pass, eps^order is tabulated
+    monomialBasis.evaluate(x, values.data());
+
+    epsPow[0] = 1;
+    for (unsigned int k = 1; k < epsPow.size(); ++k)
+    {
+        epsPow[k] = epsPow[k - 1] * eps;
+    }
+
+    for (unsigned int col = 0; col < values.size(); ++col)
     {
-        Monomial<dim> m = monomialBasis.getElement(col);
-        M(row, col) = m.evaluate(x);
-        M(row, col) /= openfpm::math::intpowlog(eps, m.order());
-        ++col;
+        M(row, col) = values[col] / epsPow[orders[col]];
     }
 }
 
@@ -0,0 +1,139 @@
+//
+// DcpseMomentSolver_unit_tests.cpp
+//
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "config.h"
+
+#ifdef HAVE_EIGEN
+
+#include "DCPSE/DcpseMomentSolver.hpp"
+
+BOOST_AUTO_TEST_SUITE(DcpseMomentSolver_tests)
+
+    BOOST_AUTO_TEST_CASE(DcpseMomentSolver_fixed_and_dynamic_test)
+    {
+        // 10 is solved with fixed size matrices, 12 with dynamic ones
+        unsigned int sizes[2] = {10, 12};
+
+        for (int k = 0 ; k < 2 ; k++)
+        {
+            unsigned int n = sizes[k];
+
+            EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> B = Eigen::MatrixXd::Random(3 * n, n);
+            EMatrix<double, Eigen::Dynamic, 1> b = Eigen::VectorXd::Random(n);
+            EMatrix<double, Eigen::Dynamic, 1> a(n, 1);
+
+            DcpseMomentSolver<double> solver(n);
+            bool ldlt = solver.solve(B, b, a);
+
+            EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> A = B.transpose() * B;
+            EMatrix<double, Eigen::Dynamic, 1> a_qr = A.colPivHouseholderQr().solve(b);
+
+            BOOST_REQUIRE_EQUAL(ldlt, true);
+            BOOST_REQUIRE_SMALL((a - a_qr).norm(), 1e-10);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(DcpseMomentSolver_multi_rhs_test)
+    {
+        unsigned int n = 6;
+
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> B = Eigen::MatrixXd::Random(3 * n, n);
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> b = Eigen::MatrixXd::Random(n, 3);
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> a(n, 3);
+
+        DcpseMomentSolver<double> solver(n);
+        bool ldlt = solver.solve(B, b, a);
+
+        BOOST_REQUIRE_EQUAL(ldlt, true);
+
+        for (int k = 0 ; k < 3 ; k++)
+        {
+            EMatrix<double, Eigen::Dynamic, 1> bk = b.col(k);
+            EMatrix<double, Eigen::Dynamic, 1> ak(n, 1);
+            solver.solve(B, bk, ak);
+
+            BOOST_REQUIRE_SMALL((a.col(k) - ak).norm(), 1e-12);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(DcpseMomentSolver_fallback_test)
+    {
+        unsigned int n = 10;
+
+        // Two equal columns make the moment system singular
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> B = Eigen::MatrixXd::Random(3 * n, n);
+        B.col(1) = B.col(0);
+        EMatrix<double, Eigen::Dynamic, 1> b = Eigen::VectorXd::Random(n);
+        EMatrix<double, Eigen::Dynamic, 1> a(n, 1);
+
+        DcpseMomentSolver<double> solver(n);
+        bool ldlt = solver.solve(B, b, a);
+
+        BOOST_REQUIRE_EQUAL(ldlt, false);
+        for (unsigned int i = 0 ; i < n ; i++)
+        {
+            BOOST_REQUIRE(std::isfinite(a(i)));
+        }
+
+        // QR report the rank deficiency, and succeed on a full rank system
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> bm = b;
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> am(n, 1);
+        BOOST_REQUIRE_EQUAL(dcpse_moment_solver_qr(B, bm, am), false);
+
+        B.col(1) = Eigen::VectorXd::Random(3 * n);
+        BOOST_REQUIRE_EQUAL(dcpse_moment_solver_qr(B, bm, am), true);
+    }
+
+    BOOST_AUTO_TEST_CASE(DcpseMomentSolver_batch_test)
+    {
+        unsigned int n = 10;
+        unsigned int m = 25;
+        unsigned int nb = 7;
+
+        EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> b = Eigen::MatrixXd::Random(n, 2);
+
+        std::vector<EMatrix<double, Eigen::Dynamic, Eigen::Dynamic>> Bs(nb);
+        std::vector<double> B(m * n * nb);
+        std::vector<double> a(n * 2 * nb);
+
+        for (unsigned int p = 0 ; p < nb ; p++)
+        {
+            Bs[p] = Eigen::MatrixXd::Random(m, n);
+
+            // The system 3 is singular and must be solved with QR
+            if (p == 3)
+            {Bs[p].col(1) = Bs[p].col(0);}
+
+            for (unsigned int r = 0 ; r < m ; r++)
+            {
+                for (unsigned int i = 0 ; i < n ; i++)
+                {B[(r*n + i)*nb + p] = Bs[p](r,i);}
+            }
+        }
+
+        DcpseMomentSolver<double> solver(n);
+        unsigned int nLdlt = solver.solveBatch(B.data(), m, nb, b, a.data());
+
+        BOOST_REQUIRE_EQUAL(nLdlt, nb - 1);
+
+        for (unsigned int p = 0 ; p < nb ; p++)
+        {
+            // the single and the batch solver take the same decision
+            EMatrix<double, Eigen::Dynamic, Eigen::Dynamic> ap(n, 2);
+            BOOST_REQUIRE_EQUAL(solver.solve(Bs[p], b, ap), p != 3);
+
+            for (unsigned int i = 0 ; i < n ; i++)
+            {
+                for (unsigned int k = 0 ; k < 2 ; k++)
+                {BOOST_REQUIRE_SMALL(a[(i*2 + k)*nb + p] - ap(i,k), 1e-9);}
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
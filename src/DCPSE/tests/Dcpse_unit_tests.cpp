@@ -8,6 +8,10 @@
 #include <boost/test/tools/floating_point_comparison.hpp>
 #include <Vector/vector_dist.hpp>
 #include <DCPSE/Dcpse.hpp>
+#include <map>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
 
 template<typename T>
 void check_small_or_close(T value, T expected, T tolerance)
@@ -425,6 +429,335 @@ BOOST_AUTO_TEST_SUITE(Dcpse_tests)
         BOOST_REQUIRE(check);
     }
 
+#ifdef HAVE_OPENMP
+
+    BOOST_AUTO_TEST_CASE(Dcpse_2D_openmp_test)
+    {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        size_t edgeSemiSize = 20;
+        const size_t sz[2] = {2 * edgeSemiSize, 2 * edgeSemiSize};
+        Box<2, double> box({0, 0}, {2 * M_PI, 2 * M_PI});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        double spacing[2];
+        spacing[0] = 1.0 / (sz[0] - 1);
+        spacing[1] = 1.0 / (sz[1] - 1);
+        double rCut = 3.1 * spacing[0];
+        Ghost<2, double> ghost(rCut);
+
+        vector_dist<2, double, aggregate<double, double, double>> domain(0, box, bc, ghost);
+
+        if (rank == 0)
+        {
+            std::mt19937 rng{6666666};
+            std::normal_distribution<> gaussian{0, spacing[0] * 0.1};
+
+            auto it = domain.getGridIterator(sz);
+            while (it.isNext())
+            {
+                domain.add();
+                auto key = it.get();
+                domain.getLastPos()[0] = key.get(0) * spacing[0] + gaussian(rng);
+                domain.getLastPos()[1] = key.get(1) * spacing[1] + gaussian(rng);
+                ++it;
+            }
+        }
+        domain.map();
+        domain.ghost_get();
+
+        // The kernels computed with one thread must be bit-identical to the multi-threaded ones
+        int nThreads = omp_get_max_threads();
+        omp_set_num_threads(1);
+        Dcpse<2, vector_dist<2, double, aggregate<double, double, double>> > dcpseSerial(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        omp_set_num_threads(nThreads);
+        Dcpse<2, vector_dist<2, double, aggregate<double, double, double>> > dcpseParallel(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+
+        bool check = true;
+        auto itVal = domain.getDomainIterator();
+        while (itVal.isNext())
+        {
+            auto key = itVal.get();
+
+            check &= dcpseSerial.getNumNN(key) == dcpseParallel.getNumNN(key);
+            check &= dcpseSerial.getEpsilonInvPrefactor(key) == dcpseParallel.getEpsilonInvPrefactor(key);
+            for (int j = 0 ; j < dcpseSerial.getNumNN(key) && check == true ; j++)
+            {
+                check &= dcpseSerial.getIndexNN(key, j) == dcpseParallel.getIndexNN(key, j);
+                check &= dcpseSerial.getCoeffNN(key, j) == dcpseParallel.getCoeffNN(key, j);
+            }
+
+            ++itVal;
+        }
+        BOOST_REQUIRE(check);
+    }
+
+#endif // HAVE_OPENMP
+
+    BOOST_AUTO_TEST_CASE(Dcpse_2D_incremental_update_test)
+    {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        size_t edgeSemiSize = 20;
+        const size_t sz[2] = {2 * edgeSemiSize, 2 * edgeSemiSize};
+        Box<2, double> box({0, 0}, {2 * M_PI, 2 * M_PI});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        double spacing[2];
+        spacing[0] = 1.0 / (sz[0] - 1);
+        spacing[1] = 1.0 / (sz[1] - 1);
+        double rCut = 3.1 * spacing[0];
+        double skin = 0.5 * spacing[0];
+        Ghost<2, double> ghost(rCut + skin);
+
+        typedef vector_dist<2, double, aggregate<double, double, double>> vector_type;
+        vector_type domain(0, box, bc, ghost);
+
+        if (rank == 0)
+        {
+            std::mt19937 rng{6666666};
+            std::normal_distribution<> gaussian{0, spacing[0] * 0.1};
+
+            auto it = domain.getGridIterator(sz);
+            while (it.isNext())
+            {
+                domain.add();
+                auto key = it.get();
+                domain.getLastPos()[0] = key.get(0) * spacing[0] + gaussian(rng);
+                domain.getLastPos()[1] = key.get(1) * spacing[1] + gaussian(rng);
+                ++it;
+            }
+        }
+        domain.map();
+        domain.ghost_get();
+
+        Dcpse<2, vector_type> dcpse(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+
+        // Compare the supports (as sets) and the kernels of two operators
+        auto compare = [&](Dcpse<2, vector_type> & op1, Dcpse<2, vector_type> & op2)
+        {
+            bool check = true;
+            auto itVal = domain.getDomainIterator();
+            while (itVal.isNext())
+            {
+                auto key = itVal.get();
+
+                check &= op1.getNumNN(key) == op2.getNumNN(key);
+                check &= fabs(op1.getEpsilonInvPrefactor(key) - op2.getEpsilonInvPrefactor(key)) <= 1e-10 * fabs(op2.getEpsilonInvPrefactor(key));
+
+                std::map<size_t, double> ker2;
+                for (int j = 0 ; j < op2.getNumNN(key) ; j++)
+                {ker2[op2.getIndexNN(key, j)] = op2.getCoeffNN(key, j);}
+
+                for (int j = 0 ; j < op1.getNumNN(key) && check == true ; j++)
+                {
+                    auto k2 = ker2.find(op1.getIndexNN(key, j));
+                    check &= k2 != ker2.end();
+                    check &= k2 != ker2.end() && fabs(op1.getCoeffNN(key, j) - k2->second) <= 1e-8;
+                }
+
+                ++itVal;
+            }
+
+            return check;
+        };
+
+        // The construction store the reference positions, the first update builds the candidates
+        BOOST_REQUIRE_EQUAL(dcpse.initializeUpdateIncremental(domain, skin), true);
+
+        // Move one particle by a displacement much smaller than the skin
+        if (domain.size_local() != 0)
+        {domain.getPos(0)[0] += 1e-7 * spacing[0];}
+        domain.ghost_get();
+
+        bool incremental = dcpse.initializeUpdateIncremental(domain, skin);
+        if (create_vcluster().size() == 1)
+        {BOOST_REQUIRE_EQUAL(incremental, true);}
+
+        Dcpse<2, vector_type> dcpseFull(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        BOOST_REQUIRE(compare(dcpse, dcpseFull));
+
+        // Move all the particles by less than skin/2: many pairs cross rCut, so particles enter and
+        // leave the supports, and the incremental operator must be the one a full construction gives
+        std::vector<size_t> numNN;
+        auto itNN = domain.getDomainIterator();
+        while (itNN.isNext())
+        {
+            numNN.push_back(dcpse.getNumNN(itNN.get()));
+            ++itNN;
+        }
+
+        std::mt19937 rng{1234};
+        std::uniform_real_distribution<> unif{-0.17 * skin, 0.17 * skin};
+        auto itMove = domain.getDomainIterator();
+        while (itMove.isNext())
+        {
+            auto key = itMove.get();
+            domain.getPos(key)[0] += unif(rng);
+            domain.getPos(key)[1] += unif(rng);
+            ++itMove;
+        }
+        domain.ghost_get();
+
+        incremental = dcpse.initializeUpdateIncremental(domain, skin);
+        if (create_vcluster().size() == 1)
+        {BOOST_REQUIRE_EQUAL(incremental, true);}
+
+        size_t nChanged = 0;
+        size_t k = 0;
+        itNN = domain.getDomainIterator();
+        while (itNN.isNext())
+        {
+            nChanged += numNN[k] != (size_t)dcpse.getNumNN(itNN.get());
+            ++k;
+            ++itNN;
+        }
+
+        if (domain.size_local() != 0)
+        {BOOST_REQUIRE(nChanged != 0);}
+
+        Dcpse<2, vector_type> dcpseMoved(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        BOOST_REQUIRE(compare(dcpse, dcpseMoved));
+
+        // A family (Dx and Dy) is updated with one set of candidates and one detection of the moved particles
+        std::vector<Dcpse<2, vector_type>> family;
+        family.reserve(2);
+        family.emplace_back(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS, dcpse_family_member());
+        family.emplace_back(domain, Point<2, unsigned int>({0, 1}), 2, rCut, 1.9, support_options::RADIUS, dcpse_family_member());
+        Dcpse<2, vector_type>::initializeFamily(domain, family.data(), 2);
+
+        BOOST_REQUIRE_EQUAL(Dcpse<2, vector_type>::initializeFamilyIncremental(domain, family.data(), 2, skin), true);
+
+        auto itMoveFamily = domain.getDomainIterator();
+        while (itMoveFamily.isNext())
+        {
+            auto key = itMoveFamily.get();
+            domain.getPos(key)[0] += 0.5 * unif(rng);
+            domain.getPos(key)[1] += 0.5 * unif(rng);
+            ++itMoveFamily;
+        }
+        domain.ghost_get();
+
+        incremental = Dcpse<2, vector_type>::initializeFamilyIncremental(domain, family.data(), 2, skin);
+        if (create_vcluster().size() == 1)
+        {BOOST_REQUIRE_EQUAL(incremental, true);}
+
+        Dcpse<2, vector_type> dcpseMovedX(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        Dcpse<2, vector_type> dcpseMovedY(domain, Point<2, unsigned int>({0, 1}), 2, rCut, 1.9, support_options::RADIUS);
+        BOOST_REQUIRE(compare(family[0], dcpseMovedX));
+        BOOST_REQUIRE(compare(family[1], dcpseMovedY));
+
+        // The single operator moved since its last update, bring it to the current positions
+        dcpse.initializeUpdateIncremental(domain, skin);
+
+        // A displacement larger than half of the skin rebuild the supports
+        if (domain.size_local() != 0)
+        {domain.getPos(0)[0] += skin;}
+        domain.ghost_get();
+
+        incremental = dcpse.initializeUpdateIncremental(domain, skin);
+        if (create_vcluster().size() == 1)
+        {BOOST_REQUIRE_EQUAL(incremental, false);}
+
+        // A redistribution of the particles rebuild the operator
+        domain.map();
+        domain.ghost_get();
+
+        BOOST_REQUIRE_EQUAL(dcpse.initializeUpdateIncremental(domain, skin), false);
+
+        Dcpse<2, vector_type> dcpseMapped(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        BOOST_REQUIRE(compare(dcpse, dcpseMapped));
+    }
+
+    BOOST_AUTO_TEST_CASE(Dcpse_2D_checkpoint_test)
+    {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        size_t edgeSemiSize = 20;
+        const size_t sz[2] = {2 * edgeSemiSize, 2 * edgeSemiSize};
+        Box<2, double> box({0, 0}, {2 * M_PI, 2 * M_PI});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        double spacing[2];
+        spacing[0] = 1.0 / (sz[0] - 1);
+        spacing[1] = 1.0 / (sz[1] - 1);
+        double rCut = 3.1 * spacing[0];
+        Ghost<2, double> ghost(rCut);
+
+        typedef vector_dist<2, double, aggregate<double, double, double>> vector_type;
+        vector_type domain(0, box, bc, ghost);
+
+        if (rank == 0)
+        {
+            std::mt19937 rng{6666666};
+            std::normal_distribution<> gaussian{0, spacing[0] * 0.1};
+
+            auto it = domain.getGridIterator(sz);
+            while (it.isNext())
+            {
+                domain.add();
+                auto key = it.get();
+                domain.getLastPos()[0] = key.get(0) * spacing[0] + gaussian(rng);
+                domain.getLastPos()[1] = key.get(1) * spacing[1] + gaussian(rng);
+                ++it;
+            }
+        }
+        domain.map();
+        domain.ghost_get();
+
+        Dcpse<2, vector_type> dcpse(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS);
+        BOOST_REQUIRE(dcpse.save(domain, "dcpse_checkpoint_test"));
+
+        // Operator with the same parameters that does not compute the kernels
+        Dcpse<2, vector_type> dcpseLoaded(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::RADIUS, dcpse_family_member());
+        BOOST_REQUIRE(dcpseLoaded.load(domain, "dcpse_checkpoint_test"));
+
+        bool check = true;
+        auto itVal = domain.getDomainIterator();
+        while (itVal.isNext())
+        {
+            auto key = itVal.get();
+
+            check &= dcpse.getNumNN(key) == dcpseLoaded.getNumNN(key);
+            check &= dcpse.getEpsilonInvPrefactor(key) == dcpseLoaded.getEpsilonInvPrefactor(key);
+            for (int j = 0 ; j < dcpse.getNumNN(key) && check == true ; j++)
+            {
+                check &= dcpse.getIndexNN(key, j) == dcpseLoaded.getIndexNN(key, j);
+                check &= dcpse.getCoeffNN(key, j) == dcpseLoaded.getCoeffNN(key, j);
+            }
+
+            ++itVal;
+        }
+        BOOST_REQUIRE(check);
+
+        // A different operator does not match the checkpoint
+        Dcpse<2, vector_type> dcpseOther(domain, Point<2, unsigned int>({0, 1}), 2, rCut, 1.9, support_options::RADIUS, dcpse_family_member());
+        BOOST_REQUIRE_EQUAL(dcpseOther.load(domain, "dcpse_checkpoint_test"), false);
+
+        // Moved particles do not match the checkpoint
+        if (domain.size_local() != 0)
+        {
+            domain.getPos(0)[0] += 1e-7 * spacing[0];
+            BOOST_REQUIRE_EQUAL(dcpseLoaded.load(domain, "dcpse_checkpoint_test"), false);
+        }
+
+        std::remove(("dcpse_checkpoint_test_" + std::to_string(rank)).c_str());
+
+        // Adaptive operators (oversampling factor smaller than one) are identified by their factor too
+        Dcpse<2, vector_type> dcpseAdaptive(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 0.5, support_options::N_PARTICLES);
+        BOOST_REQUIRE(dcpseAdaptive.save(domain, "dcpse_checkpoint_adaptive_test"));
+
+        Dcpse<2, vector_type> dcpseAdaptiveLoaded(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 0.5, support_options::N_PARTICLES, dcpse_family_member());
+        BOOST_REQUIRE(dcpseAdaptive.isSameFamily(dcpseAdaptiveLoaded));
+        BOOST_REQUIRE(dcpseAdaptiveLoaded.load(domain, "dcpse_checkpoint_adaptive_test"));
+
+        Dcpse<2, vector_type> dcpseStatic(domain, Point<2, unsigned int>({1, 0}), 2, rCut, 1.9, support_options::N_PARTICLES, dcpse_family_member());
+        BOOST_REQUIRE_EQUAL(dcpseAdaptive.isSameFamily(dcpseStatic), false);
+        BOOST_REQUIRE_EQUAL(dcpseStatic.load(domain, "dcpse_checkpoint_adaptive_test"), false);
+
+        std::remove(("dcpse_checkpoint_adaptive_test_" + std::to_string(rank)).c_str());
+    }
+
 #endif // HAVE_EIGEN
 
 BOOST_AUTO_TEST_SUITE_END()
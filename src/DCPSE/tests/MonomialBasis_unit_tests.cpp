@@ -168,4 +168,26 @@ BOOST_AUTO_TEST_SUITE(MonomialBasis_tests)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(MonomialBasis_evaluate_all_test)
+    {
+        Point<3, double> x({0.3, -1.7, 2.1});
+
+        MonomialBasis<3> mb({2, 0, 0}, 3);
+        // The basis of the derivatives has scalars and it is not closed under division
+        MonomialBasis<3> mbd = mb.getDerivative(Point<3, unsigned int>({2, 0, 0}));
+
+        std::vector<double> values(mb.size());
+        mb.evaluate(x, values.data());
+        for (unsigned int i = 0; i < mb.size(); ++i)
+        {
+            BOOST_REQUIRE_CLOSE(values[i], mb.getElement(i).evaluate(x), 1e-10);
+        }
+
+        mbd.evaluate(x, values.data());
+        for (unsigned int i = 0; i < mbd.size(); ++i)
+        {
+            BOOST_REQUIRE_CLOSE(values[i], mbd.getElement(i).evaluate(x), 1e-10);
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Vector/vector_dist.hpp"
 #include <Space/Shape/Point.hpp>
 #include "DCPSE/SupportBuilder.hpp"
+#include <random>
 
 BOOST_AUTO_TEST_SUITE(Support_tests)
 
@@ -129,6 +130,52 @@ BOOST_AUTO_TEST_SUITE(Support_tests)
         BOOST_REQUIRE_GE(supportPoints.size(), 20);
     }
 
+    BOOST_AUTO_TEST_CASE(SupportBuilder_2D_nearest_random_test)
+    {
+        // Random cloud with a very fine cell list, the support must be made of the exact nearest particles
+        Box<2, double> box({-1.0, -1.0}, {1.0, 1.0});
+        size_t bc[2] = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2, double> ghost(0.1);
+
+        vector_dist<2, double, aggregate<double>> domain(0, box, bc, ghost);
+
+        std::mt19937 rng{1234};
+        std::uniform_real_distribution<double> unif(-1.0, 1.0);
+        for (int i = 0 ; i < 2000 ; i++)
+        {
+            domain.add();
+            domain.getLastPos()[0] = unif(rng);
+            domain.getLastPos()[1] = unif(rng);
+        }
+
+        SupportBuilder<vector_dist<2, double, aggregate<double>>> supportBuilder(domain, {1,0}, 0.02);
+
+        auto itPoint = domain.getDomainIterator();
+        for (int n = 0 ; n < 50 && itPoint.isNext() ; n++)
+        {
+            auto support = supportBuilder.getSupport(itPoint, 20, support_options::N_PARTICLES);
+            BOOST_REQUIRE_EQUAL(support.size(), 20);
+
+            // Brute force distances of all the other particles
+            Point<2, double> xp = domain.getPos(itPoint.get());
+            std::vector<double> dist;
+            for (size_t j = 0 ; j < domain.size_local() ; j++)
+            {
+                if (j == itPoint.get().getKey())  {continue;}
+                dist.push_back(xp.distance(Point<2, double>(domain.getPos(j))));
+            }
+            std::sort(dist.begin(), dist.end());
+
+            auto & keys = support.getKeys();
+            for (size_t j = 0 ; j < keys.size() ; j++)
+            {
+                BOOST_REQUIRE_EQUAL(xp.distance(Point<2, double>(domain.getPos(keys[j]))), dist[j]);
+            }
+
+            ++itPoint;
+        }
+    }
+
 //    BOOST_AUTO_TEST_CASE(Support_CopyConstructor_test)
 //    {
 //
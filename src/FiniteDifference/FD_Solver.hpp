@@ -9,8 +9,10 @@
 #define FDSOLVER_HPP_
 
 #include <functional>
+#include <memory>
 
 #include "Matrix/SparseMatrix.hpp"
+#include "Matrix/SparseMatrix_assembly.hpp"
 #include "Vector/Vector.hpp"
 #include "Grid/grid_dist_id.hpp"
 #include "Grid/Iterators/grid_dist_id_iterator_sub.hpp"
@@ -274,6 +276,18 @@ private:
     //! solver options
     options_solver opt;
 
+	//! evaluate the rows of the system in parallel when imposing the operators
+	bool parallel_assembly = false;
+
+	//! impose the operators without assembling the Matrix
+	bool matrix_free = false;
+
+	//! operators imposed in matrix-free mode, each one write its rows of A x evaluated on the grid
+	std::vector<std::function<void(typename Sys_eqs::stype *)>> mf_mult;
+
+	//! diagonal of the operators imposed in matrix-free mode
+	std::vector<std::function<void(typename Sys_eqs::stype *)>> mf_diag;
+
     //! Total number of points
     size_t tot;
 
@@ -367,6 +381,9 @@ private:
 		for (size_t i = 0 ; i < trpl.size() ; i++)
 			nz_rows.get(trpl.get(i).row() - s_pnt*Sys_eqs::nvar) = true;
 
+		A.getMatrixRows().forEachNonZero([&](long int r, long int c, typename Sys_eqs::stype v)
+		{nz_rows.get(r - s_pnt*Sys_eqs::nvar) = true;});
+
 		// Indicate all the non zero colums
 		// This check can be done only on single processor
 
@@ -379,6 +396,9 @@ private:
 			for (size_t i = 0 ; i < trpl.size() ; i++)
 				nz_cols.get(trpl.get(i).col()) = true;
 
+			A.getMatrixRows().forEachNonZero([&](long int r, long int c, typename Sys_eqs::stype v)
+			{nz_cols.get(c) = true;});
+
 			// all the rows must have a non zero element
 			for (size_t i = 0 ; i < nz_rows.size() ; i++)
 			{
@@ -541,6 +561,52 @@ private:
 		}
 	}
 
+	/*! \brief Impose only the right-hand-side on the points of a grid iterator
+	 *
+	 * The rows of b are the same filled by impose_git, the Matrix is not touched
+	 *
+	 * \param num right hand side of the term (b term)
+	 * \param id Equation id in the system that we are imposing
+	 * \param it_d iterator that define where you want to impose
+	 *
+	 */
+	template<typename bop, typename iterator>
+	void impose_git_b(bop num,
+					  long int id ,
+					  const iterator & it_d)
+	{
+		auto it = it_d;
+
+		if (num.isConstant() == false)
+		{
+			auto it_num = grid.getSubDomainIterator(it.getStart(),it.getStop());
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+				auto key_num = it_num.get();
+
+				b(g_map.template get<0>(key)*Sys_eqs::nvar + id) = num.get(key_num);
+
+				++row_b;
+				++it;
+				++it_num;
+			}
+		}
+		else
+		{
+			while (it.isNext())
+			{
+				auto key = it.get();
+
+				b(g_map.template get<0>(key)*Sys_eqs::nvar + id) = num.get(key);
+
+				++row_b;
+				++it;
+			}
+		}
+	}
+
     template<typename T,typename col, typename trp,typename iterator,typename cmb, typename Key> void impose_git_it(const T & op ,
                                                                 col &cols,
                                                                 trp &trpl,
@@ -617,7 +683,19 @@ private:
 		iterator it(it_d,false);
 		grid_sm<Sys_eqs::dims,void> gs = g_map.getGridInfoVoid();
 
-		std::unordered_map<long int,typename Sys_eqs::stype> cols;
+		if (matrix_free == true)
+		{
+			impose_git_matrix_free(op,num,id,it,c_where,shift);
+			return;
+		}
+
+		if (parallel_assembly == true)
+		{
+			impose_git_parallel(op,num,id,it,c_where,shift);
+			return;
+		}
+
+		sparse_row_accumulator<typename Sys_eqs::stype> cols;
 
 		grid_key_dx<Sys_eqs::dims> zero;
 		zero.zero();
@@ -674,6 +752,184 @@ private:
 		}
 	}
 
+	/*! \brief Impose an operator evaluating the rows in parallel
+	 *
+	 * \see setParallelAssembly
+	 *
+	 * \param op Operator to impose (A term)
+	 * \param num right hand side of the term (b term)
+	 * \param id Equation id in the system that we are imposing
+	 * \param it iterator that define where you want to impose
+	 * \param c_where staggered position of the operator
+	 * \param shift shift of the key for the staggered position
+	 *
+	 */
+	template<typename T, typename bop, typename iterator> void impose_git_parallel(const T & op ,
+			                         bop & num,
+			                         long int id ,
+									 iterator & it,
+									 const comb<Sys_eqs::dims> & c_where,
+									 const grid_key_dx<Sys_eqs::dims> & shift)
+	{
+		typedef typename std::remove_const<typename std::remove_reference<decltype(it.get())>::type>::type key_type;
+
+		std::vector<key_type> keys;
+
+		auto start = it.getStart();
+		auto stop = it.getStop();
+
+		while (it.isNext())
+		{
+			keys.push_back(it.get());
+			++it;
+		}
+
+		grid_sm<Sys_eqs::dims,void> gs = g_map.getGridInfoVoid();
+
+		auto row_f = [&](const key_type & key, sparse_row_accumulator<typename Sys_eqs::stype> & cols) -> long int
+		{
+			// every evaluation use its own copy, the operators change temporarily the staggered position
+			comb<Sys_eqs::dims> c_w = c_where;
+			key_type k = key;
+
+			k.getKeyRef() += shift;
+			op.template value_nz<Sys_eqs>(g_map,k,gs,spacing,cols,1.0,0,c_w);
+			k.getKeyRef() -= shift;
+
+			return g_map.template get<0>(k)*Sys_eqs::nvar + id;
+		};
+
+		sparse_matrix_add_rows(A.getMatrixRows(),keys,row_f);
+
+		if (num.isConstant() == false)
+		{
+			auto it_num = grid.getSubDomainIterator(start,stop);
+
+			for (size_t k = 0 ; k < keys.size() ; k++)
+			{
+				auto key_num = it_num.get();
+
+				b(g_map.template get<0>(keys[k])*Sys_eqs::nvar + id) = num.get(key_num);
+
+				++it_num;
+			}
+		}
+		else
+		{
+			for (size_t k = 0 ; k < keys.size() ; k++)
+			{b(g_map.template get<0>(keys[k])*Sys_eqs::nvar + id) = num.get(keys[k]);}
+		}
+
+		row += keys.size();
+		row_b += keys.size();
+	}
+
+	/*! \brief Impose an operator without assembling its rows
+	 *
+	 * The operator and the region are stored, the rows of A x are evaluated with the operator
+	 * value on the grid every time the operator is applied, the diagonal is extracted from the
+	 * non-zeros of every row when requested. Only b is filled
+	 *
+	 * \see setMatrixFree
+	 *
+	 * \param op Operator to impose (A term)
+	 * \param num right hand side of the term (b term)
+	 * \param id Equation id in the system that we are imposing
+	 * \param it iterator that define where you want to impose
+	 * \param c_where staggered position of the operator
+	 * \param shift shift of the key for the staggered position
+	 *
+	 */
+	template<typename T, typename bop, typename iterator> void impose_git_matrix_free(const T & op ,
+			                         bop & num,
+			                         long int id ,
+									 iterator & it,
+									 const comb<Sys_eqs::dims> & c_where,
+									 const grid_key_dx<Sys_eqs::dims> & shift)
+	{
+		std::shared_ptr<iterator> it_mf(new iterator(it,false));
+		size_t s_row = s_pnt*Sys_eqs::nvar;
+
+		mf_mult.push_back([this,op,id,it_mf,c_where,shift,s_row](typename Sys_eqs::stype * y)
+		{
+			iterator it(*it_mf,false);
+			auto it_g = grid.getSubDomainIterator(it.getStart(),it.getStop());
+
+			op.init();
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+				auto key_g = it_g.get();
+				comb<Sys_eqs::dims> c_w = c_where;
+
+				key_g.getKeyRef() += shift;
+				y[g_map.template get<0>(key)*Sys_eqs::nvar + id - s_row] = op.value(key_g,c_w);
+
+				++it;
+				++it_g;
+			}
+		});
+
+		mf_diag.push_back([this,op,id,it_mf,c_where,shift,s_row](typename Sys_eqs::stype * d)
+		{
+			iterator it(*it_mf,false);
+			grid_sm<Sys_eqs::dims,void> gs = g_map.getGridInfoVoid();
+			sparse_row_accumulator<typename Sys_eqs::stype> cols;
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+				comb<Sys_eqs::dims> c_w = c_where;
+
+				cols.clear();
+
+				key.getKeyRef() += shift;
+				op.template value_nz<Sys_eqs>(g_map,key,gs,spacing,cols,1.0,0,c_w);
+				key.getKeyRef() -= shift;
+
+				long int r = g_map.template get<0>(key)*Sys_eqs::nvar + id;
+				d[r - s_row] = (cols.has(r) == true)?cols[r]:0.0;
+
+				++it;
+			}
+		});
+
+		// fill b
+		iterator it_b(it,false);
+
+		if (num.isConstant() == false)
+		{
+			auto it_num = grid.getSubDomainIterator(it_b.getStart(),it_b.getStop());
+
+			while (it_b.isNext())
+			{
+				auto key = it_b.get();
+				auto key_num = it_num.get();
+
+				b(g_map.template get<0>(key)*Sys_eqs::nvar + id) = num.get(key_num);
+
+				++row;
+				++row_b;
+				++it_b;
+				++it_num;
+			}
+		}
+		else
+		{
+			while (it_b.isNext())
+			{
+				auto key = it_b.get();
+
+				b(g_map.template get<0>(key)*Sys_eqs::nvar + id) = num.get(key);
+
+				++row;
+				++row_b;
+				++it_b;
+			}
+		}
+	}
+
 	/*! \brief Construct the gmap structure
 	 *
 	 */
@@ -801,6 +1057,75 @@ private:
         comp++;
     }
 
+    /*! \brief Copy the solution of the right-hand-side k into the expressions that belong to it
+     *
+     * The expressions are grouped by right-hand-side, Sys_eqs::nvar for each one
+     *
+     * \param x solution
+     * \param k right-hand-side
+     * \param j index of the expression exp
+     *
+     */
+    template<typename solType, typename exp1, typename ... othersExp>
+    void copy_rhs(solType & x, size_t k, size_t j, exp1 exp, othersExp ... exps)
+    {
+        if (j / Sys_eqs::nvar == k)
+        {copy_impl(x,exp,j % Sys_eqs::nvar);}
+
+        copy_rhs(x,k,j+1,exps ...);
+    }
+
+    template<typename solType>
+    void copy_rhs(solType & x, size_t k, size_t j)
+    {
+    }
+
+    /*! \brief Copy the local part of a vector into the unknowns and update their ghost
+     *
+     * \param x local part of the vector
+     * \param comp component of the expression exp
+     * \param exp unknown
+     *
+     */
+    template<typename exp1, typename ... othersExp>
+    void copy_local(const typename Sys_eqs::stype * x, unsigned int comp, exp1 exp, othersExp ... exps)
+    {
+    	comb<Sys_eqs::dims> c_where;
+    	c_where.mone();
+        auto & grid = exp.getGrid();
+
+        auto it = grid.getDomainIterator();
+        grid_key_dx<Sys_eqs::dims> start;
+        grid_key_dx<Sys_eqs::dims> stop;
+
+        for (int i = 0 ; i < Sys_eqs::dims ; i++)
+        {
+        	start.set_d(i,0);
+        	stop.set_d(i,grid.size(i)-1);
+        }
+        auto it_map = g_map.getSubDomainIterator(start,stop);
+
+        while (it.isNext())
+        {
+            auto p = it.get();
+            auto gp = it_map.get();
+
+            size_t pn = g_map.template get<0>(gp);
+            exp.value_ref(p,c_where) = x[(pn - s_pnt)*Sys_eqs::nvar + comp];
+
+            ++it;
+            ++it_map;
+        }
+
+        grid.template ghost_get<exp1::prop>();
+
+        copy_local(x,comp+1,exps ...);
+    }
+
+    void copy_local(const typename Sys_eqs::stype * x, unsigned int comp)
+    {
+    }
+
 
 public:
 
@@ -1168,6 +1493,53 @@ public:
 
 	}
 
+	/*! \brief Impose only the right-hand-side on a box region
+	 *
+	 * The Matrix is left untouched, this is the function to use when only b must be changed,
+	 * for example in the functor of solve_multi
+	 *
+	 * \param start_k starting point of the box
+	 * \param stop_k stop point of the box
+	 * \param num right hand side of the term (b term)
+	 * \param id Equation id in the system that we are imposing
+	 *
+	 */
+	void impose_b(const grid_key_dx<Sys_eqs::dims> start_k,
+				  const grid_key_dx<Sys_eqs::dims> stop_k,
+				  typename Sys_eqs::stype num,
+				  eq_id id = eq_id())
+	{
+		auto it = g_map.getSubDomainIterator(start_k,stop_k);
+
+		constant_b b(num);
+
+		impose_git_b(b,id.getId(),it);
+	}
+
+	/*! \brief Impose only the right-hand-side on a box region
+	 *
+	 * The Matrix is left untouched, this is the function to use when only b must be changed,
+	 * for example in the functor of solve_multi
+	 *
+	 * \param start_k starting point of the box
+	 * \param stop_k stop point of the box
+	 * \param num property of the grid that contain the right hand side (b term)
+	 * \param id Equation id in the system that we are imposing
+	 *
+	 */
+	template<unsigned int prp_id>
+	void impose_b(const grid_key_dx<Sys_eqs::dims> start_k,
+				  const grid_key_dx<Sys_eqs::dims> stop_k,
+				  prop_id<prp_id> num,
+				  eq_id id = eq_id())
+	{
+		auto it = g_map.getSubDomainIterator(start_k,stop_k);
+
+		variable_b<prp_id> b(grid);
+
+		impose_git_b(b,id.getId(),it);
+	}
+
 	/*! \brief In case we want to impose a new b re-using FD_scheme we have to call
 	 *         This function
 	 */
@@ -1181,6 +1553,66 @@ public:
 	void new_A()
 	{row = 0;}
 
+	/*! \brief Reset the system, so that the operators can be imposed again
+	 *
+	 * The map between the grid points and the rows of the Matrix is kept
+	 *
+	 */
+	void reset()
+	{
+		row = 0;
+		row_b = 0;
+
+		A.getMatrixTriplets().clear();
+		A.getMatrixRows().clear();
+		mf_mult.clear();
+		mf_diag.clear();
+	}
+
+	/*! \brief Evaluate the rows of the system in parallel
+	 *
+	 * When enabled, impose evaluate the rows once in parallel (OpenMP), every thread with its own row
+	 * accumulator writing into its own CSR block of the Matrix rows (see sparse_matrix_add_rows). The
+	 * blocks are given to the Matrix backend as CSR, without triplets
+	 *
+	 * \param parallel true to enable the parallel assembly
+	 *
+	 */
+	void setParallelAssembly(bool parallel)
+	{
+		parallel_assembly = parallel;
+	}
+
+	/*! \brief Freeze the sparsity pattern of the Matrix
+	 *
+	 * For time dependent problems where the same operators are imposed again (after reset) and only
+	 * the coefficients change. The sparsity pattern is recorded on the first assembly and the next ones
+	 * write the values in place, see SparseMatrix::freezePattern
+	 *
+	 * \param freeze true to freeze the pattern
+	 *
+	 */
+	void freezePattern(bool freeze = true)
+	{
+		A.freezePattern(freeze);
+	}
+
+	/*! \brief Impose the operators without assembling the Matrix
+	 *
+	 * When enabled, impose store the operators instead of producing the rows of the Matrix, and the
+	 * system is solved with solve_matrix_free_with_solver: the Krylov solver apply the operators
+	 * directly on the grid, with a ghost exchange of the unknowns at every application. It must be
+	 * set before imposing the operators, and only the Jacobi preconditioner (from the diagonal of
+	 * the operators) can be used
+	 *
+	 * \param mf true to enable the matrix-free mode
+	 *
+	 */
+	void setMatrixFree(bool mf)
+	{
+		matrix_free = mf;
+	}
+
 
 	//! type of the sparse matrix
 	typename Sys_eqs::SparseMatrix_type A;
@@ -1422,6 +1854,124 @@ public:
         copy_nested(x,comp,exps ...);
     }
 
+    /*! \brief Solve the system for several right-hand-sides with one matrix
+     *
+     * The matrix is assembled and the solver is set-up (factorized or preconditioned) once. The
+     * right-hand-side imposed together with the operators is the first one, the others are
+     * imposed by the functor set_rhs(k) with impose_b (k from 1), the solution of the right-hand-side k
+     * is stored in the expressions from k*Sys_eqs::nvar to (k+1)*Sys_eqs::nvar - 1
+     *
+     * \verbatim
+       Solver.impose(Lap(sol),{1,1},{80,80},prop_id<1>());
+       Solver.impose(sol,{0,0},{81,0},0.0);
+
+       Solver.solve_multi([&](size_t k){Solver.impose_b({1,1},{80,80},prop_id<2>());
+                                        Solver.impose_b({0,0},{81,0},0.0);},
+                          sol0,sol1);
+     * \endverbatim
+     *
+     * \param solver Manually created Solver instead from the Equation structure
+     * \param set_rhs functor that impose the right-hand-side k
+     * \param exps where to store the results
+     *
+     */
+    template<typename SolverType, typename rhs_type, typename ... expr_type>
+    void solve_multi_with_solver(SolverType & solver, rhs_type set_rhs, expr_type ... exps)
+    {
+        if (sizeof...(exps) % Sys_eqs::nvar != 0)
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error the number of properties you gave must be a multiple of "
+                      << Sys_eqs::nvar << std::endl;
+            return;
+        }
+
+        size_t n_rhs = sizeof...(exps) / Sys_eqs::nvar;
+
+        auto & A_ = getA(opt);
+
+        auto get_b = [&](size_t k) -> typename Sys_eqs::Vector_type &
+        {
+            if (k != 0)
+            {
+                size_t row_b_end = row_b;
+                row_b = 0;
+                set_rhs(k);
+                row_b = row_b_end;
+            }
+
+            return getB(opt);
+        };
+
+        auto set_x = [&](size_t k, typename Sys_eqs::Vector_type & x)
+        {
+            copy_rhs(x,k,0,exps ...);
+        };
+
+        solver.solve_multi(A_,n_rhs,get_b,set_x);
+    }
+
+    /*! \brief Solve the system for several right-hand-sides with one matrix
+     *
+     * Same as solve_multi_with_solver using the solver of the Equation structure
+     *
+     * \param set_rhs functor that impose the right-hand-side k
+     * \param exps where to store the results
+     *
+     */
+    template<typename rhs_type, typename ... expr_type>
+    void solve_multi(rhs_type set_rhs, expr_type ... exps)
+    {
+        typename Sys_eqs::solver_type solver;
+
+        solve_multi_with_solver(solver,set_rhs,exps ...);
+    }
+
+    /*! \brief Solve the system imposed in matrix-free mode
+     *
+     * The unknowns are the grid properties the operators act on, one for each variable of the
+     * system. They are used as work space while the solver iterates, and at the end contain
+     * the solution
+     *
+     * \see setMatrixFree
+     *
+     * \param solver solver supporting solve_matrix_free (petsc_solver)
+     * \param exps unknowns
+     *
+     */
+    template<typename SolverType, typename ... expr_type>
+    void solve_matrix_free_with_solver(SolverType & solver, expr_type ... exps)
+    {
+        if (matrix_free == false)
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " Error the operators have not been imposed in matrix-free mode, call setMatrixFree(true) before impose" << std::endl;
+            return;
+        }
+
+        if (sizeof...(exps) != Sys_eqs::nvar)
+        {std::cerr << __FILE__ << ":" << __LINE__ << " Error the number of properties you gave does not match the solution in\
+    													dimensionality, I am expecting " << Sys_eqs::nvar <<
+                   " properties " << std::endl;};
+
+        auto mult = [&](const typename Sys_eqs::stype * x, typename Sys_eqs::stype * y)
+        {
+            copy_local(x,0,exps ...);
+
+            for (size_t i = 0 ; i < mf_mult.size() ; i++)
+            {mf_mult[i](y);}
+        };
+
+        auto diag = [&](typename Sys_eqs::stype * d)
+        {
+            for (size_t i = 0 ; i < mf_diag.size() ; i++)
+            {mf_diag[i](d);}
+        };
+
+        auto x = solver.solve_matrix_free(mult,diag,getB(opt));
+
+        unsigned int comp = 0;
+        copy_nested(x,comp,exps ...);
+    }
+
 	/*! \brief Copy the vector into the grid
 	 *
 	 * ## Copy the solution into the grid
@@ -4,10 +4,15 @@
 
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
+#include <tuple>
+#include <map>
+#include <limits>
 
 #include "FD_Solver.hpp"
+#include "FD_multigrid.hpp"
 #include "Solvers/petsc_solver.hpp"
 #include "Solvers/umfpack_solver.hpp"
+#include "Solvers/eigen_solver.hpp"
 #include "FD_expressions.hpp"
 #include "FD_op.hpp"
 #include "Grid/staggered_dist_grid.hpp"
@@ -63,6 +68,49 @@ BOOST_AUTO_TEST_CASE(solver_check_diagonal)
 }
 
 
+BOOST_AUTO_TEST_CASE(solver_check_diagonal_multi_rhs)
+{
+	const size_t sz[2] = {81,81};
+    Box<2, double> box({0, 0}, {1, 1});
+    periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+    Ghost<2,long int> ghost(1);
+
+    grid_dist_id<2, double, aggregate<double,double,double,double,double>> domain(sz, box, ghost, bc);
+
+    auto it = domain.getDomainIterator();
+    while (it.isNext())
+    {
+    	auto key = it.get();
+    	auto gkey = it.getGKey(key);
+        double x = gkey.get(0) * domain.spacing(0);
+        double y = gkey.get(1) * domain.spacing(1);
+        domain.get<1>(key) = x+y;
+        domain.get<2>(key) = x*y;
+
+        ++it;
+    }
+
+    domain.ghost_get<0>();
+    petsc_solver<double> pet_sol;
+    pet_sol.setPreconditioner(PCNONE);
+
+    auto v =  FD::getV<0>(domain);
+    auto RHS0 = FD::getV<1>(domain);
+    auto RHS1 = FD::getV<2>(domain);
+    auto sol0 = FD::getV<3>(domain);
+    auto sol1 = FD::getV<4>(domain);
+    FD::LInfError LInfError;
+    FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+    Solver.impose(5.0*v,{0,0},{80,80}, prop_id<1>());
+    Solver.solve_multi_with_solver(pet_sol,[&](size_t k){Solver.impose_b({0,0},{80,80}, prop_id<2>());},sol0,sol1);
+
+    v=1/5.0*RHS0;
+    BOOST_REQUIRE(LInfError(v, sol0) < 1e-5);
+    v=1/5.0*RHS1;
+    BOOST_REQUIRE(LInfError(v, sol1) < 1e-5);
+}
+
+
     BOOST_AUTO_TEST_CASE(solver_Lap)
     {
         const size_t sz[2] = {82,82};
@@ -122,6 +170,575 @@ BOOST_AUTO_TEST_CASE(solver_check_diagonal)
         //domain.write("FDSOLVER_Lap_test");
     }
 
+    BOOST_AUTO_TEST_CASE(solver_Lap_parallel_assembly)
+    {
+        const size_t sz[2] = {82,82};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double,double>> domain(sz, box, ghost, bc);
+
+        auto it = domain.getDomainIterator();
+        while (it.isNext())
+        {
+            auto key = it.get();
+            auto gkey = it.getGKey(key);
+            double x = gkey.get(0) * domain.spacing(0);
+            double y = gkey.get(1) * domain.spacing(1);
+            domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+            domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+            ++it;
+        }
+
+        domain.ghost_get<0>();
+        auto v =  FD::getV<0>(domain);
+        auto sol = FD::getV<2>(domain);
+        auto sol_par = FD::getV<3>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        // The same system assembled row by row and with the parallel two-pass assembly
+        FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+        FD_scheme<equations2d1,decltype(domain)> Solver_par(ghost,domain);
+        Solver_par.setParallelAssembly(true);
+
+        auto impose = [&](FD_scheme<equations2d1,decltype(domain)> & S)
+        {
+            S.impose(Lap(v),{1,1},{80,80}, prop_id<1>());
+            S.impose(v,{0,0},{81,0}, prop_id<0>());
+            S.impose(v,{0,1},{0,80}, prop_id<0>());
+            S.impose(v,{0,81},{81,81}, prop_id<0>());
+            S.impose(v,{81,1},{81,80}, prop_id<0>());
+        };
+
+        impose(Solver);
+        impose(Solver_par);
+
+        // the serial rows are triplets, the parallel ones are CSR blocks
+        auto & trpl = Solver.getA().getMatrixTriplets();
+        auto & rows_par = Solver_par.getA().getMatrixRows();
+
+        BOOST_REQUIRE_EQUAL(Solver_par.getA().getMatrixTriplets().size(),0ul);
+
+        std::vector<std::tuple<long int,long int,double>> nz;
+        std::vector<std::tuple<long int,long int,double>> nz_par;
+
+        for (size_t i = 0 ; i < trpl.size() ; i++)
+        {nz.push_back(std::make_tuple((long int)trpl.get(i).row(),(long int)trpl.get(i).col(),trpl.get(i).value()));}
+
+        rows_par.forEachNonZero([&](long int r, long int c, double v){nz_par.push_back(std::make_tuple(r,c,v));});
+
+        std::sort(nz.begin(),nz.end());
+        std::sort(nz_par.begin(),nz_par.end());
+
+        BOOST_REQUIRE(nz == nz_par);
+
+        // The right hand side must be the same too
+        petsc_solver<double> pet_sol;
+        pet_sol.setPreconditioner(PCNONE);
+        Solver.solve_with_solver(pet_sol,sol);
+
+        petsc_solver<double> pet_sol_par;
+        pet_sol_par.setPreconditioner(PCNONE);
+        Solver_par.solve_with_solver(pet_sol_par,sol_par);
+
+        BOOST_REQUIRE(LInfError(sol, sol_par) < 1e-12);
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_Lap_matrix_free)
+    {
+        const size_t sz[2] = {82,82};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double,double>> domain(sz, box, ghost, bc);
+
+        auto it = domain.getDomainIterator();
+        while (it.isNext())
+        {
+            auto key = it.get();
+            auto gkey = it.getGKey(key);
+            double x = gkey.get(0) * domain.spacing(0);
+            double y = gkey.get(1) * domain.spacing(1);
+            domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+            domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+            domain.get<3>(key) = 0.0;
+            ++it;
+        }
+
+        domain.ghost_get<0,3>();
+        auto v =  FD::getV<0>(domain);
+        auto sol= FD::getV<2>(domain);
+        auto u = FD::getV<3>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        // assembled
+        FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+        Solver.impose(Lap(u),{1,1},{80,80}, prop_id<1>());
+        Solver.impose(u,{0,0},{81,0}, prop_id<0>());
+        Solver.impose(u,{0,1},{0,80}, prop_id<0>());
+        Solver.impose(u,{0,81},{81,81}, prop_id<0>());
+        Solver.impose(u,{81,1},{81,80}, prop_id<0>());
+
+        petsc_solver<double> pet_sol;
+        pet_sol.setPreconditioner(PCJACOBI);
+        Solver.solve_with_solver(pet_sol,sol);
+
+        BOOST_REQUIRE(LInfError(v, sol) < 1e-3);
+
+        // matrix-free
+        FD_scheme<equations2d1,decltype(domain)> Solver_mf(ghost,domain);
+        Solver_mf.setMatrixFree(true);
+        Solver_mf.impose(Lap(u),{1,1},{80,80}, prop_id<1>());
+        Solver_mf.impose(u,{0,0},{81,0}, prop_id<0>());
+        Solver_mf.impose(u,{0,1},{0,80}, prop_id<0>());
+        Solver_mf.impose(u,{0,81},{81,81}, prop_id<0>());
+        Solver_mf.impose(u,{81,1},{81,80}, prop_id<0>());
+
+        petsc_solver<double> pet_sol_mf;
+        pet_sol_mf.setPreconditioner(PCJACOBI);
+        Solver_mf.solve_matrix_free_with_solver(pet_sol_mf,u);
+
+        BOOST_REQUIRE(LInfError(v, u) < 1e-3);
+        BOOST_REQUIRE(std::abs(pet_sol_mf.getLastIterations() - pet_sol.getLastIterations()) <= 1);
+
+        // the assembled Matrix store 5 coefficients for every interior point and 1 for every
+        // boundary point, this is the storage the matrix-free mode save
+        MatInfo info;
+        PETSC_SAFE_CALL(MatGetInfo(Solver.getA().getMat(),MAT_GLOBAL_SUM,&info));
+
+        BOOST_REQUIRE_EQUAL((size_t)info.nz_used, 5ul*80*80 + 4ul*81);
+
+        // memory and time per iteration of the two modes, the matrix-free mode store only the
+        // diagonal for the Jacobi preconditioner
+        auto & v_cl = create_vcluster();
+        if (v_cl.rank() == 0)
+        {
+            std::cout << "Laplacian 82x82 assembled:   " << info.memory << " bytes of Matrix, "
+                      << pet_sol.getLastApplyTime() / pet_sol.getLastIterations() << " s per iteration" << std::endl;
+            std::cout << "Laplacian 82x82 matrix-free: " << 82*82*sizeof(double) << " bytes of diagonal, "
+                      << pet_sol_mf.getLastApplyTime() / pet_sol_mf.getLastIterations() << " s per iteration" << std::endl;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_Lap_mixed_precision)
+    {
+        const size_t sz[2] = {129,129};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double,double>> domain(sz, box, ghost, bc);
+
+        auto it = domain.getDomainIterator();
+        while (it.isNext())
+        {
+            auto key = it.get();
+            auto gkey = it.getGKey(key);
+            double x = gkey.get(0) * domain.spacing(0);
+            double y = gkey.get(1) * domain.spacing(1);
+            domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+            domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+            ++it;
+        }
+
+        domain.ghost_get<0>();
+        auto v =  FD::getV<0>(domain);
+        auto sol= FD::getV<2>(domain);
+        auto sol_mp = FD::getV<3>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+        Solver.impose(Lap(v),{1,1},{127,127}, prop_id<1>());
+        Solver.impose(v,{0,0},{128,0}, prop_id<0>());
+        Solver.impose(v,{0,1},{0,127}, prop_id<0>());
+        Solver.impose(v,{0,128},{128,128}, prop_id<0>());
+        Solver.impose(v,{128,1},{128,127}, prop_id<0>());
+
+        auto & A = Solver.getA();
+        auto & b = Solver.getB();
+
+        // double precision and mixed precision with the same preconditioner
+        petsc_solver<double> pet_sol;
+        pet_sol.setSolver(KSPGMRES);
+        pet_sol.setPreconditioner(PCBJACOBI);
+        pet_sol.setRelTol(1e-10);
+        pet_sol.setMaxIter(5000);
+
+        auto x = pet_sol.solve(A,b);
+        solError err = pet_sol.get_residual_error(A,x,b);
+
+        petsc_solver<double> pet_sol_mp;
+        pet_sol_mp.setSolver(KSPGMRES);
+        pet_sol_mp.setPreconditioner(PCBJACOBI);
+        pet_sol_mp.setRelTol(1e-10);
+        pet_sol_mp.setMaxIter(5000);
+        pet_sol_mp.setMixedPrecision(true,1e-4);
+
+        auto x_mp = pet_sol_mp.solve(A,b);
+        solError err_mp = pet_sol_mp.get_residual_error(A,x_mp,b);
+
+        BOOST_REQUIRE_EQUAL(pet_sol_mp.isLastMixedConverged(),true);
+        BOOST_REQUIRE(pet_sol_mp.getLastRefinementSteps() < 30);
+
+        // the residual is not worse than the double precision one or the requested tolerance
+        PetscReal b_norm;
+        PETSC_SAFE_CALL(VecNorm(b.getVec(),NORM_2,&b_norm));
+        BOOST_REQUIRE(err_mp.err_inf <= std::max(err.err_inf,1e-10*b_norm));
+
+        // same solution and same discretization error
+        Solver.solve_with_solver(pet_sol,sol);
+        Solver.solve_with_solver(pet_sol_mp,sol_mp);
+
+        double e = LInfError(v, sol);
+        double e_mp = LInfError(v, sol_mp);
+        BOOST_REQUIRE(e < 1e-3);
+        BOOST_REQUIRE(std::fabs(e - e_mp) < 1e-6);
+        BOOST_REQUIRE(LInfError(sol, sol_mp) < 1e-6);
+
+        // timed comparison, the accuracy of the mixed precision mode is checked in
+        // laplacian_2D_mixed_precision
+        timer t_d;
+        t_d.start();
+        pet_sol.solve(A,b);
+        t_d.stop();
+
+        timer t_mp;
+        t_mp.start();
+        pet_sol_mp.solve(A,b);
+        t_mp.stop();
+
+        Vcluster<> & v_cl = create_vcluster();
+
+        if (v_cl.rank() == 0)
+        {
+            std::cout << "Poisson 129x129 double: " << pet_sol.getLastIterations() << " iterations, "
+                      << t_d.getwct() << " s (apply " << pet_sol.getLastApplyTime() << " s)" << std::endl;
+            std::cout << "Poisson 129x129 mixed:  " << pet_sol_mp.getLastIterations() << " iterations ("
+                      << pet_sol_mp.getLastRefinementSteps() << " refinements), " << t_mp.getwct()
+                      << " s (apply " << pet_sol_mp.getLastApplyTime() << " s), speedup "
+                      << t_d.getwct() / t_mp.getwct() << std::endl;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_Lap_eigen_iterative)
+    {
+        Vcluster<> & v_cl = create_vcluster();
+
+        if (v_cl.getProcessingUnits() > 1)
+            return;
+
+        const size_t sz[2] = {82,82};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double>> domain(sz, box, ghost, bc);
+
+        auto it = domain.getDomainIterator();
+        while (it.isNext())
+        {
+            auto key = it.get();
+            auto gkey = it.getGKey(key);
+            double x = gkey.get(0) * domain.spacing(0);
+            double y = gkey.get(1) * domain.spacing(1);
+            domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+            domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+            ++it;
+        }
+
+        domain.ghost_get<0>();
+        auto v =  FD::getV<0>(domain);
+        auto sol= FD::getV<2>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        FD_scheme<equations2d1E,decltype(domain)> Solver(ghost,domain);
+        Solver.impose(Lap(v),{1,1},{80,80}, prop_id<1>());
+        Solver.impose(v,{0,0},{81,0}, prop_id<0>());
+        Solver.impose(v,{0,1},{0,80}, prop_id<0>());
+        Solver.impose(v,{0,81},{81,81}, prop_id<0>());
+        Solver.impose(v,{81,1},{81,80}, prop_id<0>());
+
+        eigen_solver_pc pcs[2] = {EIGEN_PC_JACOBI,EIGEN_PC_ILU};
+
+        for (size_t i = 0 ; i < 2 ; i++)
+        {
+            eigen_solver<double> solver;
+            solver.setSolver(EIGEN_SOLVER_BICGSTAB);
+            solver.setPreconditioner(pcs[i]);
+            solver.setTolerance(1e-10);
+            Solver.solve_with_solver(solver,sol);
+
+            BOOST_REQUIRE(LInfError(v, sol) < 1e-3);
+            BOOST_REQUIRE(solver.getLastError() < 1e-10);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_Lap_multigrid)
+    {
+        const size_t sz[2] = {65,65};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double>> domain(sz, box, ghost, bc);
+
+        auto v =  FD::getV<0>(domain);
+        auto sol= FD::getV<2>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        FD_multigrid<decltype(domain)> mg(domain,ghost);
+        BOOST_REQUIRE_EQUAL(mg.setOperator(Lap(v)),true);
+
+        BOOST_REQUIRE(mg.getNLevels() >= 3);
+
+        mg_cycle cycles[3] = {MG_V_CYCLE,MG_W_CYCLE,MG_F_CYCLE};
+        mg_smoother smoothers[3] = {MG_JACOBI,MG_GAUSS_SEIDEL,MG_CHEBYSHEV};
+
+        for (size_t c = 0 ; c < 3 ; c++)
+        {
+            for (size_t s = 0 ; s < 3 ; s++)
+            {
+                auto it = domain.getDomainIterator();
+                while (it.isNext())
+                {
+                    auto key = it.get();
+                    auto gkey = it.getGKey(key);
+                    double x = gkey.get(0) * domain.spacing(0);
+                    double y = gkey.get(1) * domain.spacing(1);
+                    domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+                    domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+                    domain.get<2>(key) = 0.0;
+                    ++it;
+                }
+
+                mg.setCycle(cycles[c]);
+                mg.setSmoother(smoothers[s],2,2);
+
+                double res = mg.solve<2,1>(1e-8,30);
+
+                BOOST_REQUIRE(res < 1e-8);
+                BOOST_REQUIRE(mg.getNCycles() < 30);
+
+                domain.ghost_get<2>();
+                BOOST_REQUIRE(LInfError(v, sol) < 1e-3);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_multigrid_zero_diagonal)
+    {
+        const size_t sz[2] = {33,33};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double>> domain(sz, box, ghost, bc);
+
+        auto v =  FD::getV<0>(domain);
+
+        FD::Derivative_x Dx;
+
+        // the central derivative has a zero diagonal, the smoothers cannot work with it
+        FD_multigrid<decltype(domain)> mg(domain,ghost);
+        BOOST_REQUIRE_EQUAL(mg.setOperator(Dx(v)),false);
+        BOOST_REQUIRE(mg.solve<2,1>(1e-8,30) < 0.0);
+        BOOST_REQUIRE_EQUAL(mg.getNCycles(),0ul);
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_Lap_multigrid_pc)
+    {
+        const size_t sz[2] = {129,129};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double>> domain(sz, box, ghost, bc);
+
+        auto it = domain.getDomainIterator();
+        while (it.isNext())
+        {
+            auto key = it.get();
+            auto gkey = it.getGKey(key);
+            double x = gkey.get(0) * domain.spacing(0);
+            double y = gkey.get(1) * domain.spacing(1);
+            domain.get<0>(key) = sin(M_PI*x)*sin(M_PI*y);
+            domain.get<1>(key) = -2*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y);
+            ++it;
+        }
+
+        domain.ghost_get<0>();
+        auto v =  FD::getV<0>(domain);
+        auto sol= FD::getV<2>(domain);
+
+        FD::Lap Lap;
+        FD::LInfError LInfError;
+
+        FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+        Solver.impose(Lap(v),{1,1},{127,127}, prop_id<1>());
+        Solver.impose(v,{0,0},{128,0}, prop_id<0>());
+        Solver.impose(v,{0,1},{0,127}, prop_id<0>());
+        Solver.impose(v,{0,128},{128,128}, prop_id<0>());
+        Solver.impose(v,{128,1},{128,127}, prop_id<0>());
+
+        FD_multigrid<decltype(domain)> mg(domain,ghost);
+        mg.setOperator(Lap(v));
+        BOOST_REQUIRE_EQUAL(mg.setRowMap(Solver.getMap()),true);
+
+        petsc_solver<double> pet_sol;
+        pet_sol.setSolver(KSPGMRES);
+        pet_sol.setPreconditionerShell([&](const double * r, double * z){mg.apply(r,z);});
+        Solver.solve_with_solver(pet_sol,sol);
+
+        BOOST_REQUIRE(LInfError(v, sol) < 1e-3);
+        BOOST_REQUIRE(pet_sol.getLastIterations() < 15);
+    }
+
+    BOOST_AUTO_TEST_CASE(solver_multigrid_row_map)
+    {
+        const size_t sz[2] = {65,65};
+        Box<2, double> box({0, 0}, {1, 1});
+        periodicity<2> bc = {NON_PERIODIC, NON_PERIODIC};
+        Ghost<2,long int> ghost(1);
+
+        grid_dist_id<2, double, aggregate<double,double,double>> domain(sz, box, ghost, bc);
+
+        auto v =  FD::getV<0>(domain);
+        FD::Lap Lap;
+
+        FD_scheme<equations2d1,decltype(domain)> Solver(ghost,domain);
+
+        FD_multigrid<decltype(domain)> mg(domain,ghost);
+        mg.setOperator(Lap(v));
+        mg.setSmoother(MG_GAUSS_SEIDEL,2,2);
+
+        // a numbering of the local rows that does not follow the iteration order of the grid, as the
+        // one of a scheme whose sub-domains are visited in a different order
+        grid_dist_id<2, double, aggregate<size_t>> g_perm(domain.getDecomposition(),sz,ghost);
+        size_t n = g_perm.getLocalDomainSize();
+
+        size_t cnt = 0;
+        auto it = g_perm.getDomainIterator();
+        while (it.isNext())
+        {
+            g_perm.get<0>(it.get()) = n - 1 - cnt;
+            ++cnt;
+            ++it;
+        }
+
+        // x and y on the interior points (the boundary rows are identity), in the numbering of the
+        // scheme and in the reversed one
+        auto & g_map = Solver.getMap();
+
+        size_t s_row = std::numeric_limits<size_t>::max();
+        auto it2 = g_map.getDomainIterator();
+        while (it2.isNext())
+        {
+            s_row = std::min(s_row,(size_t)g_map.get<0>(it2.get()));
+            ++it2;
+        }
+
+        auto x_val = [&](const grid_key_dx<2> & gkey) -> double
+        {
+            if (gkey.get(0) == 0 || gkey.get(1) == 0 || gkey.get(0) == 64 || gkey.get(1) == 64)
+            {return 0.0;}
+
+            return sin(0.37*(gkey.get(0) + gkey.get(1)*sz[0]));
+        };
+
+        auto y_val = [&](const grid_key_dx<2> & gkey) -> double
+        {
+            if (gkey.get(0) == 0 || gkey.get(1) == 0 || gkey.get(0) == 64 || gkey.get(1) == 64)
+            {return 0.0;}
+
+            return cos(1.13*(gkey.get(0) + gkey.get(1)*sz[0]));
+        };
+
+        std::vector<double> x(n), y(n), x_perm(n);
+
+        auto it3 = g_map.getDomainIterator();
+        while (it3.isNext())
+        {
+            auto key = it3.get();
+            x[g_map.get<0>(key) - s_row] = x_val(g_map.getGKey(key));
+            y[g_map.get<0>(key) - s_row] = y_val(g_map.getGKey(key));
+            ++it3;
+        }
+
+        auto it4 = g_perm.getDomainIterator();
+        while (it4.isNext())
+        {
+            auto key = it4.get();
+            x_perm[g_perm.get<0>(key)] = x_val(g_perm.getGKey(key));
+            ++it4;
+        }
+
+        std::vector<double> mx(n), my(n), mx_perm(n);
+
+        BOOST_REQUIRE_EQUAL(mg.setRowMap(g_map),true);
+        mg.apply(x.data(),mx.data());
+        mg.apply(y.data(),my.data());
+
+        BOOST_REQUIRE_EQUAL(mg.setRowMap(g_perm),true);
+        mg.apply(x_perm.data(),mx_perm.data());
+
+        // same result on every point in both numberings
+        std::map<size_t,double> mx_pos;
+
+        auto it5 = g_map.getDomainIterator();
+        while (it5.isNext())
+        {
+            auto key = it5.get();
+            auto gkey = g_map.getGKey(key);
+            mx_pos[gkey.get(0) + gkey.get(1)*sz[0]] = mx[g_map.get<0>(key) - s_row];
+            ++it5;
+        }
+
+        double diff = 0.0;
+        auto it6 = g_perm.getDomainIterator();
+        while (it6.isNext())
+        {
+            auto key = it6.get();
+            auto gkey = g_perm.getGKey(key);
+            diff = std::max(diff,fabs(mx_perm[g_perm.get<0>(key)] - mx_pos[gkey.get(0) + gkey.get(1)*sz[0]]));
+            ++it6;
+        }
+
+        // with the reverse color order in post-smoothing the preconditioner is symmetric (x,My) = (Mx,y)
+        double xmy = 0.0;
+        double mxy = 0.0;
+        for (size_t i = 0 ; i < n ; i++)
+        {
+            xmy += x[i]*my[i];
+            mxy += mx[i]*y[i];
+        }
+
+        auto & v_cl = create_vcluster();
+        v_cl.max(diff);
+        v_cl.sum(xmy);
+        v_cl.sum(mxy);
+        v_cl.execute();
+
+        BOOST_REQUIRE(diff < 1e-12);
+        BOOST_REQUIRE(fabs(xmy - mxy) < 1e-10 * fabs(xmy));
+
+        // a map with a different number of local points is rejected
+        const size_t sz_small[2] = {33,33};
+        grid_dist_id<2, double, aggregate<size_t>> g_small(domain.getDecomposition(),sz_small,ghost);
+        BOOST_REQUIRE_EQUAL(mg.setRowMap(g_small),false);
+    }
+
     BOOST_AUTO_TEST_CASE(solver_Lap_stag)
     {
         const size_t sz[2] = {82,82};
@@ -0,0 +1,1388 @@
+/*
+ * FD_multigrid.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef OPENFPM_NUMERICS_SRC_FINITEDIFFERENCE_FD_MULTIGRID_HPP_
+#define OPENFPM_NUMERICS_SRC_FINITEDIFFERENCE_FD_MULTIGRID_HPP_
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "Grid/grid_dist_id.hpp"
+#include "Matrix/SparseMatrix_assembly.hpp"
+
+//! Multigrid cycle
+enum mg_cycle
+{
+	MG_V_CYCLE,
+	MG_W_CYCLE,
+	MG_F_CYCLE
+};
+
+//! Multigrid smoother
+enum mg_smoother
+{
+	MG_JACOBI,
+	MG_GAUSS_SEIDEL,
+	MG_CHEBYSHEV
+};
+
+/*! \brief Geometric multigrid for constant coefficient Finite Difference operators on grid_dist_id
+ *
+ * The levels are grid_dist_id that share the decomposition of the grid of the problem, every level
+ * has half of the points in each direction (a non periodic direction with N points has (N-1)/2+1
+ * points on the coarser level, so sizes like 2^k+1 give the deepest hierarchy, a periodic one N/2).
+ * The stencil of the finest level is extracted from an operator of FD_op.hpp with the same value_nz
+ * used by FD_scheme, the coarser operators are the Galerkin products R A P with full-weighting
+ * restriction R and (multi)linear prolongation P. The points on non periodic boundaries are
+ * Dirichlet points, their value is not changed.
+ *
+ * Smoothers are weighted Jacobi, red-black Gauss-Seidel and Chebyshev, every application of the
+ * stencil is preceded by a ghost exchange of the level.
+ *
+ * It can be used standalone
+ *
+ * \verbatim
+   FD_multigrid<decltype(domain)> mg(domain,ghost);
+   auto v = FD::getV<0>(domain);
+   mg.setOperator(Lap(v));
+   mg.solve<0,1>(1e-8,100);
+ * \endverbatim
+ *
+ * or as preconditioner of petsc_solver for the systems produced by FD_scheme with the same
+ * operator in the bulk and v = value on the boundary
+ *
+ * \verbatim
+   mg.setRowMap(fd.getMap());
+   pet_sol.setPreconditionerShell([&](const double * r, double * z){mg.apply(r,z);});
+ * \endverbatim
+ *
+ * \tparam grid_type grid of the problem
+ *
+ */
+template<typename grid_type>
+class FD_multigrid
+{
+	//! dimensionality
+	static const unsigned int dims = grid_type::dims;
+
+	//! type of the coefficients
+	typedef typename grid_type::stype St;
+
+	//! solution, right-hand-side, residual, work, mask (0 boundary, 1 red, 2 black)
+	typedef grid_dist_id<dims,St,aggregate<St,St,St,St,St>,typename grid_type::decomposition> level_grid;
+
+	//! properties of the levels
+	static const unsigned int U = 0;
+	static const unsigned int F = 1;
+	static const unsigned int R = 2;
+	static const unsigned int D = 3;
+	static const unsigned int MASK = 4;
+
+	//! stencil (offset, coefficient)
+	typedef std::vector<std::pair<grid_key_dx<dims>,St>> stencil_type;
+
+	//! System of equations used to extract the stencil with value_nz
+	struct mg_sys_eqs
+	{
+		static const unsigned int dims = grid_type::dims;
+		static const unsigned int nvar = 1;
+		typedef typename grid_type::stype stype;
+	};
+
+	//! one level of the hierarchy
+	struct mg_level
+	{
+		//! grid of the level
+		std::unique_ptr<level_grid> g;
+
+		//! stencil of the operator
+		stencil_type stencil;
+
+		//! diagonal of the operator
+		St diag = 0;
+
+		//! largest eigenvalue of D^-1 A
+		St lmax = 0;
+
+		//! origin of the local grids
+		std::vector<grid_key_dx<dims>> origin;
+
+		//! for each local grid, the local grid of the finer level that contain it
+		std::vector<int> sub_f;
+
+		//! for each local grid, the local grid of the coarser level that contain it
+		std::vector<int> sub_c;
+	};
+
+	//! grid of the problem
+	grid_type & grid;
+
+	//! ghost (extension of the stencil)
+	Ghost<dims,long int> stencil_ghost;
+
+	//! levels, 0 is the finest
+	std::vector<mg_level> levels;
+
+	//! full-weighting restriction
+	stencil_type fw;
+
+	//! cycle type
+	mg_cycle cyc = MG_V_CYCLE;
+
+	//! smoother
+	mg_smoother smoother = MG_GAUSS_SEIDEL;
+
+	//! pre-smoothing sweeps
+	size_t n_pre = 2;
+
+	//! post-smoothing sweeps
+	size_t n_post = 2;
+
+	//! sweeps on the coarsest level
+	size_t n_coarse = 50;
+
+	//! weight of the Jacobi smoother
+	St omega = 2.0/3.0;
+
+	//! number of cycles of the last solve
+	size_t n_cycles = 0;
+
+	//! indicate if a valid operator has been set
+	bool op_set = false;
+
+	//! for each point of the finest level (in iteration order), its local row in the vectors of FD_scheme
+	std::vector<size_t> row_map;
+
+	/*! \brief Call f for every offset in [-r,r]^dims
+	 *
+	 * \param r radius
+	 * \param f functor
+	 *
+	 */
+	template<typename lambda_type>
+	static void for_each_offset(long int r, lambda_type f)
+	{
+		grid_key_dx<dims> o;
+
+		for (size_t d = 0 ; d < dims ; d++)
+		{o.set_d(d,-r);}
+
+		while (true)
+		{
+			f(o);
+
+			size_t d = 0;
+			for ( ; d < dims ; d++)
+			{
+				if (o.get(d) < r)
+				{
+					o.set_d(d,o.get(d)+1);
+					break;
+				}
+
+				o.set_d(d,-r);
+			}
+
+			if (d == dims)
+			{break;}
+		}
+	}
+
+	/*! \brief Index of an offset in a dense array of radius r
+	 *
+	 * \param o offset
+	 * \param r radius
+	 *
+	 * \return the index
+	 *
+	 */
+	static size_t dense_id(const grid_key_dx<dims> & o, long int r)
+	{
+		size_t id = 0;
+		size_t str = 1;
+
+		for (size_t d = 0 ; d < dims ; d++)
+		{
+			id += (o.get(d) + r) * str;
+			str *= 2*r+1;
+		}
+
+		return id;
+	}
+
+	/*! \brief Check if a direction is periodic
+	 *
+	 * \param d direction
+	 *
+	 * \return true if periodic
+	 *
+	 */
+	bool is_periodic(size_t d)
+	{
+		return grid.getDecomposition().periodicity()[d] == true;
+	}
+
+	/*! \brief Create a level with a given size
+	 *
+	 * \param sz size of the level
+	 *
+	 */
+	void add_level(const size_t (& sz)[dims])
+	{
+		levels.push_back(mg_level());
+		mg_level & lv = levels.back();
+
+		lv.g.reset(new level_grid(grid.getDecomposition(),sz,stencil_ghost));
+
+		auto & gdb_ext = lv.g->getLocalGridsInfo();
+		lv.origin.resize(gdb_ext.size());
+
+		for (size_t i = 0 ; i < gdb_ext.size() ; i++)
+		{
+			for (size_t d = 0 ; d < dims ; d++)
+			{lv.origin[i].set_d(d,gdb_ext.get(i).origin[d]);}
+		}
+
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+			auto gkey = lv.g->getGKey(key);
+
+			bool bnd = false;
+			long int parity = 0;
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{
+				if (is_periodic(d) == false && (gkey.get(d) == 0 || gkey.get(d) == (long int)sz[d] - 1))
+				{bnd = true;}
+
+				parity += gkey.get(d);
+			}
+
+			lv.g->template get<U>(key) = 0.0;
+			lv.g->template get<F>(key) = 0.0;
+			lv.g->template get<R>(key) = 0.0;
+			lv.g->template get<D>(key) = 0.0;
+			lv.g->template get<MASK>(key) = (bnd == true)?0.0:(1.0 + (parity % 2));
+
+			++it;
+		}
+	}
+
+	/*! \brief Find the local grid that contain a point
+	 *
+	 * \param lv level
+	 * \param gp point in global coordinates
+	 *
+	 * \return the local grid containing the point in its domain, or in its ghost, -1 if none
+	 *
+	 */
+	int find_sub(mg_level & lv, const grid_key_dx<dims> & gp)
+	{
+		auto & gdb_ext = lv.g->getLocalGridsInfo();
+
+		for (int ghost = 0 ; ghost < 2 ; ghost++)
+		{
+			for (size_t i = 0 ; i < gdb_ext.size() ; i++)
+			{
+				auto & bx = (ghost == 0)?gdb_ext.get(i).Dbox:gdb_ext.get(i).GDbox;
+
+				bool inside = true;
+				for (size_t d = 0 ; d < dims ; d++)
+				{
+					long int x = gp.get(d) - lv.origin[i].get(d);
+
+					if (x < bx.getLow(d) || x > bx.getHigh(d))
+					{inside = false;}
+				}
+
+				if (inside == true)
+				{return i;}
+			}
+		}
+
+		return -1;
+	}
+
+	/*! \brief Connect the local grids of the level l with the ones of the level l+1
+	 *
+	 * \param l level
+	 *
+	 * \return false if on some processor a local grid does not have a corresponding local grid
+	 *
+	 */
+	bool link_levels(size_t l)
+	{
+		mg_level & fine = levels[l];
+		mg_level & coarse = levels[l+1];
+
+		size_t fail = 0;
+
+		auto & gdb_f = fine.g->getLocalGridsInfo();
+		fine.sub_c.resize(gdb_f.size());
+
+		for (size_t i = 0 ; i < gdb_f.size() ; i++)
+		{
+			grid_key_dx<dims> gp;
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{gp.set_d(d,(gdb_f.get(i).Dbox.getLow(d) + fine.origin[i].get(d)) / 2);}
+
+			fine.sub_c[i] = find_sub(coarse,gp);
+			fail += (fine.sub_c[i] == -1);
+		}
+
+		auto & gdb_c = coarse.g->getLocalGridsInfo();
+		coarse.sub_f.resize(gdb_c.size());
+
+		for (size_t i = 0 ; i < gdb_c.size() ; i++)
+		{
+			grid_key_dx<dims> gp;
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{gp.set_d(d,2*(gdb_c.get(i).Dbox.getLow(d) + coarse.origin[i].get(d)));}
+
+			coarse.sub_f[i] = find_sub(fine,gp);
+			fail += (coarse.sub_f[i] == -1);
+		}
+
+		auto & v_cl = create_vcluster();
+		v_cl.max(fail);
+		v_cl.execute();
+
+		return fail == 0;
+	}
+
+	/*! \brief Galerkin coarse stencil R A P
+	 *
+	 * \param fine stencil of the fine level
+	 * \param coarse stencil of the coarse level
+	 *
+	 */
+	void galerkin(const stencil_type & fine, stencil_type & coarse)
+	{
+		long int rf = 0;
+		St norm = 0;
+
+		for (size_t i = 0 ; i < fine.size() ; i++)
+		{
+			for (size_t d = 0 ; d < dims ; d++)
+			{rf = std::max(rf,std::abs(fine[i].first.get(d)));}
+
+			norm = std::max(norm,std::fabs(fine[i].second));
+		}
+
+		long int rc = (rf + 2) / 2;
+		long int hf = 2*rc + 1;
+		long int h = hf + rf;
+
+		size_t n = 1;
+		for (size_t d = 0 ; d < dims ; d++)
+		{n *= 2*h+1;}
+
+		std::vector<St> e(n,0.0);
+		std::vector<St> ae(n,0.0);
+
+		// prolongation of a coarse delta in zero
+		for_each_offset(1,[&](const grid_key_dx<dims> & o)
+		{
+			St w = 1.0;
+			for (size_t d = 0 ; d < dims ; d++)
+			{w *= (o.get(d) == 0)?1.0:0.5;}
+
+			e[dense_id(o,h)] = w;
+		});
+
+		for_each_offset(hf,[&](const grid_key_dx<dims> & x)
+		{
+			St s = 0.0;
+			for (size_t i = 0 ; i < fine.size() ; i++)
+			{s += fine[i].second * e[dense_id(x + fine[i].first,h)];}
+
+			ae[dense_id(x,h)] = s;
+		});
+
+		coarse.clear();
+
+		for_each_offset(rc,[&](const grid_key_dx<dims> & J)
+		{
+			grid_key_dx<dims> J2;
+			for (size_t d = 0 ; d < dims ; d++)
+			{J2.set_d(d,2*J.get(d));}
+
+			St s = 0.0;
+			for (size_t i = 0 ; i < fw.size() ; i++)
+			{s += fw[i].second * ae[dense_id(J2 + fw[i].first,h)];}
+
+			// the row J has the coefficient s on the colum 0, so the offset is -J
+			if (std::fabs(s) > 1e-12 * norm)
+			{
+				grid_key_dx<dims> mJ;
+				for (size_t d = 0 ; d < dims ; d++)
+				{mJ.set_d(d,-J.get(d));}
+
+				coarse.push_back(std::make_pair(mJ,s));
+			}
+		});
+	}
+
+	/*! \brief Apply the stencil of the level on the property prp
+	 *
+	 * \param lv level
+	 * \param key point
+	 *
+	 * \return the operator applied on the point
+	 *
+	 */
+	template<unsigned int prp>
+	inline St apply_stencil(mg_level & lv, const grid_dist_key_dx<dims> & key)
+	{
+		St s = 0.0;
+
+		for (size_t i = 0 ; i < lv.stencil.size() ; i++)
+		{
+			grid_dist_key_dx<dims> kn(key.getSub(),key.getKey() + lv.stencil[i].first);
+			s += lv.stencil[i].second * lv.g->template get<prp>(kn);
+		}
+
+		return s;
+	}
+
+	/*! \brief Calculate the residual f - A u on a level (zero on the boundary)
+	 *
+	 * \param l level
+	 *
+	 */
+	void residual(size_t l)
+	{
+		mg_level & lv = levels[l];
+
+		lv.g->template ghost_get<U>();
+
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			if (lv.g->template get<MASK>(key) != 0.0)
+			{lv.g->template get<R>(key) = lv.g->template get<F>(key) - apply_stencil<U>(lv,key);}
+			else
+			{lv.g->template get<R>(key) = 0.0;}
+
+			++it;
+		}
+	}
+
+	/*! \brief Norm 2 of the residual of a level
+	 *
+	 * \param l level
+	 *
+	 * \return the norm
+	 *
+	 */
+	St residual_norm(size_t l)
+	{
+		mg_level & lv = levels[l];
+
+		residual(l);
+
+		St sum = 0.0;
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			sum += lv.g->template get<R>(key) * lv.g->template get<R>(key);
+
+			++it;
+		}
+
+		auto & v_cl = create_vcluster();
+		v_cl.sum(sum);
+		v_cl.execute();
+
+		return sqrt(sum);
+	}
+
+	/*! \brief Estimate the largest eigenvalue of D^-1 A on a level with power iterations
+	 *
+	 * \param l level
+	 *
+	 */
+	void estimate_lmax(size_t l)
+	{
+		mg_level & lv = levels[l];
+		auto & v_cl = create_vcluster();
+
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+			auto gkey = lv.g->getGKey(key);
+
+			// not constant start vector, to not be orthogonal to the largest eigenvector
+			St v = 1.0;
+			for (size_t d = 0 ; d < dims ; d++)
+			{v += 0.1 * ((gkey.get(d) * 7 + 3) % 11);}
+
+			lv.g->template get<D>(key) = (lv.g->template get<MASK>(key) != 0.0)?v:0.0;
+
+			++it;
+		}
+
+		St lambda = 0.0;
+
+		for (size_t k = 0 ; k < 15 ; k++)
+		{
+			lv.g->template ghost_get<D>();
+
+			St nd = 0.0;
+			St nr = 0.0;
+
+			auto it = lv.g->getDomainIterator();
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+
+				St r = 0.0;
+				if (lv.g->template get<MASK>(key) != 0.0)
+				{r = apply_stencil<D>(lv,key) / lv.diag;}
+
+				lv.g->template get<R>(key) = r;
+
+				nd += lv.g->template get<D>(key) * lv.g->template get<D>(key);
+				nr += r*r;
+
+				++it;
+			}
+
+			v_cl.sum(nd);
+			v_cl.sum(nr);
+			v_cl.execute();
+
+			if (nd == 0.0 || nr == 0.0)
+			{break;}
+
+			lambda = sqrt(nr / nd);
+
+			auto it2 = lv.g->getDomainIterator();
+
+			while (it2.isNext())
+			{
+				auto key = it2.get();
+
+				lv.g->template get<D>(key) = lv.g->template get<R>(key) / sqrt(nr);
+
+				++it2;
+			}
+		}
+
+		lv.lmax = lambda;
+	}
+
+	/*! \brief Weighted Jacobi sweeps
+	 *
+	 * \param l level
+	 * \param n number of sweeps
+	 *
+	 */
+	void smooth_jacobi(size_t l, size_t n)
+	{
+		mg_level & lv = levels[l];
+
+		for (size_t k = 0 ; k < n ; k++)
+		{
+			residual(l);
+
+			auto it = lv.g->getDomainIterator();
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+
+				lv.g->template get<U>(key) += omega * lv.g->template get<R>(key) / lv.diag;
+
+				++it;
+			}
+		}
+	}
+
+	/*! \brief Red-black Gauss-Seidel sweeps
+	 *
+	 * The ghost are exchanged before each color. The post-smoothing use the reverse color order
+	 * (black then red) of the pre-smoothing, so that the cycle is a symmetric preconditioner
+	 *
+	 * \param l level
+	 * \param n number of sweeps
+	 * \param reverse true to update the black points before the red ones
+	 *
+	 */
+	void smooth_gauss_seidel(size_t l, size_t n, bool reverse = false)
+	{
+		mg_level & lv = levels[l];
+
+		for (size_t k = 0 ; k < n ; k++)
+		{
+			for (int c = 1 ; c <= 2 ; c++)
+			{
+				int color = (reverse == true)?3-c:c;
+
+				lv.g->template ghost_get<U>();
+
+				auto it = lv.g->getDomainIterator();
+
+				while (it.isNext())
+				{
+					auto key = it.get();
+
+					if (lv.g->template get<MASK>(key) == color)
+					{lv.g->template get<U>(key) += (lv.g->template get<F>(key) - apply_stencil<U>(lv,key)) / lv.diag;}
+
+					++it;
+				}
+			}
+		}
+	}
+
+	/*! \brief Chebyshev smoother of degree n on D^-1 A
+	 *
+	 * It damp the eigenvalues in [0.1 lmax, 1.1 lmax]
+	 *
+	 * \param l level
+	 * \param n degree
+	 *
+	 */
+	void smooth_chebyshev(size_t l, size_t n)
+	{
+		mg_level & lv = levels[l];
+
+		if (n == 0)
+		{return;}
+
+		St lmax = 1.1 * lv.lmax;
+		St lmin = 0.1 * lv.lmax;
+		St theta = 0.5 * (lmax + lmin);
+		St delta = 0.5 * (lmax - lmin);
+		St sigma = theta / delta;
+		St rho = 1.0 / sigma;
+
+		residual(l);
+
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			lv.g->template get<D>(key) = lv.g->template get<R>(key) / (lv.diag * theta);
+
+			++it;
+		}
+
+		for (size_t k = 0 ; k < n ; k++)
+		{
+			auto it = lv.g->getDomainIterator();
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+
+				lv.g->template get<U>(key) += lv.g->template get<D>(key);
+
+				++it;
+			}
+
+			if (k == n - 1)
+			{break;}
+
+			residual(l);
+
+			St rho_new = 1.0 / (2.0 * sigma - rho);
+
+			auto it2 = lv.g->getDomainIterator();
+
+			while (it2.isNext())
+			{
+				auto key = it2.get();
+
+				lv.g->template get<D>(key) = rho_new * rho * lv.g->template get<D>(key) +
+				                             2.0 * rho_new / delta * lv.g->template get<R>(key) / lv.diag;
+
+				++it2;
+			}
+
+			rho = rho_new;
+		}
+	}
+
+	/*! \brief Apply the smoother
+	 *
+	 * \param l level
+	 * \param n number of sweeps
+	 * \param post true for the post-smoothing
+	 *
+	 */
+	void smooth(size_t l, size_t n, bool post)
+	{
+		if (smoother == MG_JACOBI)
+		{smooth_jacobi(l,n);}
+		else if (smoother == MG_GAUSS_SEIDEL)
+		{smooth_gauss_seidel(l,n,post);}
+		else
+		{smooth_chebyshev(l,n);}
+	}
+
+	/*! \brief Restrict the residual of the level l into the right-hand-side of the level l+1
+	 *
+	 * The solution of the level l+1 is set to zero
+	 *
+	 * \param l level
+	 *
+	 */
+	void restrict_residual(size_t l)
+	{
+		mg_level & fine = levels[l];
+		mg_level & coarse = levels[l+1];
+
+		fine.g->template ghost_get<R>();
+
+		auto it = coarse.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+			size_t i = key.getSub();
+			int j = coarse.sub_f[i];
+
+			coarse.g->template get<U>(key) = 0.0;
+
+			if (coarse.g->template get<MASK>(key) == 0.0)
+			{
+				coarse.g->template get<F>(key) = 0.0;
+
+				++it;
+				continue;
+			}
+
+			grid_key_dx<dims> kf;
+			for (size_t d = 0 ; d < dims ; d++)
+			{kf.set_d(d,2*(key.getKey().get(d) + coarse.origin[i].get(d)) - fine.origin[j].get(d));}
+
+			St s = 0.0;
+			for (size_t k = 0 ; k < fw.size() ; k++)
+			{
+				grid_dist_key_dx<dims> kn(j,kf + fw[k].first);
+				s += fw[k].second * fine.g->template get<R>(kn);
+			}
+
+			coarse.g->template get<F>(key) = s;
+
+			++it;
+		}
+	}
+
+	/*! \brief Interpolate the solution of the level l+1 and add it to the solution of the level l
+	 *
+	 * \param l level
+	 *
+	 */
+	void prolongate_correction(size_t l)
+	{
+		mg_level & fine = levels[l];
+		mg_level & coarse = levels[l+1];
+
+		coarse.g->template ghost_get<U>();
+
+		auto it = fine.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			if (fine.g->template get<MASK>(key) == 0.0)
+			{
+				++it;
+				continue;
+			}
+
+			size_t i = key.getSub();
+			int j = fine.sub_c[i];
+
+			grid_key_dx<dims> kc;
+			long int odd[dims];
+			size_t n_odd = 0;
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{
+				long int gf = key.getKey().get(d) + fine.origin[i].get(d);
+
+				odd[d] = gf % 2;
+				n_odd += odd[d];
+				kc.set_d(d,gf / 2 - coarse.origin[j].get(d));
+			}
+
+			St s = 0.0;
+
+			for_each_offset(1,[&](const grid_key_dx<dims> & c)
+			{
+				for (size_t d = 0 ; d < dims ; d++)
+				{
+					if (c.get(d) < 0 || c.get(d) > odd[d])
+					{return;}
+				}
+
+				grid_dist_key_dx<dims> kn(j,kc + c);
+				s += coarse.g->template get<U>(kn);
+			});
+
+			fine.g->template get<U>(key) += s / (1 << n_odd);
+
+			++it;
+		}
+	}
+
+	/*! \brief Multigrid cycle starting from the level l
+	 *
+	 * \param l level
+	 * \param type cycle type
+	 *
+	 */
+	void cycle(size_t l, mg_cycle type)
+	{
+		if (l == levels.size() - 1)
+		{
+			// forward then backward sweeps, symmetric like the rest of the cycle
+			smooth_gauss_seidel(l,(n_coarse + 1) / 2,false);
+			smooth_gauss_seidel(l,(n_coarse + 1) / 2,true);
+			return;
+		}
+
+		smooth(l,n_pre,false);
+
+		residual(l);
+		restrict_residual(l);
+
+		if (type == MG_V_CYCLE)
+		{cycle(l+1,MG_V_CYCLE);}
+		else if (type == MG_W_CYCLE)
+		{
+			cycle(l+1,MG_W_CYCLE);
+			cycle(l+1,MG_W_CYCLE);
+		}
+		else
+		{
+			cycle(l+1,MG_F_CYCLE);
+			cycle(l+1,MG_V_CYCLE);
+		}
+
+		prolongate_correction(l);
+
+		smooth(l,n_post,true);
+	}
+
+public:
+
+	/*! \brief Constructor, it create the hierarchy of levels
+	 *
+	 * \param g grid of the problem
+	 * \param stencil maximum extension of the stencil on each directions
+	 * \param max_levels maximum number of levels
+	 *
+	 */
+	FD_multigrid(grid_type & g, const Ghost<dims,long int> & stencil, size_t max_levels = 20)
+	:grid(g),stencil_ghost(stencil)
+	{
+		for_each_offset(1,[&](const grid_key_dx<dims> & o)
+		{
+			St w = 1.0;
+			for (size_t d = 0 ; d < dims ; d++)
+			{w *= (o.get(d) == 0)?0.5:0.25;}
+
+			fw.push_back(std::make_pair(o,w));
+		});
+
+		size_t sz[dims];
+
+		for (size_t d = 0 ; d < dims ; d++)
+		{sz[d] = g.size(d);}
+
+		add_level(sz);
+
+		while (levels.size() < max_levels)
+		{
+			size_t sz_c[dims];
+			bool coarsen = true;
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{
+				if (is_periodic(d) == true)
+				{
+					coarsen &= (sz[d] % 2 == 0 && sz[d] / 2 >= 4);
+					sz_c[d] = sz[d] / 2;
+				}
+				else
+				{
+					coarsen &= ((sz[d] - 1) % 2 == 0 && (sz[d] - 1) / 2 >= 2);
+					sz_c[d] = (sz[d] - 1) / 2 + 1;
+				}
+			}
+
+			if (coarsen == false)
+			{break;}
+
+			add_level(sz_c);
+
+			if (link_levels(levels.size() - 2) == false)
+			{
+				levels.pop_back();
+				break;
+			}
+
+			for (size_t d = 0 ; d < dims ; d++)
+			{sz[d] = sz_c[d];}
+		}
+	}
+
+	/*! \brief Set the operator of the finest level and build the operators of the coarser levels
+	 *
+	 * The operator must have constant coefficients, its stencil is extracted on a point not on
+	 * the boundary. If a processor does not have such point or the operator has a zero diagonal
+	 * on some level the operator is rejected on all the processors, solve and apply refuse to
+	 * work until a valid operator is set
+	 *
+	 * \param op operator (FD_op.hpp expression on the grid of the problem)
+	 *
+	 * \return true if the operator has been set
+	 *
+	 */
+	template<typename T>
+	bool setOperator(const T & op)
+	{
+		typedef grid_dist_id<dims,St,aggregate<size_t>,typename grid_type::decomposition::extended_type> g_map_type;
+
+		op_set = false;
+
+		Padding<dims> pd;
+		g_map_type g_map(grid,stencil_ghost,pd);
+		const grid_sm<dims,void> & gs = g_map.getGridInfoVoid();
+
+		auto it = g_map.getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			g_map.template get<0>(key) = gs.LinId(g_map.getGKey(key));
+
+			++it;
+		}
+
+		g_map.template ghost_get<0>();
+
+		St spacing[dims];
+		for (size_t d = 0 ; d < dims ; d++)
+		{spacing[d] = grid.spacing(d);}
+
+		stencil_type & st = levels[0].stencil;
+		st.clear();
+
+		auto it2 = g_map.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+			auto gkey = g_map.getGKey(key);
+
+			bool bnd = false;
+			for (size_t d = 0 ; d < dims ; d++)
+			{
+				if (is_periodic(d) == false && (gkey.get(d) == 0 || gkey.get(d) == (long int)gs.size(d) - 1))
+				{bnd = true;}
+			}
+
+			if (bnd == true)
+			{
+				++it2;
+				continue;
+			}
+
+			sparse_row_accumulator<St> cols;
+			comb<dims> c_where;
+			c_where.zero();
+
+			op.template value_nz<mg_sys_eqs>(g_map,key,gs,spacing,cols,1.0,0,c_where);
+
+			for (auto c = cols.begin() ; c != cols.end() ; ++c)
+			{
+				grid_key_dx<dims> gcol = gs.InvLinId(c->first);
+				grid_key_dx<dims> off;
+
+				for (size_t d = 0 ; d < dims ; d++)
+				{
+					long int o = gcol.get(d) - gkey.get(d);
+
+					// periodic wrap
+					if (o > (long int)gs.size(d) / 2)
+					{o -= gs.size(d);}
+					else if (o < -(long int)gs.size(d) / 2)
+					{o += gs.size(d);}
+
+					off.set_d(d,o);
+				}
+
+				st.push_back(std::make_pair(off,c->second));
+			}
+
+			break;
+		}
+
+		// the decision must be the same on all processors
+		Vcluster<> & v_cl = create_vcluster();
+
+		size_t no_stencil = (st.size() == 0);
+		v_cl.sum(no_stencil);
+		v_cl.execute();
+
+		if (no_stencil != 0)
+		{
+			if (st.size() == 0)
+			{std::cerr << __FILE__ << ":" << __LINE__ << " Error the processor does not have any point not on the boundary to extract the stencil" << std::endl;}
+
+			return false;
+		}
+
+		for (size_t l = 0 ; l < levels.size() ; l++)
+		{
+			if (l != 0)
+			{galerkin(levels[l-1].stencil,levels[l].stencil);}
+
+			levels[l].diag = 0.0;
+			for (size_t i = 0 ; i < levels[l].stencil.size() ; i++)
+			{
+				bool zero = true;
+				for (size_t d = 0 ; d < dims ; d++)
+				{zero &= (levels[l].stencil[i].first.get(d) == 0);}
+
+				if (zero == true)
+				{levels[l].diag += levels[l].stencil[i].second;}
+			}
+
+			if (levels[l].diag == 0.0)
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " Error the operator has a zero diagonal on the level " << l << std::endl;
+				return false;
+			}
+
+			estimate_lmax(l);
+		}
+
+		op_set = true;
+
+		return true;
+	}
+
+	/*! \brief Set the map between the points of the grid and the rows of the FD_scheme vectors
+	 *
+	 * It is needed by apply. The local rows are taken from the map of the FD_scheme (FD_scheme::getMap)
+	 * through the global position of the points, so the numbering of the scheme does not have to follow
+	 * the iteration order of the levels (for example with several sub-domains for processor). The
+	 * scheme must have one variable. If the map does not cover the local points of the finest level
+	 * (different local size, or padding) it is rejected on all the processors
+	 *
+	 * \param g_map map of the FD_scheme, for every point its global row
+	 *
+	 * \return true if the map has been set
+	 *
+	 */
+	template<typename g_map_type>
+	bool setRowMap(const g_map_type & g_map)
+	{
+		mg_level & lv = levels[0];
+		const grid_sm<dims,void> & gs = lv.g->getGridInfoVoid();
+
+		row_map.clear();
+
+		size_t failed = 0;
+
+		if (g_map.getLocalDomainSize() != lv.g->getLocalDomainSize())
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error the map has " << g_map.getLocalDomainSize() << " local points but the grid has " << lv.g->getLocalDomainSize() << std::endl;
+			failed = 1;
+		}
+		else
+		{
+			// (global linear id, row) of the points of the map
+			std::vector<std::pair<size_t,size_t>> rows;
+			size_t s_row = std::numeric_limits<size_t>::max();
+
+			auto it = g_map.getDomainIterator();
+
+			while (it.isNext())
+			{
+				auto key = it.get();
+				size_t r = g_map.template get<0>(key);
+
+				rows.push_back(std::make_pair(gs.LinId(g_map.getGKey(key)),r));
+				s_row = std::min(s_row,r);
+
+				++it;
+			}
+
+			std::sort(rows.begin(),rows.end());
+
+			auto it2 = lv.g->getDomainIterator();
+
+			while (it2.isNext())
+			{
+				size_t lin = gs.LinId(lv.g->getGKey(it2.get()));
+				auto pos = std::lower_bound(rows.begin(),rows.end(),std::make_pair(lin,(size_t)0));
+
+				if (pos == rows.end() || pos->first != lin)
+				{
+					std::cerr << __FILE__ << ":" << __LINE__ << " Error the point " << lv.g->getGKey(it2.get()).to_string() << " is not in the map" << std::endl;
+					failed = 1;
+					break;
+				}
+
+				row_map.push_back(pos->second - s_row);
+
+				++it2;
+			}
+		}
+
+		// the decision must be the same on all processors
+		Vcluster<> & v_cl = create_vcluster();
+
+		v_cl.sum(failed);
+		v_cl.execute();
+
+		if (failed != 0)
+		{
+			row_map.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	/*! \brief Set the type of cycle
+	 *
+	 * \param type MG_V_CYCLE, MG_W_CYCLE or MG_F_CYCLE
+	 *
+	 */
+	void setCycle(mg_cycle type)
+	{
+		cyc = type;
+	}
+
+	/*! \brief Set the smoother
+	 *
+	 * \param type MG_JACOBI, MG_GAUSS_SEIDEL or MG_CHEBYSHEV
+	 * \param pre pre-smoothing sweeps (degree of the polynomial for Chebyshev)
+	 * \param post post-smoothing sweeps (degree of the polynomial for Chebyshev)
+	 *
+	 */
+	void setSmoother(mg_smoother type, size_t pre = 2, size_t post = 2)
+	{
+		smoother = type;
+		n_pre = pre;
+		n_post = post;
+	}
+
+	/*! \brief Set the weight of the Jacobi smoother
+	 *
+	 * \param w weight
+	 *
+	 */
+	void setJacobiWeight(St w)
+	{
+		omega = w;
+	}
+
+	/*! \brief Set the number of Gauss-Seidel sweeps on the coarsest level
+	 *
+	 * \param n number of sweeps
+	 *
+	 */
+	void setCoarseSweeps(size_t n)
+	{
+		n_coarse = n;
+	}
+
+	/*! \brief Get the number of levels
+	 *
+	 * \return the number of levels
+	 *
+	 */
+	size_t getNLevels() const
+	{
+		return levels.size();
+	}
+
+	/*! \brief Get the stencil of a level
+	 *
+	 * \param l level
+	 *
+	 * \return the (offset, coefficient) pairs of the stencil
+	 *
+	 */
+	const stencil_type & getStencil(size_t l) const
+	{
+		return levels[l].stencil;
+	}
+
+	/*! \brief Get the number of cycles of the last solve
+	 *
+	 * \return the number of cycles
+	 *
+	 */
+	size_t getNCycles() const
+	{
+		return n_cycles;
+	}
+
+	/*! \brief Solve the system with multigrid cycles
+	 *
+	 * \tparam prp_u property of the grid with the initial guess and the boundary values,
+	 *         it contain the solution at the end
+	 * \tparam prp_f property of the grid with the right-hand-side
+	 *
+	 * \param tol relative tolerance on the norm 2 of the residual
+	 * \param max_cycles maximum number of cycles
+	 *
+	 * \return the relative residual reached, -1 if no valid operator has been set
+	 *
+	 */
+	template<unsigned int prp_u, unsigned int prp_f>
+	St solve(St tol = 1e-8, size_t max_cycles = 100)
+	{
+		if (op_set == false)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error no valid operator has been set, call setOperator first" << std::endl;
+			return -1.0;
+		}
+
+		mg_level & lv = levels[0];
+
+		auto it_g = grid.getDomainIterator();
+		auto it_l = lv.g->getDomainIterator();
+
+		while (it_g.isNext())
+		{
+			auto key_g = it_g.get();
+			auto key_l = it_l.get();
+
+			lv.g->template get<U>(key_l) = grid.template get<prp_u>(key_g);
+			lv.g->template get<F>(key_l) = grid.template get<prp_f>(key_g);
+
+			++it_g;
+			++it_l;
+		}
+
+		St r0 = residual_norm(0);
+		St res = r0;
+
+		n_cycles = 0;
+
+		while (n_cycles < max_cycles && res > tol * r0)
+		{
+			cycle(0,cyc);
+			n_cycles++;
+
+			res = residual_norm(0);
+		}
+
+		auto it_g2 = grid.getDomainIterator();
+		auto it_l2 = lv.g->getDomainIterator();
+
+		while (it_g2.isNext())
+		{
+			auto key_g = it_g2.get();
+			auto key_l = it_l2.get();
+
+			grid.template get<prp_u>(key_g) = lv.g->template get<U>(key_l);
+
+			++it_g2;
+			++it_l2;
+		}
+
+		return (r0 == 0.0)?0.0:res / r0;
+	}
+
+	/*! \brief Apply one cycle as preconditioner z = M^-1 r
+	 *
+	 * The vectors are the local part of the vectors of FD_scheme, indexed with the map set by
+	 * setRowMap. The boundary rows are considered identity rows. Without a valid operator or
+	 * a map z = r. With the Gauss-Seidel smoother and the same number of pre and post sweeps the
+	 * preconditioner is symmetric and can be used with CG
+	 *
+	 * \param r residual
+	 * \param z preconditioned residual
+	 *
+	 */
+	void apply(const St * r, St * z)
+	{
+		mg_level & lv = levels[0];
+
+		if (op_set == false || row_map.size() != lv.g->getLocalDomainSize())
+		{
+			if (op_set == false)
+			{std::cerr << __FILE__ << ":" << __LINE__ << " Error no valid operator has been set, call setOperator first" << std::endl;}
+			else
+			{std::cerr << __FILE__ << ":" << __LINE__ << " Error no valid map of the rows has been set, call setRowMap first" << std::endl;}
+
+			std::copy(r,r + lv.g->getLocalDomainSize(),z);
+			return;
+		}
+
+		size_t k = 0;
+		auto it = lv.g->getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			if (lv.g->template get<MASK>(key) == 0.0)
+			{
+				lv.g->template get<U>(key) = r[row_map[k]];
+				lv.g->template get<F>(key) = 0.0;
+			}
+			else
+			{
+				lv.g->template get<U>(key) = 0.0;
+				lv.g->template get<F>(key) = r[row_map[k]];
+			}
+
+			++k;
+			++it;
+		}
+
+		cycle(0,cyc);
+
+		k = 0;
+		auto it2 = lv.g->getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			z[row_map[k]] = lv.g->template get<U>(key);
+
+			++k;
+			++it2;
+		}
+	}
+};
+
+#endif /* OPENFPM_NUMERICS_SRC_FINITEDIFFERENCE_FD_MULTIGRID_HPP_ */
@@ -10,6 +10,7 @@
 
 #include "Vector/map_vector.hpp"
 #include <boost/mpl/int.hpp>
+#include <algorithm>
 #include "VCluster/VCluster.hpp"
 
 #define EIGEN_TRIPLET 1
@@ -90,6 +91,125 @@ private:
 	openfpm::vector<triplet_type> trpl;
 	openfpm::vector<triplet_type> trpl_recv;
 
+	//! indicate if the sparsity pattern is frozen
+	bool frozen = false;
+
+	//! indicate if the pattern of the frozen matrix has been recorded
+	bool pattern_recorded = false;
+
+	//! number of times the sparsity pattern has been built
+	size_t n_pattern_build = 0;
+
+	//! position in the compressed Eigen matrix of each triplet (frozen pattern)
+	openfpm::vector<size_t> trpl_perm;
+
+	//! Rows of the matrix in CSR blocks
+	sparse_matrix_rows<T,id_t> rows;
+
+	//! indicate if the pattern of the frozen matrix has been set from the rows
+	bool rows_recorded = false;
+
+	/*! \brief Write the values of the triplets in place into the compressed matrix
+	 *
+	 * \param t triplets
+	 *
+	 * \return false if the triplets does not match the recorded pattern
+	 *
+	 */
+	bool fill_values(openfpm::vector<triplet_type> & t)
+	{
+		if (pattern_recorded == false || mat.isCompressed() == false || t.size() != trpl_perm.size())
+		{return false;}
+
+		const id_t * outer = mat.outerIndexPtr();
+		const id_t * inner = mat.innerIndexPtr();
+		T * values = mat.valuePtr();
+
+		std::fill(values,values + mat.nonZeros(),0);
+
+		for (size_t i = 0 ; i < t.size() ; i++)
+		{
+			long int c = t.get(i).col();
+			size_t pos = trpl_perm.get(i);
+
+			if (c < 0 || c >= mat.outerSize() ||
+				pos < (size_t)outer[c] || pos >= (size_t)outer[c+1] || inner[pos] != t.get(i).row())
+			{return false;}
+
+			// same semantic of setFromTriplets, duplicated entries are summed
+			values[pos] += t.get(i).value();
+		}
+
+		return true;
+	}
+
+	/*! \brief Record the position of each triplet in the compressed matrix
+	 *
+	 * \param t triplets
+	 *
+	 */
+	void record_pattern(openfpm::vector<triplet_type> & t)
+	{
+		const id_t * outer = mat.outerIndexPtr();
+		const id_t * inner = mat.innerIndexPtr();
+
+		trpl_perm.resize(t.size());
+
+		for (size_t i = 0 ; i < t.size() ; i++)
+		{
+			long int c = t.get(i).col();
+			const id_t * pos = std::lower_bound(inner + outer[c],inner + outer[c+1],(id_t)t.get(i).row());
+
+			trpl_perm.get(i) = pos - inner;
+		}
+
+		pattern_recorded = true;
+	}
+
+	/*! \brief Assemble the matrix from a set of triplets
+	 *
+	 * \param t triplets
+	 *
+	 */
+	void assemble_triplets(openfpm::vector<triplet_type> & t)
+	{
+		if (frozen == true && fill_values(t) == true)
+		{return;}
+
+		mat.setFromTriplets(t.begin(),t.end());
+		n_pattern_build++;
+		rows_recorded = false;
+
+		if (frozen == true)
+		{record_pattern(t);}
+	}
+
+	/*! \brief Assemble the matrix from the rows in CSR blocks (and the triplets)
+	 *
+	 * The blocks are merged into a CSR that is mapped as a row major Eigen matrix and converted
+	 * into mat without sorting. With a frozen pattern, if the CSR did not change the matrix is
+	 * left untouched
+	 *
+	 */
+	void assemble_rows()
+	{
+		int change = rows.buildCSR(0,mat.rows(),trpl,true);
+
+		if (frozen == true && rows_recorded == true && change == SPARSE_ROWS_SAME)
+		{return;}
+
+		Eigen::Map<const Eigen::SparseMatrix<T,Eigen::RowMajor,id_t>> csr(mat.rows(),mat.cols(),rows.getCSRNonZeros(),
+				                                                            rows.getCSRRows(),rows.getCSRColums(),rows.getCSRValues());
+
+		mat = csr;
+
+		if (frozen == false || rows_recorded == false || change == SPARSE_ROWS_PATTERN)
+		{n_pattern_build++;}
+
+		rows_recorded = frozen;
+		pattern_recorded = false;
+	}
+
 	/*! \brief Assemble the matrix
 	 *
 	 *
@@ -105,13 +225,17 @@ private:
 			collect();
 			// only master assemble the Matrix
 			if (vcl.getProcessUnitID() == 0)
-				mat.setFromTriplets(trpl_recv.begin(),trpl_recv.end());
+				assemble_triplets(trpl_recv);
 		}
+		else if (rows.getNBlocks() != 0)
+			assemble_rows();
 		else
-			mat.setFromTriplets(trpl.begin(),trpl.end());
+			assemble_triplets(trpl);
 	}
 
 	/*! \brief Here we collect the full matrix on master
+	 *
+	 * The rows in CSR blocks are sent as triplets
 	 *
 	 */
 	void collect()
@@ -120,8 +244,22 @@ private:
 
 		trpl_recv.clear();
 
-		// here we collect all the triplet in one array on the root node
-		vcl.SGather(trpl,trpl_recv,0);
+		if (rows.getNBlocks() == 0)
+		{
+			// here we collect all the triplet in one array on the root node
+			vcl.SGather(trpl,trpl_recv,0);
+			return;
+		}
+
+		openfpm::vector<triplet_type> trpl_send;
+		trpl_send.reserve(trpl.size());
+
+		for (size_t i = 0 ; i < trpl.size() ; i++)
+		{trpl_send.add(trpl.get(i));}
+
+		rows.forEachNonZero([&](long int r, long int c, T v){trpl_send.add(triplet_type(r,c,v));});
+
+		vcl.SGather(trpl_send,trpl_recv,0);
 	}
 
 public:
@@ -157,6 +295,55 @@ public:
 		return this->trpl;
 	}
 
+	/*! \brief Get the rows of the Matrix in CSR blocks
+	 *
+	 * It return the rows that sparse_matrix_add_rows fill. At assembly they are merged with the
+	 * triplets
+	 *
+	 * \return the rows of the Matrix
+	 *
+	 */
+	sparse_matrix_rows<T,id_t> & getMatrixRows()
+	{
+		return this->rows;
+	}
+
+	/*! \brief Freeze the sparsity pattern of the Matrix
+	 *
+	 * When the pattern is frozen, the first assembly record the position of each triplet in the
+	 * compressed matrix. Subsequent assemblies with the same sequence of rows and colums only write
+	 * the values in place, without sorting. If the sequence changes the pattern is recorded again
+	 *
+	 * \param freeze true to freeze the pattern
+	 *
+	 */
+	void freezePattern(bool freeze = true)
+	{
+		frozen = freeze;
+		pattern_recorded = false;
+		rows_recorded = false;
+	}
+
+	/*! \brief Return true if the sparsity pattern is frozen
+	 *
+	 * \return true if the pattern is frozen
+	 *
+	 */
+	bool isPatternFrozen() const
+	{
+		return frozen;
+	}
+
+	/*! \brief Return how many times the sparsity pattern has been built
+	 *
+	 * \return the number of pattern builds
+	 *
+	 */
+	size_t getNPatternBuilds() const
+	{
+		return n_pattern_build;
+	}
+
 	/*! \brief Get the Eigen Matrix object
 	 *
 	 * \return the Eigen Matrix
@@ -278,7 +465,7 @@ public:
 
 	/*! \brief Get the value from triplet
 	 *
-	 * \warning It is extremly slow because it do a full search across the triplets elements
+	 * \warning It is extremly slow because it do a full search across the triplets elements and the rows
 	 *
 	 * \param r row
 	 * \param c colum
@@ -292,7 +479,10 @@ public:
 				return trpl.get(i).value();
 		}
 
-		return 0;
+		T v = 0;
+		rows.getValue(r,c,v);
+
+		return v;
 	}
 };
 
@@ -0,0 +1,684 @@
+/*
+ * SparseMatrix_assembly.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef OPENFPM_NUMERICS_SRC_MATRIX_SPARSEMATRIX_ASSEMBLY_HPP_
+#define OPENFPM_NUMERICS_SRC_MATRIX_SPARSEMATRIX_ASSEMBLY_HPP_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include "config.h"
+#include "Vector/map_vector.hpp"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/*! \brief Accumulator for the non-zero colums of one row of a sparse matrix
+ *
+ * It has the same interface used by value_nz on the hash maps (cols[c] += coeff and iteration
+ * over (colum, value) pairs), but it is a small open addressing table that is reused from one row
+ * to the next: after the first rows there are no more allocations, clearing costs only the
+ * number of non-zeros of the row, and the iteration follow the insertion order
+ *
+ * \tparam T type of the coefficients
+ *
+ */
+template<typename T>
+class sparse_row_accumulator
+{
+	//! non-zero (colum,value) in insertion order
+	std::vector<std::pair<long int,T>> nz;
+
+	//! open addressing table with the position in nz (-1 empty), the size is a power of two
+	std::vector<int> slot;
+
+	//! slots used by the current row
+	std::vector<size_t> used;
+
+	/*! \brief Hash of a colum
+	 *
+	 * \param col colum
+	 *
+	 * \return the first slot to probe
+	 *
+	 */
+	inline size_t hash(long int col) const
+	{
+		return ((size_t)col * 0x9E3779B97F4A7C15ull) & (slot.size() - 1);
+	}
+
+	/*! \brief Find the slot of a colum
+	 *
+	 * \param col colum
+	 *
+	 * \return the slot containing the colum or the empty slot where to insert it
+	 *
+	 */
+	inline size_t find_slot(long int col) const
+	{
+		size_t mask = slot.size() - 1;
+		size_t h = hash(col);
+
+		while (slot[h] != -1 && nz[slot[h]].first != col)
+		{h = (h + 1) & mask;}
+
+		return h;
+	}
+
+	/*! \brief Double the table and re-insert the non-zeros of the row
+	 *
+	 */
+	void grow()
+	{
+		size_t sz = 2*slot.size();
+
+		slot.clear();
+		slot.resize(sz,-1);
+		used.clear();
+
+		for (size_t i = 0 ; i < nz.size() ; i++)
+		{
+			size_t h = find_slot(nz[i].first);
+			slot[h] = i;
+			used.push_back(h);
+		}
+	}
+
+public:
+
+	//! iterator over the (colum,value) pairs
+	typedef typename std::vector<std::pair<long int,T>>::iterator iterator;
+
+	//! constant iterator over the (colum,value) pairs
+	typedef typename std::vector<std::pair<long int,T>>::const_iterator const_iterator;
+
+	sparse_row_accumulator()
+	{
+		slot.resize(64,-1);
+	}
+
+	/*! \brief Get the coefficient of a colum (created as zero if it does not exist)
+	 *
+	 * \param col colum
+	 *
+	 * \return the coefficient
+	 *
+	 */
+	inline T & operator[](long int col)
+	{
+		if (2*(nz.size() + 1) > slot.size())
+		{grow();}
+
+		size_t h = find_slot(col);
+
+		if (slot[h] == -1)
+		{
+			slot[h] = nz.size();
+			used.push_back(h);
+			nz.push_back(std::make_pair(col,(T)0));
+		}
+
+		return nz[slot[h]].second;
+	}
+
+	/*! \brief Check if a colum is present in the row
+	 *
+	 * \param col colum
+	 *
+	 * \return true if the colum has been set
+	 *
+	 */
+	inline bool has(long int col) const
+	{
+		return slot[find_slot(col)] != -1;
+	}
+
+	/*! \brief Number of non-zero colums in the row
+	 *
+	 * \return the number of colums
+	 *
+	 */
+	inline size_t size() const
+	{
+		return nz.size();
+	}
+
+	/*! \brief Sort the colums of the row
+	 *
+	 * \warning after sorting the row can only be iterated or cleared
+	 *
+	 */
+	inline void sort()
+	{
+		std::sort(nz.begin(),nz.end(),
+				  [](const std::pair<long int,T> & a, const std::pair<long int,T> & b){return a.first < b.first;});
+	}
+
+	/*! \brief Remove all the colums, keeping the memory
+	 *
+	 */
+	inline void clear()
+	{
+		for (size_t i = 0 ; i < used.size() ; i++)
+		{slot[used[i]] = -1;}
+
+		used.clear();
+		nz.clear();
+	}
+
+	iterator begin()
+	{
+		return nz.begin();
+	}
+
+	iterator end()
+	{
+		return nz.end();
+	}
+
+	const_iterator begin() const
+	{
+		return nz.begin();
+	}
+
+	const_iterator end() const
+	{
+		return nz.end();
+	}
+};
+
+//! the CSR built by sparse_matrix_rows has the same pattern and values of the previous one
+#define SPARSE_ROWS_SAME 0
+//! the CSR built by sparse_matrix_rows has the same pattern of the previous one but different values
+#define SPARSE_ROWS_VALUES 1
+//! the CSR built by sparse_matrix_rows has a different pattern
+#define SPARSE_ROWS_PATTERN 2
+
+/*! \brief Rows of a sparse matrix stored in CSR blocks
+ *
+ * The rows are added in blocks, one for each thread of sparse_matrix_add_rows. Every block is a small
+ * CSR (row_ptr/col/val) with the global index of its rows and the colums of each row sorted.
+ * buildCSR merge the blocks (and the triplets eventually set on the same Matrix) with one prefix sum
+ * over the row lengths into the CSR of the local rows, that the backends take as it is
+ * (MatMPIAIJSetPreallocationCSR for PETSC, an Eigen::Map for Eigen). If a row is added more than
+ * one time the last one is kept
+ *
+ * \tparam T type of the coefficients
+ * \tparam idx_type type of the indexes
+ *
+ */
+template<typename T, typename idx_type>
+class sparse_matrix_rows
+{
+public:
+
+	//! block of rows in CSR
+	struct block
+	{
+		//! global index of the rows
+		std::vector<idx_type> row;
+
+		//! offset of each row in col and val
+		std::vector<size_t> row_ptr;
+
+		//! colums
+		std::vector<idx_type> col;
+
+		//! values
+		std::vector<T> val;
+
+		block()
+		{
+			row_ptr.push_back(0);
+		}
+
+		/*! \brief Append a row
+		 *
+		 * \param r global index of the row
+		 * \param cols sorted colums of the row
+		 *
+		 */
+		template<typename acc_type> inline void add(long int r, const acc_type & cols)
+		{
+			row.push_back(r);
+
+			for (auto it = cols.begin() ; it != cols.end() ; ++it)
+			{
+				col.push_back(it->first);
+				val.push_back(it->second);
+			}
+
+			row_ptr.push_back(col.size());
+		}
+	};
+
+private:
+
+	//! blocks of rows
+	std::vector<block> blocks;
+
+	//! CSR row offsets of the local rows
+	std::vector<idx_type> csr_row;
+
+	//! CSR global colums of the local rows
+	std::vector<idx_type> csr_col;
+
+	//! CSR values of the local rows
+	std::vector<T> csr_val;
+
+public:
+
+	/*! \brief Add empty blocks
+	 *
+	 * \param n number of blocks
+	 *
+	 * \return the id of the first block added
+	 *
+	 */
+	size_t addBlocks(size_t n)
+	{
+		size_t base = blocks.size();
+		blocks.resize(base + n);
+
+		return base;
+	}
+
+	/*! \brief Get a block of rows
+	 *
+	 * \param i block id
+	 *
+	 * \return the block
+	 *
+	 */
+	block & getBlock(size_t i)
+	{
+		return blocks[i];
+	}
+
+	/*! \brief Number of blocks
+	 *
+	 * \return the number of blocks
+	 *
+	 */
+	size_t getNBlocks() const
+	{
+		return blocks.size();
+	}
+
+	/*! \brief Number of rows stored in the blocks
+	 *
+	 * \return the number of rows
+	 *
+	 */
+	size_t size() const
+	{
+		size_t n = 0;
+
+		for (size_t i = 0 ; i < blocks.size() ; i++)
+		{n += blocks[i].row.size();}
+
+		return n;
+	}
+
+	/*! \brief Remove all the rows
+	 *
+	 * The CSR of the last buildCSR is kept to detect if the next one has the same pattern
+	 *
+	 */
+	void clear()
+	{
+		blocks.clear();
+	}
+
+	/*! \brief Release the CSR of the local rows
+	 *
+	 */
+	void releaseCSR()
+	{
+		std::vector<idx_type>().swap(csr_row);
+		std::vector<idx_type>().swap(csr_col);
+		std::vector<T>().swap(csr_val);
+	}
+
+	/*! \brief Call a functor for every non-zero of the blocks
+	 *
+	 * \param f functor f(row,colum,value)
+	 *
+	 */
+	template<typename functor> void forEachNonZero(functor f) const
+	{
+		for (size_t b = 0 ; b < blocks.size() ; b++)
+		{
+			const block & bl = blocks[b];
+
+			for (size_t i = 0 ; i < bl.row.size() ; i++)
+			{
+				for (size_t k = bl.row_ptr[i] ; k < bl.row_ptr[i+1] ; k++)
+				{f(bl.row[i],bl.col[k],bl.val[k]);}
+			}
+		}
+	}
+
+	/*! \brief Get the value of an element
+	 *
+	 * \warning It is slow, it search across all the rows
+	 *
+	 * \param r row
+	 * \param c colum
+	 * \param v value of the element
+	 *
+	 * \return true if the element is set
+	 *
+	 */
+	bool getValue(long int r, long int c, T & v) const
+	{
+		bool found = false;
+
+		forEachNonZero([&](long int row, long int col, T val)
+		{
+			if (row == r && col == c)
+			{
+				v = val;
+				found = true;
+			}
+		});
+
+		return found;
+	}
+
+	/*! \brief Merge the blocks and a set of triplets into the CSR of the local rows
+	 *
+	 * The rows of the blocks are copied in parallel at the offsets given by the prefix sum of the row
+	 * lengths. The triplets are appended to their rows, that are sorted again and where the duplicated
+	 * colums are merged
+	 *
+	 * \param start_row first global row of this processor
+	 * \param l_row number of local rows
+	 * \param trpl triplets of the same Matrix
+	 * \param sum_dup true if the duplicated colums are summed (Eigen), false if the last one win (PETSC)
+	 *
+	 * \return SPARSE_ROWS_SAME, SPARSE_ROWS_VALUES or SPARSE_ROWS_PATTERN comparing with the previous CSR
+	 *
+	 */
+	template<typename triplet_type>
+	int buildCSR(size_t start_row, size_t l_row, openfpm::vector<triplet_type> & trpl, bool sum_dup)
+	{
+		std::vector<idx_type> old_row;
+		std::vector<idx_type> old_col;
+		std::vector<T> old_val;
+
+		old_row.swap(csr_row);
+		old_col.swap(csr_col);
+		old_val.swap(csr_val);
+
+		// block and position of the row that define each local row
+		std::vector<std::pair<size_t,size_t>> src(l_row,std::make_pair((size_t)-1,(size_t)0));
+
+		for (size_t b = 0 ; b < blocks.size() ; b++)
+		{
+			for (size_t i = 0 ; i < blocks[b].row.size() ; i++)
+			{
+				long int lr = (long int)blocks[b].row[i] - (long int)start_row;
+
+				if (lr < 0 || lr >= (long int)l_row)
+				{
+					std::cerr << __FILE__ << ":" << __LINE__ << " error the row " << blocks[b].row[i] << " is not local" << std::endl;
+					continue;
+				}
+
+				src[lr] = std::make_pair(b,i);
+			}
+		}
+
+		csr_row.resize(l_row+1);
+		csr_row[0] = 0;
+
+		for (size_t r = 0 ; r < l_row ; r++)
+		{
+			const std::pair<size_t,size_t> & s = src[r];
+			csr_row[r+1] = (s.first == (size_t)-1)?0:blocks[s.first].row_ptr[s.second+1] - blocks[s.first].row_ptr[s.second];
+		}
+
+		// count the triplets of each row
+		std::vector<size_t> t_cnt;
+
+		if (trpl.size() != 0)
+		{
+			t_cnt.resize(l_row);
+
+			for (size_t i = 0 ; i < trpl.size() ; i++)
+			{
+				long int lr = (long int)trpl.get(i).row() - (long int)start_row;
+
+				if (lr < 0 || lr >= (long int)l_row)
+				{
+					std::cerr << __FILE__ << ":" << __LINE__ << " error the row " << trpl.get(i).row() << " is not local" << std::endl;
+					continue;
+				}
+
+				t_cnt[lr]++;
+				csr_row[lr+1]++;
+			}
+		}
+
+		for (size_t r = 0 ; r < l_row ; r++)
+		{csr_row[r+1] += csr_row[r];}
+
+		csr_col.resize(csr_row[l_row]);
+		csr_val.resize(csr_row[l_row]);
+
+		// copy the rows of the blocks
+#ifdef HAVE_OPENMP
+		#pragma omp parallel for schedule(static)
+#endif
+		for (size_t r = 0 ; r < l_row ; r++)
+		{
+			const std::pair<size_t,size_t> & s = src[r];
+
+			if (s.first == (size_t)-1)
+			{continue;}
+
+			const block & bl = blocks[s.first];
+
+			std::copy(bl.col.begin() + bl.row_ptr[s.second],bl.col.begin() + bl.row_ptr[s.second+1],csr_col.begin() + csr_row[r]);
+			std::copy(bl.val.begin() + bl.row_ptr[s.second],bl.val.begin() + bl.row_ptr[s.second+1],csr_val.begin() + csr_row[r]);
+		}
+
+		if (trpl.size() != 0)
+		{merge_triplets(start_row,l_row,trpl,t_cnt,sum_dup);}
+
+		if (old_row == csr_row && old_col == csr_col)
+		{return (old_val == csr_val)?SPARSE_ROWS_SAME:SPARSE_ROWS_VALUES;}
+
+		return SPARSE_ROWS_PATTERN;
+	}
+
+	/*! \brief Get the CSR row offsets of the local rows
+	 *
+	 * \return the pointer to the row offsets (l_row + 1)
+	 *
+	 */
+	const idx_type * getCSRRows() const
+	{
+		return csr_row.data();
+	}
+
+	/*! \brief Get the CSR colums of the local rows
+	 *
+	 * \return the pointer to the colums
+	 *
+	 */
+	const idx_type * getCSRColums() const
+	{
+		return csr_col.data();
+	}
+
+	/*! \brief Get the CSR values of the local rows
+	 *
+	 * \return the pointer to the values
+	 *
+	 */
+	const T * getCSRValues() const
+	{
+		return csr_val.data();
+	}
+
+	/*! \brief Number of non-zeros of the CSR of the local rows
+	 *
+	 * \return the number of non-zeros
+	 *
+	 */
+	size_t getCSRNonZeros() const
+	{
+		return csr_col.size();
+	}
+
+private:
+
+	/*! \brief Append the triplets to the CSR of the local rows
+	 *
+	 * \param start_row first global row of this processor
+	 * \param l_row number of local rows
+	 * \param trpl triplets
+	 * \param t_cnt number of triplets of each local row
+	 * \param sum_dup true if the duplicated colums are summed, false if the last one win
+	 *
+	 */
+	template<typename triplet_type>
+	void merge_triplets(size_t start_row, size_t l_row, openfpm::vector<triplet_type> & trpl,
+			            const std::vector<size_t> & t_cnt, bool sum_dup)
+	{
+		// the triplets go at the end of their row
+		std::vector<size_t> fill(l_row);
+		for (size_t r = 0 ; r < l_row ; r++)
+		{fill[r] = csr_row[r+1] - t_cnt[r];}
+
+		for (size_t i = 0 ; i < trpl.size() ; i++)
+		{
+			long int lr = (long int)trpl.get(i).row() - (long int)start_row;
+
+			if (lr < 0 || lr >= (long int)l_row)
+			{continue;}
+
+			csr_col[fill[lr]] = trpl.get(i).col();
+			csr_val[fill[lr]] = trpl.get(i).value();
+			fill[lr]++;
+		}
+
+		// sort the rows with triplets, merge the duplicated colums and compact
+		std::vector<std::pair<idx_type,T>> tmp;
+		size_t nnz = 0;
+
+		for (size_t r = 0 ; r < l_row ; r++)
+		{
+			size_t start = csr_row[r];
+			size_t stop = csr_row[r+1];
+
+			csr_row[r] = nnz;
+
+			if (t_cnt[r] == 0)
+			{
+				for (size_t k = start ; k < stop ; k++, nnz++)
+				{
+					csr_col[nnz] = csr_col[k];
+					csr_val[nnz] = csr_val[k];
+				}
+
+				continue;
+			}
+
+			tmp.clear();
+			for (size_t k = start ; k < stop ; k++)
+			{tmp.push_back(std::make_pair(csr_col[k],csr_val[k]));}
+
+			std::stable_sort(tmp.begin(),tmp.end(),
+					         [](const std::pair<idx_type,T> & a, const std::pair<idx_type,T> & b){return a.first < b.first;});
+
+			for (size_t k = 0 ; k < tmp.size() ; k++)
+			{
+				if (k != 0 && tmp[k].first == csr_col[nnz-1])
+				{
+					if (sum_dup == true)
+					{csr_val[nnz-1] += tmp[k].second;}
+					else
+					{csr_val[nnz-1] = tmp[k].second;}
+
+					continue;
+				}
+
+				csr_col[nnz] = tmp[k].first;
+				csr_val[nnz] = tmp[k].second;
+				nnz++;
+			}
+		}
+
+		csr_row[l_row] = nnz;
+		csr_col.resize(nnz);
+		csr_val.resize(nnz);
+	}
+};
+
+/*! \brief Add rows to a Matrix, evaluating the rows in parallel
+ *
+ * The rows are produced by a functor row_f(key,cols) that fill the accumulator cols with the
+ * non-zero colums and return the row index. Every thread evaluate once the rows of a contiguous
+ * range of keys and write them, with the colums sorted, into its own CSR block of rows, using its
+ * own accumulator. As in the serial assembly, a zero diagonal entry is added to the rows without
+ * diagonal.
+ *
+ * \warning the functor is called concurrently from several threads, so the expressions must not
+ *          have a state
+ *
+ * \param rows rows of the Matrix (SparseMatrix::getMatrixRows)
+ * \param keys keys of the rows
+ * \param row_f functor that produce the row of a key
+ *
+ */
+template<typename T, typename idx_type, typename key_type, typename row_functor>
+void sparse_matrix_add_rows(sparse_matrix_rows<T,idx_type> & rows,
+		                    const std::vector<key_type> & keys,
+		                    const row_functor & row_f)
+{
+	size_t n = keys.size();
+	size_t nth = 1;
+
+#ifdef HAVE_OPENMP
+	nth = omp_get_max_threads();
+#endif
+
+	size_t base = rows.addBlocks(nth);
+
+#ifdef HAVE_OPENMP
+	#pragma omp parallel num_threads(nth)
+#endif
+	{
+		size_t t = 0;
+		size_t nt = 1;
+
+#ifdef HAVE_OPENMP
+		t = omp_get_thread_num();
+		nt = omp_get_num_threads();
+#endif
+
+		auto & bl = rows.getBlock(base + t);
+		sparse_row_accumulator<T> cols;
+
+		for (size_t k = n*t/nt ; k < n*(t+1)/nt ; k++)
+		{
+			cols.clear();
+			long int r = row_f(keys[k],cols);
+
+			// If does not have a diagonal entry put it to zero
+			cols[r];
+
+			cols.sort();
+			bl.add(r,cols);
+		}
+	}
+}
+
+#endif /* OPENFPM_NUMERICS_SRC_MATRIX_SPARSEMATRIX_ASSEMBLY_HPP_ */
@@ -11,6 +11,7 @@
 #include "util/petsc_util.hpp"
 #include "Vector/map_vector.hpp"
 #include <boost/mpl/int.hpp>
+#include <algorithm>
 #include <petscmat.h>
 #include "VTKWriter/VTKWriter.hpp"
 #include "CSVWriter/CSVWriter.hpp"
@@ -87,6 +88,20 @@ public:
 	{};
 };
 
+/*! \brief Counter shared by all the PETSC Matrices to number the revisions of the coefficients
+ *
+ * Revisions are unique across Matrices, so two different Matrices never report the same revision
+ *
+ * \return the last revision given
+ *
+ */
+inline size_t & sparse_matrix_petsc_revision_counter()
+{
+	static size_t counter = 0;
+
+	return counter;
+}
+
 /*! \brief Sparse Matrix implementation, that map over Eigen
  *
  * \tparam T Type of the sparse Matrix store on each row,colums
@@ -139,12 +154,274 @@ private:
 	//! PETSC o_nnz
 	mutable openfpm::vector<PetscInt> o_nnz;
 
+	//! indicate if the sparsity pattern is frozen
+	bool frozen = false;
+
+	//! indicate if the pattern of the frozen matrix has been recorded
+	bool pattern_recorded = false;
+
+	//! number of times the sparsity pattern has been built
+	size_t n_pattern_build = 0;
+
+	//! revision of the coefficients, renewed every time the assembled values change (0 = never assembled)
+	size_t revision = 0;
+
+	//! CSR row offsets of the local rows (frozen pattern)
+	openfpm::vector<PetscInt> csr_row;
+
+	//! CSR global colums (frozen pattern)
+	openfpm::vector<PetscInt> csr_col;
+
+	//! CSR values (frozen pattern)
+	openfpm::vector<PetscScalar> csr_val;
+
+	//! position in the CSR of each triplet (frozen pattern)
+	openfpm::vector<size_t> trpl_perm;
+
+	//! Rows of the matrix in CSR blocks
+	sparse_matrix_rows<PetscScalar,PetscInt> rows;
+
+	//! indicate if the pattern of the frozen matrix has been set from the rows
+	bool rows_recorded = false;
+
+	/*! \brief Write the values of the triplets into the recorded CSR
+	 *
+	 * \param modified set to true if at least one value changed
+	 *
+	 * \return false if the triplets does not match the recorded pattern
+	 *
+	 */
+	bool fill_csr_values(bool & modified)
+	{
+		if (pattern_recorded == false || trpl.size() != trpl_perm.size())
+		{return false;}
+
+		for (size_t i = 0 ; i < trpl.size() ; i++)
+		{
+			PetscInt r = trpl.get(i).row() - start_row;
+			size_t pos = trpl_perm.get(i);
+
+			if (r < 0 || (size_t)r >= l_row ||
+				pos < (size_t)csr_row.get(r) || pos >= (size_t)csr_row.get(r+1) ||
+				csr_col.get(pos) != trpl.get(i).col())
+			{return false;}
+
+			// INSERT_VALUES semantic, the last triplet win
+			if (csr_val.get(pos) != trpl.get(i).value())
+			{
+				csr_val.get(pos) = trpl.get(i).value();
+				modified = true;
+			}
+		}
+
+		return true;
+	}
+
+	/*! \brief Record the sparsity pattern of the triplets as CSR and the triplet to CSR permutation
+	 *
+	 * Colums are sorted inside each row and duplicated entries are merged (the last triplet win, like
+	 * INSERT_VALUES). The Matrix is preallocated and filled with MatMPIAIJSetPreallocationCSR
+	 *
+	 */
+	void record_pattern()
+	{
+		csr_row.resize(l_row+1);
+		csr_row.fill(0);
+
+		// count the entries for each row
+		for (size_t i = 0 ; i < trpl.size() ; i++)
+		{csr_row.get(trpl.get(i).row() - start_row + 1)++;}
+
+		for (size_t i = 0 ; i < l_row ; i++)
+		{csr_row.get(i+1) += csr_row.get(i);}
+
+		// bucket the triplets by row, keeping the insertion order
+		openfpm::vector<size_t> order;
+		order.resize(trpl.size());
+
+		d_nnz.resize(l_row);
+		for (size_t i = 0 ; i < l_row ; i++)
+		{d_nnz.get(i) = csr_row.get(i);}
+
+		for (size_t i = 0 ; i < trpl.size() ; i++)
+		{order.get(d_nnz.get(trpl.get(i).row() - start_row)++) = i;}
+
+		csr_col.resize(trpl.size());
+		trpl_perm.resize(trpl.size());
+
+		size_t * ord = (size_t *)order.getPointer();
+		size_t nnz = 0;
+
+		for (size_t r = 0 ; r < l_row ; r++)
+		{
+			size_t start = csr_row.get(r);
+			size_t stop = csr_row.get(r+1);
+
+			std::stable_sort(ord + start, ord + stop,
+					         [this](size_t a, size_t b){return trpl.get(a).col() < trpl.get(b).col();});
+
+			csr_row.get(r) = nnz;
+
+			for (size_t k = start ; k < stop ; k++)
+			{
+				PetscInt col = trpl.get(ord[k]).col();
+
+				if (k == start || col != csr_col.get(nnz-1))
+				{
+					csr_col.get(nnz) = col;
+					nnz++;
+				}
+
+				trpl_perm.get(ord[k]) = nnz-1;
+			}
+		}
+
+		csr_row.get(l_row) = nnz;
+		csr_col.resize(nnz);
+		csr_val.resize(nnz);
+
+		pattern_recorded = true;
+		rows_recorded = false;
+		bool modified = false;
+		fill_csr_values(modified);
+
+		PETSC_SAFE_CALL(MatMPIAIJSetPreallocationCSR(mat,static_cast<const PetscInt*>(csr_row.getPointer()),
+				                                         static_cast<const PetscInt*>(csr_col.getPointer()),
+				                                         static_cast<const PetscScalar*>(csr_val.getPointer())));
+
+		n_pattern_build++;
+		revision = ++sparse_matrix_petsc_revision_counter();
+	}
+
+	/*! \brief Fill the petsc Matrix keeping the recorded sparsity pattern
+	 *
+	 * If the triplets have the same pattern (same sequence of row and colums) of the recorded one
+	 * the values are written in place into the CSR and inserted into the already preallocated Matrix,
+	 * without counting, preallocation or sorting. Otherwise the pattern is recorded again.
+	 * If no value changed the Matrix is left untouched.
+	 * The decisions are collective because preallocation and assembly are collective
+	 *
+	 */
+	void fill_petsc_frozen()
+	{
+		Vcluster<> & v_cl = create_vcluster();
+
+		bool modified = false;
+		size_t changed = (fill_csr_values(modified) == false);
+		size_t n_modified = modified;
+		v_cl.sum(changed);
+		v_cl.sum(n_modified);
+		v_cl.execute();
+
+		if (changed != 0)
+		{
+			record_pattern();
+		}
+		else if (n_modified != 0)
+		{
+			const PetscInt * cols_p = static_cast<const PetscInt*>(csr_col.getPointer());
+			const PetscScalar * vals_p = static_cast<const PetscScalar*>(csr_val.getPointer());
+
+			for (size_t r = 0 ; r < l_row ; r++)
+			{
+				PetscInt row = r + start_row;
+				PetscInt start = csr_row.get(r);
+				PetscInt n = csr_row.get(r+1) - start;
+
+				PETSC_SAFE_CALL(MatSetValues(mat,1,&row,n,cols_p + start,vals_p + start,INSERT_VALUES));
+			}
+
+			PETSC_SAFE_CALL(MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY));
+			PETSC_SAFE_CALL(MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY));
+
+			revision = ++sparse_matrix_petsc_revision_counter();
+		}
+
+		m_created = true;
+	}
+
+	/*! \brief Fill the petsc Matrix from the rows in CSR blocks (and the triplets)
+	 *
+	 * The blocks are merged into the CSR of the local rows, that is given directly to
+	 * MatMPIAIJSetPreallocationCSR. With a frozen pattern, if the CSR has the same pattern of the previous
+	 * assembly only the values are inserted, and if no value changed the Matrix is left untouched
+	 *
+	 */
+	void fill_petsc_rows()
+	{
+		int change = rows.buildCSR(start_row,l_row,trpl,false);
+
+		if (frozen == true)
+		{
+			Vcluster<> & v_cl = create_vcluster();
+
+			size_t n_pattern = (change == SPARSE_ROWS_PATTERN || rows_recorded == false);
+			size_t n_values = (change != SPARSE_ROWS_SAME);
+			v_cl.sum(n_pattern);
+			v_cl.sum(n_values);
+			v_cl.execute();
+
+			if (n_pattern == 0)
+			{
+				if (n_values != 0)
+				{
+					const PetscInt * csr_r = rows.getCSRRows();
+
+					for (size_t r = 0 ; r < l_row ; r++)
+					{
+						PetscInt row = r + start_row;
+						PetscInt n = csr_r[r+1] - csr_r[r];
+
+						PETSC_SAFE_CALL(MatSetValues(mat,1,&row,n,rows.getCSRColums() + csr_r[r],rows.getCSRValues() + csr_r[r],INSERT_VALUES));
+					}
+
+					PETSC_SAFE_CALL(MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY));
+					PETSC_SAFE_CALL(MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY));
+
+					revision = ++sparse_matrix_petsc_revision_counter();
+				}
+
+				m_created = true;
+				return;
+			}
+		}
+
+		PETSC_SAFE_CALL(MatMPIAIJSetPreallocationCSR(mat,rows.getCSRRows(),rows.getCSRColums(),rows.getCSRValues()));
+
+		n_pattern_build++;
+		revision = ++sparse_matrix_petsc_revision_counter();
+
+		rows_recorded = frozen;
+		pattern_recorded = false;
+
+		// PETSC has its own copy
+		if (frozen == false)
+		{rows.releaseCSR();}
+
+		m_created = true;
+	}
+
 	/*! \brief Fill the petsc Matrix
 	 *
 	 *
 	 */
 	void fill_petsc()
 	{
+		if (rows.getNBlocks() != 0)
+		{
+			fill_petsc_rows();
+			return;
+		}
+
+		if (frozen == true)
+		{
+			fill_petsc_frozen();
+			return;
+		}
+
+		n_pattern_build++;
+		revision = ++sparse_matrix_petsc_revision_counter();
+
 		d_nnz.resize(l_row);
 		o_nnz.resize(l_row);
 
@@ -269,6 +546,77 @@ public:
 		return this->trpl;
 	}
 
+	/*! \brief Get the rows of the Matrix in CSR blocks
+	 *
+	 * It return the rows that sparse_matrix_add_rows fill. At assembly they are merged with the
+	 * triplets
+	 *
+	 * \return the rows of the Matrix
+	 *
+	 */
+	sparse_matrix_rows<PetscScalar,PetscInt> & getMatrixRows()
+	{
+		m_created = false;
+
+		return this->rows;
+	}
+
+	/*! \brief Freeze the sparsity pattern of the Matrix
+	 *
+	 * When the pattern is frozen, the first assembly record the CSR structure and the position of each triplet
+	 * in it. Subsequent assemblies that produce the triplets with the same sequence of rows and colums (for example
+	 * a time dependent system imposed again after reset) only write the values in place. If the sequence
+	 * changes the pattern is recorded again
+	 *
+	 * \param freeze true to freeze the pattern
+	 *
+	 */
+	void freezePattern(bool freeze = true)
+	{
+		frozen = freeze;
+		pattern_recorded = false;
+		rows_recorded = false;
+		m_created = false;
+	}
+
+	/*! \brief Return true if the sparsity pattern is frozen
+	 *
+	 * \return true if the pattern is frozen
+	 *
+	 */
+	bool isPatternFrozen() const
+	{
+		return frozen;
+	}
+
+	/*! \brief Return how many times the sparsity pattern has been built (counting, preallocation)
+	 *
+	 * \return the number of pattern builds
+	 *
+	 */
+	size_t getNPatternBuilds() const
+	{
+		return n_pattern_build;
+	}
+
+	/*! \brief Return the revision of the coefficients of the Matrix
+	 *
+	 * The revision changes every time the Matrix is assembled with different values, it can be
+	 * used to know if something that depend on the coefficients (like a preconditioner) must be rebuilt.
+	 * Without a frozen pattern every assembly count as a change. Revisions are taken from a counter
+	 * shared by all the Matrices, so a different Matrix has always a different revision
+	 *
+	 * \return the revision
+	 *
+	 */
+	size_t getRevision()
+	{
+		if (m_created == false)
+		{fill_petsc();}
+
+		return revision;
+	}
+
 	/*! \brief Get the Patsc Matrix object
 	 *
 	 * \return the Eigen Matrix
@@ -352,7 +700,7 @@ public:
 
 	/*! \brief Get the value from triplet
 	 *
-	 * \warning It is extremly slow because it do a full search across the triplets elements
+	 * \warning It is extremly slow because it do a full search across the triplets elements and the rows
 	 *
 	 * \param r row
 	 * \param c colum
@@ -366,7 +714,10 @@ public:
 				return trpl.get(i).value();
 		}
 
-		return 0;
+		PetscScalar v = 0;
+		rows.getValue(r,c,v);
+
+		return v;
 	}
 
 	/* Write matrix on vtk
@@ -12,6 +12,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "Matrix/SparseMatrix.hpp"
+#include "Matrix/SparseMatrix_assembly.hpp"
 #include "Vector/Vector.hpp"
 #include "Solvers/umfpack_solver.hpp"
 #include "Solvers/petsc_solver.hpp"
@@ -176,6 +177,284 @@ BOOST_AUTO_TEST_CASE(sparse_matrix_eigen_parallel)
 #endif
 }
 
+BOOST_AUTO_TEST_CASE(sparse_matrix_parallel_row_assembly)
+{
+	typedef triplet<double,-1> triplet_type;
+
+	const long int n = 1000;
+
+	std::vector<long int> keys;
+	for (long int i = 0 ; i < n ; i++)
+	{keys.push_back(i);}
+
+	// 5 points stencil folded in blocks of 4 colums, so the offsets -2 and +2 of every row
+	// fall on the same colum and are accumulated, the row n/2 does not have the diagonal
+	auto row_f = [&](const long int & key, sparse_row_accumulator<double> & cols) -> long int
+	{
+		for (long int j = -2 ; j <= 2 ; j++)
+		{
+			if (key == n/2 && j == 0)	{continue;}
+			cols[(key + j + n) % 4 + (key / 4) * 4] += (double)(j + 3);
+		}
+
+		return key;
+	};
+
+	// the rows are added in two calls with the second half first
+	std::vector<long int> keys_low(keys.begin(),keys.begin() + n/2);
+	std::vector<long int> keys_high(keys.begin() + n/2,keys.end());
+
+	sparse_matrix_rows<double,long int> rows;
+	sparse_matrix_add_rows(rows,keys_high,row_f);
+	sparse_matrix_add_rows(rows,keys_low,row_f);
+
+	BOOST_REQUIRE_EQUAL(rows.size(),(size_t)n);
+
+	// one triplet on a new colum of the row 3 and one on the diagonal of the row 4
+	openfpm::vector<triplet_type> trpl;
+	trpl.add(triplet_type(3,n-1,-1.0));
+	trpl.add(triplet_type(4,4,-2.0));
+
+	BOOST_REQUIRE_EQUAL(rows.buildCSR(0,n,trpl,true),SPARSE_ROWS_PATTERN);
+
+	// serial reference
+	std::vector<long int> row_ref(1,0);
+	std::vector<long int> col_ref;
+	std::vector<double> val_ref;
+	sparse_row_accumulator<double> cols;
+
+	for (long int i = 0 ; i < n ; i++)
+	{
+		cols.clear();
+		long int r = row_f(i,cols);
+
+		cols[r];
+		if (r == 3)	{cols[n-1] += -1.0;}
+		if (r == 4)	{cols[4] += -2.0;}
+		cols.sort();
+
+		for (auto it = cols.begin() ; it != cols.end() ; ++it)
+		{
+			col_ref.push_back(it->first);
+			val_ref.push_back(it->second);
+		}
+
+		row_ref.push_back(col_ref.size());
+	}
+
+	BOOST_REQUIRE_EQUAL(rows.getCSRNonZeros(),col_ref.size());
+
+	for (long int i = 0 ; i <= n ; i++)
+	{BOOST_REQUIRE_EQUAL(rows.getCSRRows()[i],row_ref[i]);}
+
+	for (size_t i = 0 ; i < col_ref.size() ; i++)
+	{
+		BOOST_REQUIRE_EQUAL(rows.getCSRColums()[i],col_ref[i]);
+		BOOST_REQUIRE_EQUAL(rows.getCSRValues()[i],val_ref[i]);
+	}
+
+	// the row n/2 has a zero diagonal
+	double v = 1.0;
+	BOOST_REQUIRE(rows.getValue(n/2,n/2,v));
+	BOOST_REQUIRE_EQUAL(v,0.0);
+
+	// building again give the same CSR, the last triplet win when the duplicated are not summed
+	BOOST_REQUIRE_EQUAL(rows.buildCSR(0,n,trpl,true),SPARSE_ROWS_SAME);
+	BOOST_REQUIRE_EQUAL(rows.buildCSR(0,n,trpl,false),SPARSE_ROWS_VALUES);
+
+	trpl.clear();
+	BOOST_REQUIRE_EQUAL(rows.buildCSR(0,n,trpl,false),SPARSE_ROWS_PATTERN);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_eigen_frozen_pattern)
+{
+#if defined(HAVE_EIGEN)
+
+	Vcluster<> & vcl = create_vcluster();
+
+	if (vcl.getProcessingUnits() != 1)
+		return;
+
+	const int n = 50;
+
+	SparseMatrix<double,int> sm(n,n);
+	sm.freezePattern();
+
+	typedef SparseMatrix<double,int>::triplet_type triplet;
+
+	for (size_t step = 0 ; step < 3 ; step++)
+	{
+		auto & triplets = sm.getMatrixTriplets();
+		triplets.clear();
+
+		for (int i = 0 ; i < n ; i++)
+		{
+			if (i != 0)
+			{triplets.add(triplet(i,i-1,1.0 + step));}
+			triplets.add(triplet(i,i,-2.0 * (1.0 + step)));
+			if (i != n-1)
+			{triplets.add(triplet(i,i+1,1.0 + step));}
+		}
+
+		// duplicated entry, summed
+		triplets.add(triplet(0,0,0.5));
+
+		auto & mat = sm.getMat();
+
+		BOOST_REQUIRE_EQUAL(mat.coeff(0,0),-2.0 * (1.0 + step) + 0.5);
+		BOOST_REQUIRE_EQUAL(mat.coeff(5,4),1.0 + step);
+		BOOST_REQUIRE_EQUAL(mat.coeff(5,5),-2.0 * (1.0 + step));
+		BOOST_REQUIRE_EQUAL(mat.coeff(5,6),1.0 + step);
+		BOOST_REQUIRE_EQUAL(sm.getNPatternBuilds(),1ul);
+	}
+
+	// a different pattern is recorded again
+	sm.getMatrixTriplets().add(triplet(0,n-1,7.0));
+	auto & mat = sm.getMat();
+
+	BOOST_REQUIRE_EQUAL(mat.coeff(0,n-1),7.0);
+	BOOST_REQUIRE_EQUAL(sm.getNPatternBuilds(),2ul);
+
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_umfpack_factorization_cache)
+{
+#if defined(HAVE_EIGEN) && defined(HAVE_SUITESPARSE)
+
+	Vcluster<> & vcl = create_vcluster();
+
+	if (vcl.getProcessingUnits() != 1)
+		return;
+
+	const int n = 50;
+
+	SparseMatrix<double,int> sm(n,n);
+	Vector<double> b(n);
+
+	typedef SparseMatrix<double,int>::triplet_type triplet;
+
+	for (int i = 0 ; i < n ; i++)
+	{b.insert(i,1.0);}
+
+	umfpack_solver<double> solver;
+
+	auto fill = [&](double scale)
+	{
+		auto & triplets = sm.getMatrixTriplets();
+		triplets.clear();
+
+		for (int i = 0 ; i < n ; i++)
+		{
+			if (i != 0)
+			{triplets.add(triplet(i,i-1,scale));}
+			triplets.add(triplet(i,i,-4.0 * scale));
+			if (i != n-1)
+			{triplets.add(triplet(i,i+1,scale));}
+		}
+	};
+
+	// A x with the current values of the Matrix
+	auto check = [&](Vector<double> & x, double expected)
+	{
+		auto & x_ei = x.getVec();
+		auto & mat = sm.getMat();
+		Eigen::Matrix<double, Eigen::Dynamic, 1> res = mat * x_ei;
+
+		for (int i = 0 ; i < n ; i++)
+		{BOOST_REQUIRE_CLOSE(res(i),expected,1e-8);}
+	};
+
+	// first solve: symbolic and numeric
+	fill(1.0);
+	Vector<double> x = solver.solve(sm,b);
+	check(x,1.0);
+	BOOST_REQUIRE_EQUAL(solver.getNSymbolic(),1ul);
+	BOOST_REQUIRE_EQUAL(solver.getNNumeric(),1ul);
+
+	// same Matrix: nothing
+	fill(1.0);
+	x = solver.solve(sm,b);
+	check(x,1.0);
+	BOOST_REQUIRE_EQUAL(solver.getNSymbolic(),1ul);
+	BOOST_REQUIRE_EQUAL(solver.getNNumeric(),1ul);
+
+	// new values: only numeric
+	fill(2.0);
+	x = solver.solve(sm,b);
+	check(x,1.0);
+	BOOST_REQUIRE_EQUAL(solver.getNSymbolic(),1ul);
+	BOOST_REQUIRE_EQUAL(solver.getNNumeric(),2ul);
+
+	// flagged unchanged: the old factorization is used even if the values changed
+	solver.setMatrixUnchanged(true);
+	fill(3.0);
+	x = solver.solve(sm,b);
+	check(x,1.5);
+	BOOST_REQUIRE_EQUAL(solver.getNNumeric(),2ul);
+	solver.setMatrixUnchanged(false);
+
+	// new pattern: symbolic and numeric
+	fill(1.0);
+	sm.getMatrixTriplets().add(triplet(0,n-1,0.5));
+	x = solver.solve(sm,b);
+	check(x,1.0);
+	BOOST_REQUIRE_EQUAL(solver.getNSymbolic(),2ul);
+	BOOST_REQUIRE_EQUAL(solver.getNNumeric(),3ul);
+
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_umfpack_unchanged_parallel)
+{
+#if defined(HAVE_EIGEN) && defined(HAVE_SUITESPARSE)
+
+	Vcluster<> & vcl = create_vcluster();
+
+	const int loc = 10;
+	const int n = loc * vcl.getProcessingUnits();
+	const int start = loc * vcl.getProcessUnitID();
+
+	SparseMatrix<double,int> sm(n,n);
+	Vector<double> b(n);
+	Vector<double> b2(n);
+
+	typedef SparseMatrix<double,int>::triplet_type triplet;
+
+	auto & triplets = sm.getMatrixTriplets();
+
+	for (int i = start ; i < start + loc ; i++)
+	{
+		if (i != 0)
+		{triplets.add(triplet(i,i-1,1.0));}
+		triplets.add(triplet(i,i,-4.0));
+		if (i != n-1)
+		{triplets.add(triplet(i,i+1,1.0));}
+
+		b.insert(i,1.0);
+		b2.insert(i,2.0);
+	}
+
+	umfpack_solver<double> solver;
+	Vector<double> x = solver.solve(sm,b);
+
+	// every processor must skip the collection of the Matrix, otherwise the solve hang
+	solver.setMatrixUnchanged(true);
+	Vector<double> x2 = solver.solve(sm,b2);
+	Vector<double> x3 = solver.solve(sm,b);
+
+	for (int i = start ; i < start + loc ; i++)
+	{
+		BOOST_REQUIRE_CLOSE(x2(i),2.0 * x(i),1e-8);
+		BOOST_REQUIRE_CLOSE(x3(i),x(i),1e-8);
+	}
+
+	if (vcl.getProcessUnitID() == 0)
+	{BOOST_REQUIRE_EQUAL(solver.getNNumeric(),1ul);}
+
+#endif
+}
+
 #ifdef HAVE_PETSC
 
 BOOST_AUTO_TEST_CASE(sparse_matrix_eigen_petsc)
@@ -422,6 +701,225 @@ BOOST_AUTO_TEST_CASE(sparse_matrix_eigen_petsc_solve)
 	solver.solve(sm,v);
 }
 
+BOOST_AUTO_TEST_CASE(sparse_matrix_petsc_frozen_pattern)
+{
+	Vcluster<> & vcl = create_vcluster();
+
+	const int loc = 100;
+	const int n = loc * vcl.getProcessingUnits();
+	const int start = loc * vcl.getProcessUnitID();
+
+	SparseMatrix<double,int,PETSC_BASE> sm(n,n,loc);
+	sm.freezePattern();
+
+	typedef SparseMatrix<double,int,PETSC_BASE>::triplet_type triplet;
+
+	for (size_t step = 0 ; step < 3 ; step++)
+	{
+		auto & triplets = sm.getMatrixTriplets();
+		triplets.clear();
+
+		// rows are inserted in reverse order and colums unsorted
+		for (int i = start + loc - 1 ; i >= start ; i--)
+		{
+			triplets.add(triplet(i,i,-2.0 * (1.0 + step)));
+			if (i != n-1)
+			{triplets.add(triplet(i,i+1,1.0 + step));}
+			if (i != 0)
+			{triplets.add(triplet(i,i-1,1.0 + step));}
+		}
+
+		Mat & matp = sm.getMat();
+
+		PetscInt r[1] = {start + 1};
+		PetscInt c[3] = {start, start + 1, start + 2};
+		PetscScalar y[3];
+
+		MatGetValues(matp,1,r,3,c,y);
+
+		BOOST_REQUIRE_EQUAL(y[0],1.0 + step);
+		BOOST_REQUIRE_EQUAL(y[1],-2.0 * (1.0 + step));
+		BOOST_REQUIRE_EQUAL(y[2],1.0 + step);
+		BOOST_REQUIRE_EQUAL(sm.getNPatternBuilds(),1ul);
+	}
+
+	// a different pattern is recorded again
+	sm.getMatrixTriplets().add(triplet(start,start+2,7.0));
+	Mat & matp = sm.getMat();
+
+	PetscInt r[1] = {start};
+	PetscInt c[1] = {start + 2};
+	PetscScalar y[1];
+
+	MatGetValues(matp,1,r,1,c,y);
+
+	BOOST_REQUIRE_EQUAL(y[0],7.0);
+	BOOST_REQUIRE_EQUAL(sm.getNPatternBuilds(),2ul);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_petsc_pc_reuse)
+{
+	Vcluster<> & vcl = create_vcluster();
+
+	const int loc = 100;
+	const int n = loc * vcl.getProcessingUnits();
+	const int start = loc * vcl.getProcessUnitID();
+
+	SparseMatrix<double,int,PETSC_BASE> sm(n,n,loc);
+	Vector<double,PETSC_BASE> v(n,loc);
+	sm.freezePattern();
+
+	typedef SparseMatrix<double,int,PETSC_BASE>::triplet_type triplet;
+
+	auto fill = [&](double diag)
+	{
+		auto & triplets = sm.getMatrixTriplets();
+		triplets.clear();
+
+		for (int i = start ; i < start + loc ; i++)
+		{
+			if (i != 0)
+			{triplets.add(triplet(i,i-1,1.0));}
+			triplets.add(triplet(i,i,diag));
+			if (i != n-1)
+			{triplets.add(triplet(i,i+1,1.0));}
+		}
+	};
+
+	for (int i = start ; i < start + loc ; i++)
+	{v.insert(i,1.0);}
+
+	petsc_solver<double> solver;
+	solver.setPreconditioner(PCJACOBI);
+	solver.setPreconditionerReuse(REUSE_PC_UNCHANGED_COEFF);
+
+	// same coefficients, the preconditioner is built once
+	fill(-4.0);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	fill(-4.0);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),false);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),1ul);
+
+	// changed coefficients
+	fill(-5.0);
+	auto x = solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),2ul);
+	BOOST_REQUIRE(solver.getLastSetupTime() >= 0.0);
+	BOOST_REQUIRE(solver.getLastApplyTime() >= 0.0);
+
+	auto err = solver.get_residual_error(sm,x,v);
+	BOOST_REQUIRE(err.err_inf < 1e-3);
+
+	// rebuild every 2 solves, the solution use the current coefficients
+	solver.setPreconditionerReuse(REUSE_PC_N_SOLVES,2);
+
+	fill(-6.0);
+	x = solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),false);
+
+	err = solver.get_residual_error(sm,x,v);
+	BOOST_REQUIRE(err.err_inf < 1e-3);
+
+	fill(-6.0);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),3ul);
+
+	// rebuild when the last solve needed more iterations than the threshold
+	solver.setPreconditionerReuse(REUSE_PC_ITERATIONS,1000);
+
+	fill(-7.0);
+	x = solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),false);
+	BOOST_REQUIRE(solver.getLastIterations() > 0);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),3ul);
+
+	err = solver.get_residual_error(sm,x,v);
+	BOOST_REQUIRE(err.err_inf < 1e-3);
+
+	solver.setPreconditionerReuse(REUSE_PC_ITERATIONS,0);
+
+	fill(-7.0);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	fill(-7.0);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),5ul);
+
+	// a different Matrix with the same coefficients has a different revision
+	SparseMatrix<double,int,PETSC_BASE> sm2(n,n,loc);
+	sm2.getMatrixTriplets() = sm.getMatrixTriplets();
+
+	solver.setPreconditionerReuse(REUSE_PC_UNCHANGED_COEFF);
+	solver.solve(sm,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),false);
+	BOOST_REQUIRE(sm2.getRevision() != sm.getRevision());
+	solver.solve(sm2,v);
+	BOOST_REQUIRE_EQUAL(solver.isPreconditionerRebuilt(),true);
+	BOOST_REQUIRE_EQUAL(solver.getNPreconditionerBuilds(),6ul);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_matrix_petsc_tuning_database)
+{
+	Vcluster<> & vcl = create_vcluster();
+
+	const int loc = 100;
+	const int n = loc * vcl.getProcessingUnits();
+	const int start = loc * vcl.getProcessUnitID();
+
+	SparseMatrix<double,int,PETSC_BASE> sm(n,n,loc);
+	Vector<double,PETSC_BASE> v(n,loc);
+
+	typedef SparseMatrix<double,int,PETSC_BASE>::triplet_type triplet;
+
+	auto & triplets = sm.getMatrixTriplets();
+
+	for (int i = start ; i < start + loc ; i++)
+	{
+		if (i != 0)
+		{triplets.add(triplet(i,i-1,1.0));}
+		triplets.add(triplet(i,i,-4.0));
+		if (i != n-1)
+		{triplets.add(triplet(i,i+1,1.0));}
+
+		v.insert(i,1.0);
+	}
+
+	std::string db("petsc_solver_tuning_test.db");
+
+	if (vcl.getProcessUnitID() == 0)
+	{std::remove(db.c_str());}
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	// the first run search and store the fastest solver
+	petsc_solver<double> solver;
+	solver.setTuningDatabase(db);
+	solver.setTuningBudget(60.0);
+	auto x = solver.try_solve(sm,v);
+
+	BOOST_REQUIRE_EQUAL(solver.isLastTuningHit(),false);
+	BOOST_REQUIRE(solver.get_residual_error(sm,x,v).err_inf < 1e-3);
+
+	std::string key = solver.getMatrixFingerprint(sm);
+	BOOST_REQUIRE_EQUAL(key,std::string("n") + std::to_string(n) + "x" + std::to_string(n) + "_nnz" + std::to_string(3*n-2) + "_sym1_dd10");
+
+	// a second run use the stored configuration
+	petsc_solver<double> solver2;
+	solver2.setTuningDatabase(db);
+	x = solver2.try_solve(sm,v);
+
+	BOOST_REQUIRE_EQUAL(solver2.isLastTuningHit(),true);
+	BOOST_REQUIRE(solver2.get_residual_error(sm,x,v).err_inf < 1e-3);
+
+	// the fastest solver is kept for the next solves
+	x = solver.solve(sm,v);
+	BOOST_REQUIRE(solver.get_residual_error(sm,x,v).err_inf < 1e-3);
+}
+
 #endif
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,294 @@
+//
+// boost_vector_algebra_ofp_par.hpp
+//
+// Created on: Oct 18, 2026
+//
+
+#ifndef OPENFPM_PDATA_BOOST_VECTOR_ALGEBRA_OFP_PAR_HPP
+#define OPENFPM_PDATA_BOOST_VECTOR_ALGEBRA_OFP_PAR_HPP
+
+#include "config.h"
+#include <tuple>
+#include <utility>
+#include "OdeIntegrators/boost_vector_algebra_ofp.hpp"
+
+namespace boost {
+    namespace numeric {
+        namespace odeint {
+
+        //! under this number of elements the loops of vector_space_algebra_ofp_par are serial
+        constexpr size_t ofp_par_min_size = 4096;
+
+        /*! \brief Parallel version of vector_space_algebra_ofp
+         *
+         * It is a drop-in replacement of vector_space_algebra_ofp for the state types state_type_1d_ofp ...
+         * state_type_5d_ofp. Instead of calling the operation on each component of each particle, it loops
+         * component by component on the raw arrays of the temporals. Every loop is a contiguous loop split
+         * across the OpenMP threads and vectorized, so the odeint operations (scale_sum2 ... scale_sum14)
+         * are inlined in a SIMD loop. norm_inf is a parallel reduction followed by a max across processors
+         *
+         * \verbatim
+           boost::numeric::odeint::runge_kutta4< state_type_3d_ofp,double,state_type_3d_ofp,double,
+                                                 boost::numeric::odeint::vector_space_algebra_ofp_par> rk4;
+         * \endverbatim
+         *
+         */
+        struct vector_space_algebra_ofp_par
+        {
+            /*! \brief Get the raw array of the component prp of a state
+             *
+             * \param s state
+             *
+             * \return the pointer to the first element
+             *
+             */
+            template<int prp, typename S>
+            static inline auto get_ptr(S &s) -> decltype(&s.data.template get<prp>().getVector().template get<0>(0))
+            {
+                return &s.data.template get<prp>().getVector().template get<0>(0);
+            }
+
+            /*! \brief Apply the operation to all the elements of the arrays p ...
+             *
+             * \param op operation
+             * \param n number of elements
+             * \param p arrays
+             *
+             */
+            template<typename Op, typename ... P>
+            static inline void loop(Op &op, size_t n, P * ... p)
+            {
+#ifdef HAVE_OPENMP
+                #pragma omp parallel for simd schedule(static) if(n >= ofp_par_min_size)
+#endif
+                for (size_t i = 0 ; i < n ; i++)
+                {op(p[i] ...);}
+            }
+
+            //! It apply the operation on one component of all the states
+            template<typename Op, typename ... S>
+            struct for_each_prop_par
+            {
+                //! operation
+                Op &op;
+
+                //! states
+                std::tuple<S & ...> s;
+
+                //! number of elements
+                size_t n;
+
+                inline for_each_prop_par(Op &op, size_t n, S & ... s)
+                :op(op),s(s ...),n(n)
+                {};
+
+                //! It apply the operation on the component T::value
+                template<typename T>
+                inline void operator()(T& t) const
+                {
+                    apply<T::value>(std::index_sequence_for<S ...>());
+                }
+
+                template<int prp, size_t ... I>
+                inline void apply(std::index_sequence<I ...>) const
+                {
+                    loop(op,n,get_ptr<prp>(std::get<I>(s)) ...);
+                }
+            };
+
+            /*! \brief Apply the operation to all the elements of the states
+             *
+             * The first state is resized like the second one (as in vector_space_algebra_ofp)
+             *
+             * \param op operation
+             * \param s1 first state
+             * \param s other states
+             *
+             */
+            template<typename Op, typename S1, typename ... S>
+            static void for_each_par(Op &op, S1 &s1, S & ... s)
+            {
+                resize_first(s1,s ...);
+
+                size_t n = s1.data.template get<0>().getVector().size();
+
+                if (n == 0)
+                {return;}
+
+                for_each_prop_par<Op,S1,S ...> cp(op,n,s1,s ...);
+                boost::mpl::for_each_ref<boost::mpl::range_c<int,0,decltype(s1.data)::max_prop>>(cp);
+            }
+
+            //! Nothing to resize with one state
+            template<typename S1>
+            static inline void resize_first(S1 &s1)
+            {}
+
+            //! Resize the first state like the second one
+            template<typename S1, typename S2, typename ... S>
+            static inline void resize_first(S1 &s1, S2 &s2, S & ... s)
+            {
+                for_each_prop_resize<S1,S2> the_resize(s1,s2);
+                boost::mpl::for_each_ref<boost::mpl::range_c<int,0,decltype(s1.data)::max_prop>>(the_resize);
+            }
+
+            template< class S1 , class Op >
+            static void for_each1( S1 &s1 , Op op )
+            {
+                for_each_par(op,s1);
+            }
+
+            template< class S1 , class S2 , class Op >
+            static void for_each2( S1 &s1 , S2 &s2 , Op op )
+            {
+                for_each_par(op,s1,s2);
+            }
+
+            template< class S1 , class S2 , class S3 , class Op >
+            static void for_each3( S1 &s1 , S2 &s2 , S3 &s3 , Op op )
+            {
+                for_each_par(op,s1,s2,s3);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class Op >
+            static void for_each4( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class Op >
+            static void for_each5( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class Op >
+            static void for_each6( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class Op >
+            static void for_each7( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class Op >
+            static void for_each8( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class Op >
+            static void for_each9( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class Op >
+            static void for_each10( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class Op >
+            static void for_each11( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class Op >
+            static void for_each12( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class Op >
+            static void for_each13( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class S14 , class Op >
+            static void for_each14( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , S14 &s14 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14);
+            }
+
+            template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class S14 , class S15 , class Op >
+            static void for_each15( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , S14 &s14 , S15 &s15 , Op op )
+            {
+                for_each_par(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14,s15);
+            }
+
+            /*! \brief Infinity norm of a state
+             *
+             * \param s state
+             *
+             * \return the maximum absolute value of all the components across all the processors
+             *
+             */
+            template< class S >
+            static typename boost::numeric::odeint::vector_space_norm_inf< S >::result_type norm_inf( const S &s )
+            {
+                typedef typename boost::numeric::odeint::vector_space_norm_inf< S >::result_type result_type;
+
+                result_type n = 0;
+                size_t sz = s.data.template get<0>().getVector().size();
+
+                if (sz != 0)
+                {
+                    norm_inf_prop<S,result_type> cp(s,sz,n);
+                    boost::mpl::for_each_ref<boost::mpl::range_c<int,0,decltype(s.data)::max_prop>>(cp);
+                }
+
+                auto &v_cl = create_vcluster();
+                v_cl.max(n);
+                v_cl.execute();
+
+                return n;
+            }
+
+            //! It compute the maximum absolute value of one component
+            template<typename S, typename result_type>
+            struct norm_inf_prop
+            {
+                //! state
+                const S &s;
+
+                //! number of elements
+                size_t sz;
+
+                //! result
+                result_type &n;
+
+                inline norm_inf_prop(const S &s, size_t sz, result_type &n)
+                :s(s),sz(sz),n(n)
+                {};
+
+                template<typename T>
+                inline void operator()(T& t) const
+                {
+                    const auto * p = get_ptr<T::value>(s);
+                    result_type m = n;
+
+#ifdef HAVE_OPENMP
+                    #pragma omp parallel for simd schedule(static) reduction(max:m) if(sz >= ofp_par_min_size)
+#endif
+                    for (size_t i = 0 ; i < sz ; i++)
+                    {
+                        result_type a = fabs(p[i]);
+                        m = (a > m)?a:m;
+                    }
+
+                    n = m;
+                }
+            };
+        };
+
+    } // odeint
+} // numeric
+} // boost
+
+#endif //OPENFPM_PDATA_BOOST_VECTOR_ALGEBRA_OFP_PAR_HPP
@@ -17,6 +17,8 @@
 #include "OdeIntegrators/OdeIntegrators.hpp"
 #include "DCPSE/DCPSE_op/DCPSE_op.hpp"
 #include "OdeIntegrators/boost_vector_algebra_ofp.hpp"
+#include "OdeIntegrators/boost_vector_algebra_ofp_par.hpp"
+#include "OdeIntegrators/vector_dist_state_ofp.hpp"
 
 typedef texp_v<double> state_type;
 const double a = 2.8e-4;
@@ -82,6 +84,23 @@ void Exponential_struct_ofp2( const state_type_3d_ofp &x , state_type_3d_ofp &dx
 }
 
 
+//! x' = (1 + c/2) x for the component c of the state
+struct Exponential_vd
+{
+    template<typename state>
+    void operator()( const state &x , state &dxdt , const double t ) const
+    {
+        auto cx = x.getColumns();
+        auto cd = dxdt.getColumns();
+
+        for (size_t c = 0 ; c < state::ncomp ; c++)
+        {
+            for (size_t i = 0 ; i < x.size() ; i++)
+            {cd[c].ptr[i*cd[c].stride] = (1.0 + 0.5*c) * cx[c].ptr[i*cx[c].stride];}
+        }
+    }
+};
+
 void Exponential( const state_type &x , state_type &dxdt , const double t )
 {
     dxdt = x;
@@ -292,6 +311,367 @@ BOOST_AUTO_TEST_CASE(odeint_base_test_STRUCT_ofp)
     BOOST_REQUIRE(worst4 < 5e-5);
 }
 
+BOOST_AUTO_TEST_CASE(odeint_texp_v_inplace)
+{
+    size_t edgeSemiSize = 20;
+    const size_t sz[2] = {edgeSemiSize,edgeSemiSize };
+    Box<2, double> box({ 0, 0 }, { 1.0, 1.0 });
+    size_t bc[2] = { NON_PERIODIC, NON_PERIODIC };
+    double spacing[2];
+    spacing[0] = 1.0 / (sz[0] - 1);
+    spacing[1] = 1.0 / (sz[1] - 1);
+    Ghost<2, double> ghost(3.9 * spacing[0]);
+
+    vector_dist<2, double, aggregate<double,double,double,double,double,double>> Particles(0, box, bc, ghost);
+
+    auto it = Particles.getGridIterator(sz);
+    while (it.isNext())
+    {
+        Particles.add();
+        auto key = it.get();
+        Particles.getLastPos()[0] = key.get(0) * spacing[0];
+        Particles.getLastPos()[1] = key.get(1) * spacing[1];
+        Particles.getLastProp<0>() = Particles.getLastPos()[0];
+        Particles.getLastProp<1>() = Particles.getLastPos()[1];
+        ++it;
+    }
+    Particles.map();
+
+    auto P0 = getV<0>(Particles);
+    auto P1 = getV<1>(Particles);
+
+    state_type_2d_ofp x0;
+    state_type_2d_ofp x1;
+    x0.data.get<0>()=P0;
+    x0.data.get<1>()=P1;
+    x1.data.get<0>()=P1;
+    x1.data.get<1>()=P0;
+
+    const double * buf0 = x1.data.get<0>().begin();
+    const double * buf1 = x1.data.get<1>().begin();
+
+    // copy of the state (as done by the steppers) and evaluation of expressions reuse the memory
+    x1 = x0;
+    BOOST_REQUIRE(x1.data.get<0>().begin() == buf0);
+    BOOST_REQUIRE(x1.data.get<1>().begin() == buf1);
+
+    x1.data.get<0>() = 2.0*x0.data.get<0>() + x0.data.get<1>();
+    BOOST_REQUIRE(x1.data.get<0>().begin() == buf0);
+
+    x1.data.get<1>() = 3.0;
+    BOOST_REQUIRE(x1.data.get<1>().begin() == buf1);
+
+    bool match = true;
+    for (size_t i = 0 ; i < x0.size() ; i++)
+    {
+        double v0 = x0.data.get<0>().getVector().get<0>(i);
+        double v1 = x0.data.get<1>().getVector().get<0>(i);
+
+        match &= x1.data.get<0>().getVector().get<0>(i) == 2.0*v0 + v1;
+        match &= x1.data.get<1>().getVector().get<0>(i) == 3.0;
+    }
+
+    BOOST_REQUIRE(match);
+}
+
+
+BOOST_AUTO_TEST_CASE(odeint_algebra_ofp_par)
+{
+    size_t edgeSemiSize = 80;
+    const size_t sz[2] = {edgeSemiSize,edgeSemiSize };
+    Box<2, double> box({ 0, 0 }, { 1.0, 1.0 });
+    size_t bc[2] = { NON_PERIODIC, NON_PERIODIC };
+    double spacing[2];
+    spacing[0] = 1.0 / (sz[0] - 1);
+    spacing[1] = 1.0 / (sz[1] - 1);
+    Ghost<2, double> ghost(3.9 * spacing[0]);
+
+    vector_dist<2, double, aggregate<double,double,double,double,double,double>> Particles(0, box, bc, ghost);
+
+    auto it = Particles.getGridIterator(sz);
+    while (it.isNext())
+    {
+        Particles.add();
+        auto key = it.get();
+        double xp0 = key.get(0) * spacing[0];
+        double yp0 = key.get(1) * spacing[1];
+        Particles.getLastPos()[0] = xp0;
+        Particles.getLastPos()[1] = yp0;
+        Particles.getLastProp<0>() = xp0*yp0;
+        Particles.getLastProp<1>() = xp0 + yp0;
+        ++it;
+    }
+    Particles.map();
+
+    auto Init1 = getV<0>(Particles);
+    auto Init2 = getV<1>(Particles);
+
+    state_type_3d_ofp x_ser;
+    state_type_3d_ofp x_par;
+    x_ser.data.get<0>()=Init1;
+    x_ser.data.get<1>()=Init2;
+    x_ser.data.get<2>()=Init1;
+    x_par = x_ser;
+
+    double tf=0.4;
+    const double dt=0.1;
+
+    // the parallel algebra does the same operations element by element, so rk4 give the same result
+    boost::numeric::odeint::runge_kutta4< state_type_3d_ofp,double,state_type_3d_ofp,double,boost::numeric::odeint::vector_space_algebra_ofp> rk4_ser;
+    boost::numeric::odeint::runge_kutta4< state_type_3d_ofp,double,state_type_3d_ofp,double,boost::numeric::odeint::vector_space_algebra_ofp_par> rk4_par;
+
+    for (double t = 0 ; t < tf ; t += dt)
+    {
+        rk4_ser.do_step(Exponential_struct_ofp2,x_ser,t,dt);
+        rk4_par.do_step(Exponential_struct_ofp2,x_par,t,dt);
+    }
+
+    double worst = 0.0;
+    for (size_t i = 0 ; i < x_ser.size() ; i++)
+    {
+        worst = std::max(worst,fabs(x_ser.data.get<0>().getVector().get<0>(i) - x_par.data.get<0>().getVector().get<0>(i)));
+        worst = std::max(worst,fabs(x_ser.data.get<1>().getVector().get<0>(i) - x_par.data.get<1>().getVector().get<0>(i)));
+        worst = std::max(worst,fabs(x_ser.data.get<2>().getVector().get<0>(i) - x_par.data.get<2>().getVector().get<0>(i)));
+    }
+
+    BOOST_REQUIRE(worst < 1e-14);
+
+    // norm_inf is used by the adaptive steppers
+    BOOST_REQUIRE_CLOSE(boost::numeric::odeint::vector_space_algebra_ofp::norm_inf(x_ser),
+                        boost::numeric::odeint::vector_space_algebra_ofp_par::norm_inf(x_par),1e-12);
+
+    typedef boost::numeric::odeint::controlled_runge_kutta< boost::numeric::odeint::runge_kutta_cash_karp54< state_type_3d_ofp,double,state_type_3d_ofp,double,boost::numeric::odeint::vector_space_algebra_ofp_par>> stepper_type;
+
+    double t = 0.0;
+    x_par.data.get<0>()=Init1;
+    x_par.data.get<1>()=Init2;
+    x_par.data.get<2>()=Init1;
+    integrate_adaptive( stepper_type() , Exponential_struct_ofp2 , x_par , t , tf , dt);
+
+    double worst2 = 0.0;
+    auto it2 = Particles.getDomainIterator();
+    while (it2.isNext())
+    {
+        auto p = it2.get();
+        worst2 = std::max(worst2,fabs(x_par.data.get<0>().getVector().get<0>(p.getKey()) - Particles.getProp<0>(p)*exp(tf)));
+        worst2 = std::max(worst2,fabs(x_par.data.get<1>().getVector().get<0>(p.getKey()) - Particles.getProp<1>(p)*exp(2.0*tf)));
+        ++it2;
+    }
+
+    BOOST_REQUIRE(worst2 < 1e-4);
+}
+
+
+BOOST_AUTO_TEST_CASE(odeint_vector_dist_state)
+{
+    size_t edgeSemiSize = 40;
+    const size_t sz[2] = {edgeSemiSize,edgeSemiSize };
+    Box<2, double> box({ 0, 0 }, { 1.0, 1.0 });
+    size_t bc[2] = { NON_PERIODIC, NON_PERIODIC };
+    double spacing[2];
+    spacing[0] = 1.0 / (sz[0] - 1);
+    spacing[1] = 1.0 / (sz[1] - 1);
+    Ghost<2, double> ghost(3.9 * spacing[0]);
+
+    typedef vector_dist<2, double, aggregate<double,VectorS<2,double>,double,VectorS<2,double>>> vd_type;
+    vd_type Particles(0, box, bc, ghost);
+
+    auto it = Particles.getGridIterator(sz);
+    while (it.isNext())
+    {
+        Particles.add();
+        auto key = it.get();
+        double xp0 = key.get(0) * spacing[0];
+        double yp0 = key.get(1) * spacing[1];
+        Particles.getLastPos()[0] = xp0;
+        Particles.getLastPos()[1] = yp0;
+        Particles.getLastProp<0>() = xp0*yp0;
+        Particles.getLastProp<1>()[0] = xp0;
+        Particles.getLastProp<1>()[1] = yp0;
+        Particles.getLastProp<2>() = xp0*yp0;
+        Particles.getLastProp<3>()[0] = xp0;
+        Particles.getLastProp<3>()[1] = yp0;
+        ++it;
+    }
+    Particles.map();
+
+    // the state is the scalar property 0 and the vector property 1, integrated in place
+    typedef state_type_vd_ofp<vd_type,0,1> state_vd;
+    size_t ncomp = state_vd::ncomp;
+    BOOST_REQUIRE_EQUAL(ncomp,3ul);
+
+    state_vd x0(Particles);
+    BOOST_REQUIRE_EQUAL(x0.size(),Particles.size_local());
+
+    double tf=0.4;
+    const double dt=0.1;
+
+    boost::numeric::odeint::runge_kutta4< state_vd,double,state_vd,double,boost::numeric::odeint::vector_space_algebra_vd_ofp> rk4;
+    for (double t = 0 ; t < tf ; t += dt)
+    {rk4.do_step(Exponential_vd(),x0,t,dt);}
+
+    auto check = [&]()
+    {
+        double worst = 0.0;
+        auto it2 = Particles.getDomainIterator();
+        while (it2.isNext())
+        {
+            auto p = it2.get();
+            worst = std::max(worst,fabs(Particles.getProp<0>(p) - Particles.getProp<2>(p)*exp(tf)));
+            worst = std::max(worst,fabs(Particles.getProp<1>(p)[0] - Particles.getProp<3>(p)[0]*exp(1.5*tf)));
+            worst = std::max(worst,fabs(Particles.getProp<1>(p)[1] - Particles.getProp<3>(p)[1]*exp(2.0*tf)));
+            ++it2;
+        }
+        return worst;
+    };
+
+    BOOST_REQUIRE(check() < 1e-4);
+
+    // the adaptive stepper allocate its temporaries only the first time
+    typedef boost::numeric::odeint::controlled_runge_kutta< boost::numeric::odeint::runge_kutta_cash_karp54< state_vd,double,state_vd,double,boost::numeric::odeint::vector_space_algebra_vd_ofp>> stepper_type;
+
+    for (size_t k = 0 ; k < 2 ; k++)
+    {
+        auto it3 = Particles.getDomainIterator();
+        while (it3.isNext())
+        {
+            auto p = it3.get();
+            Particles.getProp<0>(p) = Particles.getProp<2>(p);
+            Particles.getProp<1>(p)[0] = Particles.getProp<3>(p)[0];
+            Particles.getProp<1>(p)[1] = Particles.getProp<3>(p)[1];
+            ++it3;
+        }
+
+        size_t n_alloc = ofp_state_arena::get().getNAllocated();
+
+        double t = 0.0;
+        integrate_adaptive( stepper_type() , Exponential_vd() , x0 , t , tf , dt);
+
+        BOOST_REQUIRE(check() < 1e-4);
+
+        if (k == 1)
+        {BOOST_REQUIRE_EQUAL(ofp_state_arena::get().getNAllocated(),n_alloc);}
+    }
+
+    // a temporary copied back into the particles
+    state_vd tmp(x0);
+    BOOST_REQUIRE_EQUAL(tmp.isView(),false);
+    tmp.get(0,0) = 123.0;
+    tmp.copyTo<2,3>(Particles);
+    BOOST_REQUIRE_EQUAL(Particles.getProp<2>(0),123.0);
+}
+
+BOOST_AUTO_TEST_CASE(odeint_vector_dist_state_map)
+{
+    size_t edgeSemiSize = 40;
+    const size_t sz[2] = {edgeSemiSize,edgeSemiSize };
+    Box<2, double> box({ 0, 0 }, { 1.0, 1.0 });
+    size_t bc[2] = { NON_PERIODIC, NON_PERIODIC };
+    double spacing[2];
+    spacing[0] = 1.0 / (sz[0] - 1);
+    spacing[1] = 1.0 / (sz[1] - 1);
+    Ghost<2, double> ghost(3.9 * spacing[0]);
+
+    typedef vector_dist<2, double, aggregate<double,VectorS<2,double>,double,VectorS<2,double>>> vd_type;
+    vd_type Particles(0, box, bc, ghost);
+
+    auto add_particle = [&](double xp0, double yp0)
+    {
+        Particles.add();
+        Particles.getLastPos()[0] = xp0;
+        Particles.getLastPos()[1] = yp0;
+        Particles.getLastProp<0>() = xp0*yp0;
+        Particles.getLastProp<1>()[0] = xp0;
+        Particles.getLastProp<1>()[1] = yp0;
+        Particles.getLastProp<2>() = xp0*yp0;
+        Particles.getLastProp<3>()[0] = xp0;
+        Particles.getLastProp<3>()[1] = yp0;
+    };
+
+    auto it = Particles.getGridIterator(sz);
+    while (it.isNext())
+    {
+        auto key = it.get();
+        add_particle(key.get(0) * spacing[0],key.get(1) * spacing[1]);
+        ++it;
+    }
+    Particles.map();
+
+    typedef state_type_vd_ofp<vd_type,0,1> state_vd;
+    state_vd x0(Particles);
+
+    // restart from the initial values
+    auto reset = [&]()
+    {
+        auto it2 = Particles.getDomainIterator();
+        while (it2.isNext())
+        {
+            auto p = it2.get();
+            Particles.getProp<0>(p) = Particles.getProp<2>(p);
+            Particles.getProp<1>(p)[0] = Particles.getProp<3>(p)[0];
+            Particles.getProp<1>(p)[1] = Particles.getProp<3>(p)[1];
+            ++it2;
+        }
+    };
+
+    auto check = [&](double tf)
+    {
+        double worst = 0.0;
+        auto it2 = Particles.getDomainIterator();
+        while (it2.isNext())
+        {
+            auto p = it2.get();
+            worst = std::max(worst,fabs(Particles.getProp<0>(p) - Particles.getProp<2>(p)*exp(tf)));
+            worst = std::max(worst,fabs(Particles.getProp<1>(p)[0] - Particles.getProp<3>(p)[0]*exp(1.5*tf)));
+            worst = std::max(worst,fabs(Particles.getProp<1>(p)[1] - Particles.getProp<3>(p)[1]*exp(2.0*tf)));
+            ++it2;
+        }
+        return worst;
+    };
+
+    double tf = 0.4;
+    const double dt = 0.1;
+
+    // both steppers use the initially_resizer
+    boost::numeric::odeint::runge_kutta4< state_vd,double,state_vd,double,boost::numeric::odeint::vector_space_algebra_vd_ofp> rk4;
+    typedef boost::numeric::odeint::controlled_runge_kutta< boost::numeric::odeint::runge_kutta_cash_karp54< state_vd,double,state_vd,double,boost::numeric::odeint::vector_space_algebra_vd_ofp>> stepper_type;
+    stepper_type ck;
+
+    for (size_t k = 0 ; k < 2 ; k++)
+    {
+        size_t n_before = Particles.size_local();
+
+        reset();
+        for (double t = 0 ; t < tf ; t += dt)
+        {rk4.do_step(Exponential_vd(),x0,t,dt);}
+        BOOST_REQUIRE(check(tf) < 1e-4);
+
+        reset();
+        double t = 0.0;
+        double dt_ck = dt;
+        while (t < tf - 1e-12)
+        {
+            dt_ck = std::min(dt_ck,tf - t);
+            ck.try_step(Exponential_vd(),x0,t,dt_ck);
+        }
+        BOOST_REQUIRE(check(tf) < 1e-4);
+
+        // the processor 0 add particles, map() change the local particles of the steppers states
+        if (create_vcluster().getProcessUnitID() == 0)
+        {
+            for (size_t i = 0 ; i < 500 ; i++)
+            {add_particle((double)rand() / ((double)RAND_MAX + 1.0),(double)rand() / ((double)RAND_MAX + 1.0));}
+        }
+
+        Particles.map();
+
+        BOOST_REQUIRE_EQUAL(x0.size(),Particles.size_local());
+
+        if (create_vcluster().getProcessingUnits() == 1)
+        {BOOST_REQUIRE_EQUAL(Particles.size_local(),n_before + 500);}
+    }
+}
+
 
 BOOST_AUTO_TEST_CASE(odeint_base_test2) 
 {
@@ -0,0 +1,734 @@
+//
+// vector_dist_state_ofp.hpp
+//
+// Created on: Oct 18, 2026
+//
+
+#ifndef OPENFPM_NUMERICS_VECTOR_DIST_STATE_OFP_HPP
+#define OPENFPM_NUMERICS_VECTOR_DIST_STATE_OFP_HPP
+
+#include "config.h"
+#include <array>
+#include <cstdlib>
+#include <vector>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include "OdeIntegrators/OdeIntegrators.hpp"
+
+/*! \brief Pool of buffers used by the temporaries of the odeint steppers
+ *
+ * The steppers allocate their temporary states at the first step (or every time a stepper is created, like in
+ * integrate_adaptive(stepper_type(),...)). Released buffers are kept and reused by the next temporaries, so
+ * after the first step no memory is allocated
+ *
+ * The arena is shared and guarded by a mutex. States can be destroyed after the arena (static states
+ * destroyed at exit), so the states use acquire_buffer and release_buffer: after the destruction of the
+ * arena they allocate and free the buffers directly
+ *
+ */
+class ofp_state_arena
+{
+	//! buffers not in use
+	std::vector<std::vector<double> *> free_buf;
+
+	//! number of buffers allocated
+	size_t n_alloc = 0;
+
+	//! guard of free_buf and n_alloc
+	std::mutex mtx;
+
+	//! true when the arena has been destroyed (constant initialized, valid also after the destruction)
+	static bool & destroyed()
+	{
+		static bool d = false;
+		return d;
+	}
+
+public:
+
+	//! Get the arena
+	static ofp_state_arena & get()
+	{
+		static ofp_state_arena arena;
+		return arena;
+	}
+
+	/*! \brief Get a buffer of size sz from the arena, or a new one if the arena has been destroyed
+	 *
+	 * \param sz size of the buffer
+	 *
+	 * \return the buffer
+	 *
+	 */
+	static std::vector<double> * acquire_buffer(size_t sz)
+	{
+		if (destroyed() == true)
+		{return new std::vector<double>(sz);}
+
+		return get().acquire(sz);
+	}
+
+	/*! \brief Give back a buffer to the arena, or free it if the arena has been destroyed
+	 *
+	 * \param buf buffer
+	 *
+	 */
+	static void release_buffer(std::vector<double> * buf)
+	{
+		if (buf == NULL)
+		{return;}
+
+		if (destroyed() == true)
+		{
+			delete buf;
+			return;
+		}
+
+		get().release(buf);
+	}
+
+	/*! \brief Get a buffer of size sz
+	 *
+	 * \param sz size of the buffer
+	 *
+	 * \return the buffer
+	 *
+	 */
+	std::vector<double> * acquire(size_t sz)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+
+		// prefer a buffer that does not need to grow
+		size_t best = free_buf.size();
+		for (size_t i = 0 ; i < free_buf.size() ; i++)
+		{
+			if (free_buf[i]->capacity() >= sz)
+			{best = i; break;}
+		}
+
+		if (best == free_buf.size() && free_buf.size() != 0)
+		{best = free_buf.size() - 1;}
+
+		std::vector<double> * buf;
+
+		if (best == free_buf.size())
+		{
+			buf = new std::vector<double>();
+			n_alloc++;
+		}
+		else
+		{
+			buf = free_buf[best];
+			free_buf.erase(free_buf.begin() + best);
+		}
+
+		buf->resize(sz);
+		return buf;
+	}
+
+	/*! \brief Give back a buffer
+	 *
+	 * \param buf buffer
+	 *
+	 */
+	void release(std::vector<double> * buf)
+	{
+		if (buf == NULL)
+		{return;}
+
+		std::lock_guard<std::mutex> lock(mtx);
+		free_buf.push_back(buf);
+	}
+
+	//! Number of buffers allocated since the beginning
+	size_t getNAllocated()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return n_alloc;
+	}
+
+	//! Number of buffers ready to be reused
+	size_t getNFree()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return free_buf.size();
+	}
+
+	~ofp_state_arena()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+
+		destroyed() = true;
+
+		for (size_t i = 0 ; i < free_buf.size() ; i++)
+		{delete free_buf[i];}
+
+		free_buf.clear();
+	}
+};
+
+//! One scalar component of a state, the value of the particle p is ptr[p*stride]
+struct ofp_state_column
+{
+	//! first element
+	double * ptr;
+
+	//! distance between two particles
+	size_t stride;
+};
+
+//! Number of scalar components of the properties prp ... of a vector_dist
+template<typename vector_type, unsigned int ... prp>
+struct vector_dist_state_ncomp
+{
+	static const size_t value = 0;
+};
+
+template<typename vector_type, unsigned int p, unsigned int ... prp>
+struct vector_dist_state_ncomp<vector_type,p,prp ...>
+{
+	typedef typename boost::mpl::at<typename vector_type::value_type::type,boost::mpl::int_<p>>::type prop_type;
+
+	static_assert(sizeof(prop_type) % sizeof(double) == 0,"the properties of the state must be made of doubles");
+
+	static const size_t value = sizeof(prop_type) / sizeof(double) + vector_dist_state_ncomp<vector_type,prp ...>::value;
+};
+
+/*! \brief Indicate if the properties of a vector are interleaved (memory_traits_lin)
+ *
+ * With memory_traits_inte (the default layout of the GPU vectors) every component of a vector or tensor
+ * property is stored in its own array, and the state cannot describe a component with one stride
+ *
+ */
+template<typename vector_type>
+struct vector_dist_state_interleaved
+{
+	static const bool value = true;
+};
+
+template<unsigned int dim, typename St, typename prop, typename Decomposition, typename Memory, template<typename> class layout_base, typename ... rest>
+struct vector_dist_state_interleaved<vector_dist<dim,St,prop,Decomposition,Memory,layout_base,rest ...>>
+{
+	static const bool value = !std::is_same<layout_base<prop>,memory_traits_inte<prop>>::value;
+};
+
+//! Fill the columns of the properties prp ... of a vector_dist
+template<typename vector_type, unsigned int ... prp>
+struct vector_dist_state_columns
+{
+	template<typename cols_type>
+	static inline void fill(vector_type & vd, cols_type & cols, size_t c)
+	{}
+};
+
+template<typename vector_type, unsigned int p, unsigned int ... prp>
+struct vector_dist_state_columns<vector_type,p,prp ...>
+{
+	typedef typename boost::mpl::at<typename vector_type::value_type::type,boost::mpl::int_<p>>::type prop_type;
+
+	static_assert(vector_dist_state_interleaved<vector_type>::value == true,"the state support only vector_dist with interleaved properties (memory_traits_lin)");
+
+	template<typename cols_type>
+	static inline void fill(vector_type & vd, cols_type & cols, size_t c)
+	{
+		constexpr size_t nc = sizeof(prop_type) / sizeof(double);
+
+		double * base = (double *)&vd.template getProp<p>(0);
+
+		// the components of a particle are contiguous, the distance between two particles is the size of all the properties
+		size_t stride = nc;
+		if (vd.size_local() > 1)
+		{stride = ((char *)&vd.template getProp<p>(1) - (char *)&vd.template getProp<p>(0)) / sizeof(double);}
+
+		for (size_t j = 0 ; j < nc ; j++)
+		{
+			cols[c + j].ptr = base + j;
+			cols[c + j].stride = stride;
+		}
+
+		vector_dist_state_columns<vector_type,prp ...>::fill(vd,cols,c + nc);
+	}
+};
+
+/*! \brief Odeint state that work directly on the properties of a vector_dist
+ *
+ * The state is a view of the properties prp ... of the local particles, so the integrator update the
+ * particles in place without copying them in and out of a state_type_Nd_ofp. Any number of properties is
+ * supported, vector and tensor properties (of doubles) count as several scalar components.
+ *
+ * The temporaries created by the steppers are not views, they own a buffer taken from ofp_state_arena.
+ *
+ * The size of a view is always the number of local particles. The steppers like runge_kutta4 and cash_karp54
+ * use the initially_resizer, so they resize their temporaries only at the first step. For this reason a temporary
+ * resized like a state on a vector_dist follows the number of local particles of that vector: after a map()
+ * it is reallocated when it is used. Its values are not preserved, so steppers that keep a state between steps
+ * (like the FSAL or multi-step ones) must be reset after a map()
+ *
+ * \verbatim
+   typedef state_type_vd_ofp<decltype(particles),0,1> state_type;
+   state_type x(particles);
+
+   boost::numeric::odeint::runge_kutta4<state_type,double,state_type,double,
+                                        boost::numeric::odeint::vector_space_algebra_vd_ofp> rk4;
+   rk4.do_step(rhs,x,t,dt);
+ * \endverbatim
+ *
+ * \tparam vector_type type of the vector_dist
+ * \tparam prp properties that form the state
+ *
+ */
+template<typename vector_type, unsigned int ... prp>
+class state_type_vd_ofp
+{
+public:
+
+	typedef size_t size_type;
+	typedef int is_state_vector;
+
+	//! number of scalar components for each particle
+	static const size_t ncomp = vector_dist_state_ncomp<vector_type,prp ...>::value;
+
+	//! columns of the state
+	typedef std::array<ofp_state_column,ncomp> columns_type;
+
+private:
+
+	//! vector viewed (NULL if the state own the data)
+	vector_type * vd = NULL;
+
+	//! vector followed by the owned data (NULL if the size is fixed)
+	const vector_type * src = NULL;
+
+	//! owned data (ncomp columns of n elements)
+	mutable std::vector<double> * buf = NULL;
+
+	//! number of particles of the owned data
+	mutable size_t n = 0;
+
+	//! reallocate the owned data if the vector followed changed its number of particles
+	void sync() const
+	{
+		if (src != NULL && (buf == NULL || n != src->size_local()))
+		{
+			ofp_state_arena::release_buffer(buf);
+			buf = ofp_state_arena::acquire_buffer(src->size_local()*ncomp);
+			n = src->size_local();
+		}
+	}
+
+public:
+
+	//! Create a state that own its data (used by the steppers for the temporaries)
+	state_type_vd_ofp()
+	{}
+
+	/*! \brief Create a view on the properties prp ... of the particles
+	 *
+	 * \param vd vector_dist
+	 *
+	 */
+	state_type_vd_ofp(vector_type & vd)
+	:vd(&vd)
+	{}
+
+	//! Copy, the result own a copy of the data
+	state_type_vd_ofp(const state_type_vd_ofp & s)
+	{
+		resize(s.size());
+		copy_values(s);
+	}
+
+	//! Copy the values (a view write into the particles)
+	state_type_vd_ofp & operator=(const state_type_vd_ofp & s)
+	{
+		if (&s == this)
+		{return *this;}
+
+		resize(s.size());
+		copy_values(s);
+
+		return *this;
+	}
+
+	~state_type_vd_ofp()
+	{
+		ofp_state_arena::release_buffer(buf);
+	}
+
+	//! number of particles
+	size_t size() const
+	{
+		if (vd != NULL)
+		{return vd->size_local();}
+
+		return (src != NULL)?src->size_local():n;
+	}
+
+	/*! \brief Resize the state
+	 *
+	 * A view cannot be resized, it follow the number of local particles of the vector
+	 *
+	 * \param sz number of particles
+	 *
+	 */
+	void resize(size_t sz)
+	{
+		if (vd != NULL)
+		{
+			if (sz != vd->size_local())
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " Error: a state on a vector_dist cannot be resized, it has " << vd->size_local() << " particles, requested " << sz << std::endl;
+				abort();
+			}
+
+			return;
+		}
+
+		if (buf != NULL && sz == n)
+		{return;}
+
+		ofp_state_arena::release_buffer(buf);
+		buf = ofp_state_arena::acquire_buffer(sz*ncomp);
+		n = sz;
+	}
+
+	/*! \brief Resize like another state (the steppers resize their temporaries like this)
+	 *
+	 * If s is a state on a vector_dist (or follow one) this state follow the same vector
+	 *
+	 * \param s state
+	 *
+	 */
+	void resizeLike(const state_type_vd_ofp & s)
+	{
+		if (vd == NULL)
+		{src = (s.vd != NULL)?s.vd:s.src;}
+
+		resize(s.size());
+	}
+
+	/*! \brief Check if the state has the size of s and follow the same vector
+	 *
+	 * \param s state
+	 *
+	 * \return true if the state does not need resizeLike(s)
+	 *
+	 */
+	bool sameSize(const state_type_vd_ofp & s) const
+	{
+		if (vd == NULL && src != ((s.vd != NULL)?s.vd:s.src))
+		{return false;}
+
+		return size() == s.size();
+	}
+
+	//! true if the state is a view of the vector_dist properties
+	bool isView() const
+	{
+		return vd != NULL;
+	}
+
+	/*! \brief Get the columns of the state
+	 *
+	 * For a view they must be requested again after the vector change (map, add, ...)
+	 *
+	 * \return the columns
+	 *
+	 */
+	columns_type getColumns() const
+	{
+		columns_type cols;
+
+		if (vd != NULL)
+		{
+			if (vd->size_local() != 0)
+			{vector_dist_state_columns<vector_type,prp ...>::fill(*vd,cols,0);}
+			else
+			{
+				for (size_t c = 0 ; c < ncomp ; c++)
+				{cols[c].ptr = NULL; cols[c].stride = 0;}
+			}
+		}
+		else
+		{
+			sync();
+
+			double * base = (buf != NULL && buf->size() != 0)?buf->data():NULL;
+
+			for (size_t c = 0 ; c < ncomp ; c++)
+			{
+				cols[c].ptr = (base != NULL)?base + c*n:NULL;
+				cols[c].stride = 1;
+			}
+		}
+
+		return cols;
+	}
+
+	/*! \brief Get the scalar component c of the particle p
+	 *
+	 * \param c component
+	 * \param p particle
+	 *
+	 * \return the value
+	 *
+	 */
+	double & get(size_t c, size_t p)
+	{
+		ofp_state_column col = getColumns()[c];
+		return col.ptr[p*col.stride];
+	}
+
+	/*! \brief Write the state into the properties of the vector
+	 *
+	 * It is used in the right hand side when the state is a temporary of the stepper and the operators
+	 * need it on the particles (for example to do a ghost_get)
+	 *
+	 * \param vd_dst vector where to write, it must have the same local particles
+	 *
+	 */
+	template<unsigned int ... prp_dst>
+	void copyTo(vector_type & vd_dst) const
+	{
+		state_type_vd_ofp<vector_type,prp_dst ...> dst(vd_dst);
+		dst.copy_values(*this);
+	}
+
+	/*! \brief Copy the values of another state with the same components
+	 *
+	 * \param s state to copy
+	 *
+	 */
+	template<typename state_type>
+	void copy_values(const state_type & s)
+	{
+		static_assert(state_type::ncomp == ncomp,"the states must have the same number of components");
+
+		if (s.size() != size())
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error: the states have a different number of particles" << std::endl;
+			return;
+		}
+
+		auto cd = getColumns();
+		auto cs = s.getColumns();
+		size_t sz = size();
+
+		for (size_t c = 0 ; c < ncomp ; c++)
+		{
+			ofp_state_column d = cd[c];
+			ofp_state_column o = cs[c];
+
+#ifdef HAVE_OPENMP
+			#pragma omp parallel for schedule(static) if(sz >= 4096)
+#endif
+			for (size_t i = 0 ; i < sz ; i++)
+			{d.ptr[i*d.stride] = o.ptr[i*o.stride];}
+		}
+	}
+};
+
+namespace boost {
+    namespace numeric {
+        namespace odeint {
+
+            template<typename vector_type, unsigned int ... prp>
+            struct is_resizeable<state_type_vd_ofp<vector_type,prp ...>>
+            {
+                typedef boost::true_type type;
+                static const bool value = type::value;
+            };
+
+            template<typename vector_type, unsigned int ... prp>
+            struct same_size_impl<state_type_vd_ofp<vector_type,prp ...>,state_type_vd_ofp<vector_type,prp ...>>
+            {
+                static bool same_size(const state_type_vd_ofp<vector_type,prp ...> &x1, const state_type_vd_ofp<vector_type,prp ...> &x2)
+                {
+                    return x1.sameSize(x2);
+                }
+            };
+
+            //! The temporaries of the steppers follow the vector of the state they are resized like
+            template<typename vector_type, unsigned int ... prp>
+            struct resize_impl<state_type_vd_ofp<vector_type,prp ...>,state_type_vd_ofp<vector_type,prp ...>>
+            {
+                static void resize(state_type_vd_ofp<vector_type,prp ...> &x1, const state_type_vd_ofp<vector_type,prp ...> &x2)
+                {
+                    x1.resizeLike(x2);
+                }
+            };
+
+            template<typename vector_type, unsigned int ... prp>
+            struct vector_space_norm_inf<state_type_vd_ofp<vector_type,prp ...>>
+            {
+                typedef double result_type;
+            };
+
+            /*! \brief Algebra for state_type_vd_ofp
+             *
+             * Every scalar component is processed with one loop over the particles, split across the OpenMP
+             * threads
+             *
+             */
+            struct vector_space_algebra_vd_ofp
+            {
+                //! under this number of particles the loops are serial
+                static const size_t min_par_size = 4096;
+
+                //! Get the value of the particle i in a column
+                static inline double & at(const ofp_state_column & c, size_t i)
+                {
+                    return c.ptr[i*c.stride];
+                }
+
+                //! Apply the operation to all the particles of one component
+                template<typename Op, typename ... C>
+                static inline void loop(Op &op, size_t n, const C & ... c)
+                {
+#ifdef HAVE_OPENMP
+                    #pragma omp parallel for schedule(static) if(n >= min_par_size)
+#endif
+                    for (size_t i = 0 ; i < n ; i++)
+                    {op(at(c,i) ...);}
+                }
+
+                template<typename Op, typename cols_type, size_t ... I>
+                static inline void apply(Op &op, size_t n, const cols_type & cols, size_t c, std::index_sequence<I ...>)
+                {
+                    loop(op,n,std::get<I>(cols)[c] ...);
+                }
+
+                //! Apply the operation to all the components of the states, the first is resized like the second
+                template<typename Op, typename S1, typename ... S>
+                static void for_each_vd(Op &op, S1 &s1, S & ... s)
+                {
+                    resize_first(s1,s ...);
+
+                    size_t n = s1.size();
+
+                    if (n == 0)
+                    {return;}
+
+                    auto cols = std::make_tuple(s1.getColumns(),s.getColumns() ...);
+
+                    for (size_t c = 0 ; c < S1::ncomp ; c++)
+                    {apply(op,n,cols,c,std::index_sequence_for<S1,S ...>());}
+                }
+
+                template<typename S1>
+                static inline void resize_first(S1 &s1)
+                {}
+
+                template<typename S1, typename S2, typename ... S>
+                static inline void resize_first(S1 &s1, S2 &s2, S & ... s)
+                {
+                    if (s1.sameSize(s2) == false)
+                    {s1.resizeLike(s2);}
+                }
+
+                template< class S1 , class Op >
+                static void for_each1( S1 &s1 , Op op )
+                {for_each_vd(op,s1);}
+
+                template< class S1 , class S2 , class Op >
+                static void for_each2( S1 &s1 , S2 &s2 , Op op )
+                {for_each_vd(op,s1,s2);}
+
+                template< class S1 , class S2 , class S3 , class Op >
+                static void for_each3( S1 &s1 , S2 &s2 , S3 &s3 , Op op )
+                {for_each_vd(op,s1,s2,s3);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class Op >
+                static void for_each4( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class Op >
+                static void for_each5( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class Op >
+                static void for_each6( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class Op >
+                static void for_each7( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class Op >
+                static void for_each8( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class Op >
+                static void for_each9( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class Op >
+                static void for_each10( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class Op >
+                static void for_each11( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class Op >
+                static void for_each12( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class Op >
+                static void for_each13( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class S14 , class Op >
+                static void for_each14( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , S14 &s14 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14);}
+
+                template< class S1 , class S2 , class S3 , class S4 , class S5 , class S6 , class S7 , class S8 , class S9 , class S10 , class S11 , class S12 , class S13 , class S14 , class S15 , class Op >
+                static void for_each15( S1 &s1 , S2 &s2 , S3 &s3 , S4 &s4 , S5 &s5 , S6 &s6 , S7 &s7 , S8 &s8 , S9 &s9 , S10 &s10 , S11 &s11 , S12 &s12 , S13 &s13 , S14 &s14 , S15 &s15 , Op op )
+                {for_each_vd(op,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14,s15);}
+
+                /*! \brief Infinity norm of a state
+                 *
+                 * \param s state
+                 *
+                 * \return the maximum absolute value of all the components across all the processors
+                 *
+                 */
+                template< class S >
+                static typename boost::numeric::odeint::vector_space_norm_inf< S >::result_type norm_inf( const S &s )
+                {
+                    double m = 0.0;
+                    size_t n = s.size();
+
+                    if (n != 0)
+                    {
+                        auto cols = s.getColumns();
+
+                        for (size_t c = 0 ; c < S::ncomp ; c++)
+                        {
+                            ofp_state_column col = cols[c];
+
+#ifdef HAVE_OPENMP
+                            #pragma omp parallel for schedule(static) reduction(max:m) if(n >= min_par_size)
+#endif
+                            for (size_t i = 0 ; i < n ; i++)
+                            {
+                                double a = fabs(col.ptr[i*col.stride]);
+                                m = (a > m)?a:m;
+                            }
+                        }
+                    }
+
+                    auto &v_cl = create_vcluster();
+                    v_cl.max(m);
+                    v_cl.execute();
+
+                    return m;
+                }
+            };
+
+        }
+    }
+}
+
+#endif //OPENFPM_NUMERICS_VECTOR_DIST_STATE_OFP_HPP
@@ -11,6 +11,10 @@
 #include "Space/Shape/Point.hpp"
 #include "util/cuda_launch.hpp"
 #include <utility>
+#include <vector>
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
 
 #ifdef SE_CLASS1
 template<bool is_subset>
@@ -363,6 +367,176 @@ struct get_vector_dist_expression_op<2,true>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/*! \brief Runtime configuration of the host evaluation of the vector_dist expressions
+ *
+ * When openfpm is compiled with OpenMP the assignments vd_prop = expr are evaluated in parallel, splitting the
+ * domain particles in contiguous chunks (one for each thread). Every particle is written by one thread
+ * and the expressions (including DCPSE operators and applyKernel_in) only read the right hand side, so the
+ * result is the same of the serial evaluation. The parallel evaluation can be disabled at compile time
+ * defining VECTOR_DIST_OPERATORS_SERIAL, or at runtime with setNThreads(1)
+ *
+ * assign() splits the particles in tiles of assignTileSize() particles, the tiles are distributed
+ * across the threads and every pair of assign is evaluated on the full tile before the next one
+ *
+ */
+struct vector_dist_op_host_config
+{
+	//! number of threads used for the evaluation (0 use the OpenMP default, 1 serial)
+	static int & nThreads()
+	{
+		static int nt = 0;
+		return nt;
+	}
+
+	//! under this number of particles the evaluation is serial
+	static size_t & minParallelSize()
+	{
+		static size_t ms = 4096;
+		return ms;
+	}
+
+	//! number of particles of the tiles evaluated by assign()
+	static size_t & assignTileSize()
+	{
+		static size_t ts = 256;
+		return ts;
+	}
+
+	/*! \brief Set the number of threads used to evaluate the expressions on host
+	 *
+	 * \param nt number of threads (0 use the OpenMP default, 1 serial)
+	 *
+	 */
+	static void setNThreads(int nt)
+	{
+		nThreads() = nt;
+	}
+
+	/*! \brief Set the minimum number of particles for a parallel evaluation
+	 *
+	 * \param ms minimum number of particles
+	 *
+	 */
+	static void setMinParallelSize(size_t ms)
+	{
+		minParallelSize() = ms;
+	}
+
+	/*! \brief Set the number of particles of the tiles evaluated by assign()
+	 *
+	 * \param ts tile size (at least 1)
+	 *
+	 */
+	static void setAssignTileSize(size_t ts)
+	{
+		assignTileSize() = (ts == 0)?1:ts;
+	}
+};
+
+/*! \brief Number of domain particles of a vector (size_local() for vector_dist and subsets, size() for
+ *         the temporal openfpm::vector)
+ *
+ */
+template<typename vector, typename Sfinae = void>
+struct vector_dist_op_domain_size
+{
+	static size_t get(vector & v)
+	{
+		return v.size();
+	}
+};
+
+template<typename vector>
+struct vector_dist_op_domain_size<vector, typename Void<decltype(std::declval<vector>().size_local())>::type>
+{
+	static size_t get(vector & v)
+	{
+		return v.size_local();
+	}
+};
+
+/*! \brief Indicate if a vector is a vector_dist_subset (false for vector_dist and the temporal openfpm::vector)
+ *
+ */
+template<typename vector, typename Sfinae = void>
+struct vector_dist_op_is_subset
+{
+	static const bool value = false;
+};
+
+template<typename vector>
+struct vector_dist_op_is_subset<vector, typename Void<typename vector::is_it_a_subset>::type>
+{
+	static const bool value = vector::is_it_a_subset::value;
+};
+
+/*! \brief Call f(key,key_orig) for all the domain particles of v
+ *
+ * The loop is parallel when OpenMP is available, the vector is big enough and we are not already
+ * inside a parallel region. The domain particles of a subset are not the keys 0..n-1, so for a
+ * subset the keys are first collected with its domain iterator
+ *
+ * \param v vector
+ * \param f functor to call for each particle
+ *
+ */
+template<typename vector, typename functor>
+inline void vector_dist_op_host_loop(vector & v, const functor & f)
+{
+#if defined(HAVE_OPENMP) && !defined(VECTOR_DIST_OPERATORS_SERIAL)
+
+	size_t n = vector_dist_op_domain_size<vector>::get(v);
+	int nt = vector_dist_op_host_config::nThreads();
+
+	if (nt != 1 && n >= vector_dist_op_host_config::minParallelSize() && omp_in_parallel() == 0)
+	{
+		if (nt <= 0)
+		{nt = omp_get_max_threads();}
+
+		std::vector<vect_dist_key_dx> keys;
+
+		if (vector_dist_op_is_subset<typename std::remove_const<vector>::type>::value == true)
+		{
+			keys.reserve(n);
+
+			auto it = v.getDomainIterator();
+
+			while (it.isNext())
+			{
+				keys.push_back(it.get());
+				++it;
+			}
+
+			n = keys.size();
+		}
+
+		#pragma omp parallel for schedule(static) num_threads(nt)
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			vect_dist_key_dx key = (keys.size() != 0)?keys[i]:vect_dist_key_dx(i);
+			auto key_orig = v.getOriginKey(key);
+
+			f(key,key_orig);
+		}
+
+		return;
+	}
+
+#endif
+
+	auto it = v.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		auto key_orig = v.getOriginKey(key);
+
+		f(key,key_orig);
+
+		++it;
+	}
+}
+
 template<unsigned int prp>
 struct vector_dist_op_compute_op<prp,false,comp_host>
 {
@@ -371,17 +545,10 @@ struct vector_dist_op_compute_op<prp,false,comp_host>
 	{
 		v_exp.init();
 
-        auto it = v.getDomainIterator();
-
-        while (it.isNext())
-        {
-                auto key = it.get();
-                auto key_orig = v.getOriginKey(key);
-
-                pos_or_propL<vector,prp>::value(v,key) = v_exp.value(key_orig);
-
-                ++it;
-		}
+		vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
+		{
+			pos_or_propL<vector,prp>::value(v,key) = v_exp.value(key_orig);
+		});
 	}
 
 	template<unsigned int n, typename vector, typename expr>
@@ -397,34 +564,19 @@ struct vector_dist_op_compute_op<prp,false,comp_host>
         SubsetSelector_impl<std::remove_reference<decltype(v)>::type::is_it_a_subset::value>::check(v2,v);
 #endif
 
-		auto it = v.getDomainIterator();
-
-		while (it.isNext())
+		vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
 		{
-			auto key = it.get();
-			auto key_orig = v.getOriginKey(key);
-
 			get_vector_dist_expression_op<n,n == rank_gen<property_act>::type::value>::template assign<prp>(v_exp,v,key,key_orig,comp);
-
-			++it;
-		}
+		});
 	}
 
 	template<typename vector>
 	static void compute_const(vector & v,double d)
 	{
-        auto it = v.getDomainIterator();
-
-        while (it.isNext())
-        {
-                auto key = it.get();
-                auto key_orig = v.getOriginKey(key);
-
-                pos_or_propL<vector,prp>::value(v,key) = d;
-
-                ++it;
-
-		}
+		vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
+		{
+			pos_or_propL<vector,prp>::value(v,key) = d;
+		});
 	}
 };
 
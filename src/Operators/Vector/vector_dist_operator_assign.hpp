@@ -8,6 +8,10 @@
 #ifndef OPENFPM_NUMERICS_SRC_OPERATORS_VECTOR_VECTOR_DIST_OPERATOR_ASSIGN_HPP_
 #define OPENFPM_NUMERICS_SRC_OPERATORS_VECTOR_VECTOR_DIST_OPERATOR_ASSIGN_HPP_
 
+#include <algorithm>
+#include <memory>
+#include <typeinfo>
+
 //! Construct a vector expression from a type T that is already an expression
 //! it does nothing
 template<typename T>
@@ -42,273 +46,606 @@ struct construct_expression<float>
 	}
 };
 
-template<typename prp1, typename expr1, typename prp2, typename expr2> void assign(prp1 & p1, const expr1 & v_e1, prp2 & p2, const expr2 & v_e2)
+/*! \brief Identity of the operand of a node shared by the pairs of assign
+ *
+ * Only a property of a vector has a known identity (the address of the vector, the property is in the type),
+ * any other operand is never shared
+ *
+ */
+template<typename expr>
+struct vector_dist_assign_cse_operand
 {
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
+	//! the operand has no identity
+	static const void * id(const expr & e)
+	{
+		return NULL;
+	}
+};
 
-	v_exp1.init();
-	v_exp2.init();
+template<unsigned int prp, typename vector>
+struct vector_dist_assign_cse_operand<vector_dist_expression<prp,vector>>
+{
+	//! the identity is the address of the vector
+	static const void * id(const vector_dist_expression<prp,vector> & e)
+	{
+		return &e.getVector();
+	}
+};
+
+/*! \brief Memo of the nodes shared by the pairs of assign
+ *
+ * assign evaluates the particles in tiles and every thread has its own memo for the tile it is evaluating.
+ * An expensive node that reads only properties not assigned in the same call (like a DCPSE derivative)
+ * is evaluated with eval(): the nodes with the same type, the same operator object and the same operand
+ * (compared with their runtime addresses) are computed once per particle and reused by the others
+ *
+ * \verbatim
+   assign(f,Dx(P)*Dx(P) + P,
+          g,2.0*Dx(P));
+ * \endverbatim
+ *
+ * Here Dx(P) is computed once for each particle. Out of assign eval() just compute the node
+ *
+ */
+class vector_dist_assign_cse
+{
+	//! memo of one node on the particles of the tile
+	struct slot_base
+	{
+		//! type of the node
+		const std::type_info * node;
 
-	auto it = p1.getVector().getDomainIterator();
+		//! type of the value
+		const std::type_info * value;
 
-	while (it.isNext())
+		//! operator object
+		const void * op;
+
+		//! operand
+		const void * operand;
+
+		//! particle of the value stored at each position of the tile
+		std::vector<size_t> key;
+
+		//! tile of the value stored at each position of the tile
+		std::vector<size_t> tile;
+
+		virtual ~slot_base()
+		{}
+	};
+
+	//! memo of one node with its values
+	template<typename T>
+	struct slot : public slot_base
 	{
-		auto key = it.get();
+		//! value at each position of the tile
+		std::vector<T> val;
+	};
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
+	//! memo of the nodes
+	std::vector<std::unique_ptr<slot_base>> slots;
 
-		++it;
-	}
-}
+	//! number of particles in a tile
+	size_t tile_size;
 
-template<typename prp1, typename expr1, typename prp2, typename expr2, typename prp3, typename expr3> void assign(prp1 & p1, const expr1 & v_e1, prp2 & p2, const expr2 & v_e2, prp3 & p3, const expr3 & v_e3)
-{
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
+	//! current tile (0 no tile)
+	size_t tile_id = 0;
+
+	//! position of the particle in the tile
+	size_t pos = 0;
 
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
+	//! number of nodes computed
+	size_t n_eval = 0;
 
-	auto it = p1.getVector().getDomainIterator();
+	//! number of nodes reused
+	size_t n_reuse = 0;
 
-	while (it.isNext())
+	//! memo of the thread (NULL out of assign)
+	static vector_dist_assign_cse * & active()
 	{
-		auto key = it.get();
+		static thread_local vector_dist_assign_cse * c = NULL;
+		return c;
+	}
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
+	//! total number of computed nodes in the last assign
+	static size_t & lastNEval()
+	{
+		static size_t n = 0;
+		return n;
+	}
 
-		++it;
+	//! total number of reused nodes in the last assign
+	static size_t & lastNReuse()
+	{
+		static size_t n = 0;
+		return n;
 	}
-}
 
-template<typename prp1, typename expr1,
-		 typename prp2, typename expr2,
-		 typename prp3, typename expr3,
-		 typename prp4, typename expr4>
-void assign(prp1 & p1, const expr1 & v_e1,
-			prp2 & p2, const expr2 & v_e2,
-			prp3 & p3, const expr3 & v_e3,
-			prp4 & p4, const expr4 & v_e4)
-{
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
-	auto v_exp4 = construct_expression<expr4>::construct(v_e4);
+	//! number of tiles in the last assign
+	static size_t & lastNTiles()
+	{
+		static size_t n = 0;
+		return n;
+	}
 
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
-	v_exp4.init();
+	/*! \brief Return the value of a node from the memo, computing it if needed
+	 *
+	 * \param node type of the node
+	 * \param op operator object
+	 * \param operand operand
+	 * \param key particle
+	 * \param f compute the node
+	 *
+	 */
+	template<typename T, typename functor>
+	T get(const std::type_info & node, const void * op, const void * operand, size_t key, const functor & f)
+	{
+		slot<T> * s = NULL;
+
+		for (size_t i = 0 ; i < slots.size() ; i++)
+		{
+			slot_base & sb = *slots[i];
+
+			if (sb.op == op && sb.operand == operand && *sb.node == node && *sb.value == typeid(T))
+			{
+				s = static_cast<slot<T> *>(&sb);
+				break;
+			}
+		}
+
+		if (s == NULL)
+		{
+			s = new slot<T>();
+			slots.push_back(std::unique_ptr<slot_base>(s));
+
+			s->node = &node;
+			s->value = &typeid(T);
+			s->op = op;
+			s->operand = operand;
+			s->key.resize(tile_size);
+			s->tile.resize(tile_size,0);
+			s->val.resize(tile_size);
+		}
+
+		// The same node can be evaluated on other particles (Dx(Dy(P)) evaluate Dy(P) on the neighborhood)
+		if (s->tile[pos] == tile_id && s->key[pos] == key)
+		{
+			n_reuse++;
+			return s->val[pos];
+		}
+
+		s->val[pos] = f();
+		s->tile[pos] = tile_id;
+		s->key[pos] = key;
+		n_eval++;
+
+		return s->val[pos];
+	}
+
+public:
 
-	auto it = p1.getVector().getDomainIterator();
+	/*! \brief Constructor
+	 *
+	 * \param tile_size number of particles in a tile
+	 *
+	 */
+	vector_dist_assign_cse(size_t tile_size)
+	:tile_size(tile_size)
+	{}
 
-	while (it.isNext())
+	//! Use this memo for the nodes evaluated by this thread
+	void start()
 	{
-		auto key = it.get();
+		active() = this;
+	}
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
-		pos_or_propL<typename prp4::vtype,prp4::prop>::value(p4.getVector(),key) = v_exp4.value(key);
+	//! Stop using the memo
+	void stop()
+	{
+		active() = NULL;
+	}
 
-		++it;
+	//! Start a new tile, all the stored values become invalid
+	void newTile()
+	{
+		tile_id++;
+	}
+
+	/*! \brief Set the position in the tile of the particle evaluated
+	 *
+	 * \param p position
+	 *
+	 */
+	void setPos(size_t p)
+	{
+		pos = p;
 	}
-}
 
+	//! Number of nodes computed
+	size_t getNEval() const
+	{
+		return n_eval;
+	}
 
-template<typename prp1, typename expr1,
-		 typename prp2, typename expr2,
-		 typename prp3, typename expr3,
-		 typename prp4, typename expr4,
-		 typename prp5, typename expr5>
-void assign(prp1 & p1, const expr1 & v_e1,
-			prp2 & p2, const expr2 & v_e2,
-			prp3 & p3, const expr3 & v_e3,
-			prp4 & p4, const expr4 & v_e4,
-			prp5 & p5, const expr5 & v_e5)
-{
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
-	auto v_exp4 = construct_expression<expr4>::construct(v_e4);
-	auto v_exp5 = construct_expression<expr5>::construct(v_e5);
+	//! Number of nodes reused from the memo
+	size_t getNReuse() const
+	{
+		return n_reuse;
+	}
+
+	/*! \brief Set the statistics of the last assign
+	 *
+	 * \param n_eval number of nodes computed
+	 * \param n_reuse number of nodes reused
+	 * \param n_tiles number of tiles
+	 *
+	 */
+	static void setLastStats(size_t n_eval, size_t n_reuse, size_t n_tiles)
+	{
+		lastNEval() = n_eval;
+		lastNReuse() = n_reuse;
+		lastNTiles() = n_tiles;
+	}
 
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
-	v_exp4.init();
-	v_exp5.init();
+	//! Number of shared nodes computed by the last assign (on this processor)
+	static size_t getLastNEval()
+	{
+		return lastNEval();
+	}
 
-	auto it = p1.getVector().getDomainIterator();
+	//! Number of shared nodes reused by the last assign (on this processor)
+	static size_t getLastNReuse()
+	{
+		return lastNReuse();
+	}
 
-	while (it.isNext())
+	//! Number of tiles evaluated by the last assign (on this processor)
+	static size_t getLastNTiles()
 	{
-		auto key = it.get();
+		return lastNTiles();
+	}
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
-		pos_or_propL<typename prp4::vtype,prp4::prop>::value(p4.getVector(),key) = v_exp4.value(key);
-		pos_or_propL<typename prp5::vtype,prp5::prop>::value(p5.getVector(),key) = v_exp5.value(key);
+	/*! \brief Evaluate a node that can be shared by the pairs of assign
+	 *
+	 * \tparam T value type
+	 * \tparam node_type type of the node
+	 * \tparam operand_type type of the operand
+	 *
+	 * \param op operator object of the node
+	 * \param o1 operand of the node
+	 * \param key particle
+	 * \param f compute the node
+	 *
+	 * \return the value of the node
+	 *
+	 */
+	template<typename T, typename node_type, typename operand_type, typename functor>
+	static inline T eval(const void * op, const operand_type & o1, size_t key, const functor & f)
+	{
+		vector_dist_assign_cse * c = active();
+		const void * operand = vector_dist_assign_cse_operand<operand_type>::id(o1);
+
+		if (c == NULL || operand == NULL)
+		{return f();}
 
-		++it;
+		return c->template get<T>(typeid(node_type),op,operand,key,f);
 	}
-}
+};
 
-template<typename prp1, typename expr1,
-		 typename prp2, typename expr2,
-		 typename prp3, typename expr3,
-		 typename prp4, typename expr4,
-		 typename prp5, typename expr5,
-		 typename prp6, typename expr6>
-void assign(prp1 & p1, const expr1 & v_e1,
-			prp2 & p2, const expr2 & v_e2,
-			prp3 & p3, const expr3 & v_e3,
-			prp4 & p4, const expr4 & v_e4,
-			prp5 & p5, const expr5 & v_e5,
-			prp6 & p6, const expr6 & v_e6)
+//! End of the list of assignments
+struct vector_dist_assign_list_end
+{
+	//! nothing to initialize
+	inline void init() const
+	{}
+
+	//! nothing to assign
+	template<typename key_type>
+	__device__ __host__ inline void assign(const key_type & key)
+	{}
+
+	//! nothing to assign
+	__device__ inline void assign_ker(const unsigned int & p)
+	{}
+
+	//! nothing to assign
+	template<typename key_type, typename key_orig_type>
+	inline void assign_tile(const key_type * key, const key_orig_type * key_orig, size_t n, vector_dist_assign_cse & cse)
+	{}
+};
+
+/*! \brief List of (property,expression) pairs evaluated by assign in one pass over the particles
+ *
+ * For each particle the pairs are evaluated in order, so an expression can read (on the same particle)
+ * a property assigned by a previous pair. This can be used to compute once an operand shared by several
+ * expressions, like a DCPSE derivative
+ *
+ * \verbatim
+   assign(dx,Dx(P),
+          f,dx*dx + P,
+          g,2.0*dx);
+ * \endverbatim
+ *
+ * Expressions that read the neighborhood of a particle (DCPSE, applyKernel_in) must not use properties
+ * assigned in the same call. On host the pairs are evaluated tile by tile: every pair is evaluated on all
+ * the particles of the tile before the next pair, and the DCPSE derivatives shared by the pairs are computed
+ * once (see vector_dist_assign_cse)
+ *
+ * \tparam prp_type property expression to assign
+ * \tparam expr_type expression to evaluate
+ * \tparam next_type rest of the list
+ *
+ */
+template<typename prp_type, typename expr_type, typename next_type>
+struct vector_dist_assign_list
 {
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
-	auto v_exp4 = construct_expression<expr4>::construct(v_e4);
-	auto v_exp5 = construct_expression<expr5>::construct(v_e5);
-	auto v_exp6 = construct_expression<expr6>::construct(v_e6);
-
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
-	v_exp4.init();
-	v_exp5.init();
-	v_exp6.init();
-
-	auto it = p1.getVector().getDomainIterator();
-
-	while (it.isNext())
+	//! type of the vector to assign
+	typedef typename prp_type::vtype vtype;
+
+	//! vector to assign (a copy for kernel vectors)
+	typename vector_expression_transform<vtype>::type v;
+
+	//! expression to evaluate
+	expr_type e;
+
+	//! rest of the list
+	next_type next;
+
+	vector_dist_assign_list(prp_type & p, const expr_type & e, const next_type & next)
+	:v(p.getVector()),e(e),next(next)
+	{}
+
+	//! initialize all the expressions of the list
+	inline void init() const
 	{
-		auto key = it.get();
+		e.init();
+		next.init();
+	}
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
-		pos_or_propL<typename prp4::vtype,prp4::prop>::value(p4.getVector(),key) = v_exp4.value(key);
-		pos_or_propL<typename prp5::vtype,prp5::prop>::value(p5.getVector(),key) = v_exp5.value(key);
-		pos_or_propL<typename prp6::vtype,prp6::prop>::value(p6.getVector(),key) = v_exp6.value(key);
+	/*! \brief Evaluate all the expressions of the list on a particle
+	 *
+	 * \param key particle
+	 *
+	 */
+	template<typename key_type>
+	__device__ __host__ inline void assign(const key_type & key)
+	{
+		pos_or_propL<vtype,prp_type::prop>::value(v,key) = e.value(key);
+		next.assign(key);
+	}
 
-		++it;
+	/*! \brief Evaluate all the expressions of the list on a particle of a kernel-side vector
+	 *
+	 * \param p particle
+	 *
+	 */
+	__device__ inline void assign_ker(const unsigned int & p)
+	{
+		pos_or_propL_ker<vtype,prp_type::prop>::value(v,p) = e.value(p);
+		next.assign_ker(p);
 	}
+
+	/*! \brief Evaluate all the expressions of the list on a tile of particles
+	 *
+	 * \param key particles of the tile
+	 * \param key_orig particles of the tile in the original vector (different for subsets)
+	 * \param n number of particles in the tile
+	 * \param cse memo of the shared nodes
+	 *
+	 */
+	template<typename key_type, typename key_orig_type>
+	inline void assign_tile(const key_type * key, const key_orig_type * key_orig, size_t n, vector_dist_assign_cse & cse)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			cse.setPos(i);
+			pos_or_propL<vtype,prp_type::prop>::value(v,key[i]) = e.value(key_orig[i]);
+		}
+
+		next.assign_tile(key,key_orig,n,cse);
+	}
+};
+
+//! Create an empty list of assignments
+inline vector_dist_assign_list_end vector_dist_assign_make_list()
+{
+	return vector_dist_assign_list_end();
 }
 
+/*! \brief Create the list of assignments from the (property,expression) pairs
+ *
+ * \param p1 property to assign
+ * \param v_e1 expression or constant
+ * \param rest other pairs
+ *
+ * \return the list of assignments
+ *
+ */
+template<typename prp1, typename expr1, typename ... pairs>
+inline auto vector_dist_assign_make_list(prp1 & p1, const expr1 & v_e1, pairs && ... rest)
+{
+	typedef typename std::remove_const<typename std::remove_reference<decltype(construct_expression<expr1>::construct(v_e1))>::type>::type expr_type;
+
+	auto next = vector_dist_assign_make_list(rest ...);
+
+	return vector_dist_assign_list<prp1,expr_type,decltype(next)>(p1,construct_expression<expr1>::construct(v_e1),next);
+}
 
+#ifdef __NVCC__
 
-template<typename prp1, typename expr1,
-		 typename prp2, typename expr2,
-		 typename prp3, typename expr3,
-		 typename prp4, typename expr4,
-		 typename prp5, typename expr5,
-		 typename prp6, typename expr6,
-		 typename prp7, typename expr7>
-void assign(prp1 & p1, const expr1 & v_e1,
-			prp2 & p2, const expr2 & v_e2,
-			prp3 & p3, const expr3 & v_e3,
-			prp4 & p4, const expr4 & v_e4,
-			prp5 & p5, const expr5 & v_e5,
-			prp6 & p6, const expr6 & v_e6,
-			prp7 & p7, const expr7 & v_e7)
+template<typename vector, typename assign_list>
+__global__ void assign_ker(vector vd, assign_list al)
 {
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
-	auto v_exp4 = construct_expression<expr4>::construct(v_e4);
-	auto v_exp5 = construct_expression<expr5>::construct(v_e5);
-	auto v_exp6 = construct_expression<expr6>::construct(v_e6);
-	auto v_exp7 = construct_expression<expr7>::construct(v_e7);
-
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
-	v_exp4.init();
-	v_exp5.init();
-	v_exp6.init();
-	v_exp7.init();
-
-	auto it = p1.getVector().getDomainIterator();
-
-	while (it.isNext())
-	{
-		auto key = it.get();
+	unsigned int p = threadIdx.x + blockIdx.x * blockDim.x;
+
+	if (p >= vd.size_local())	{return;}
+
+	al.assign_ker(p);
+}
 
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
-		pos_or_propL<typename prp4::vtype,prp4::prop>::value(p4.getVector(),key) = v_exp4.value(key);
-		pos_or_propL<typename prp5::vtype,prp5::prop>::value(p5.getVector(),key) = v_exp5.value(key);
-		pos_or_propL<typename prp6::vtype,prp6::prop>::value(p6.getVector(),key) = v_exp6.value(key);
-		pos_or_propL<typename prp7::vtype,prp7::prop>::value(p7.getVector(),key) = v_exp7.value(key);
+#endif
 
-		++it;
+/*! \brief Evaluate a tile of particles
+ *
+ * \param v vector
+ * \param keys domain particles (empty if they are 0..n-1)
+ * \param start first particle of the tile
+ * \param stop end of the tile
+ * \param key buffer for the particles of the tile
+ * \param key_orig buffer for the particles of the tile in the original vector
+ * \param cse memo of the shared nodes
+ * \param al list of assignments
+ *
+ */
+template<typename vector, typename assign_list>
+inline void vector_dist_assign_tile(vector & v, const std::vector<vect_dist_key_dx> & keys, size_t start, size_t stop,
+		                            std::vector<vect_dist_key_dx> & key, std::vector<vect_dist_key_dx> & key_orig,
+		                            vector_dist_assign_cse & cse, assign_list & al)
+{
+	for (size_t i = start ; i < stop ; i++)
+	{
+		key[i - start] = (keys.size() != 0)?keys[i]:vect_dist_key_dx(i);
+		key_orig[i - start] = v.getOriginKey(key[i - start]);
 	}
+
+	cse.newTile();
+	al.assign_tile(key.data(),key_orig.data(),stop - start,cse);
 }
 
+//! Evaluate a list of assignments on host
+template<bool is_ker>
+struct vector_dist_assign_compute
+{
+	/*! \brief Evaluate the list tile by tile
+	 *
+	 * The tiles are distributed across the threads when OpenMP is available, the vector is big enough
+	 * and we are not already inside a parallel region (see vector_dist_op_host_loop)
+	 *
+	 */
+	template<typename vector, typename assign_list>
+	static void compute(vector & v, assign_list & al)
+	{
+		size_t tile = vector_dist_op_host_config::assignTileSize();
+		size_t n = vector_dist_op_domain_size<vector>::get(v);
+
+		// The domain particles of a subset are not the keys 0..n-1
+		std::vector<vect_dist_key_dx> keys;
 
-template<typename prp1, typename expr1,
-		 typename prp2, typename expr2,
-		 typename prp3, typename expr3,
-		 typename prp4, typename expr4,
-		 typename prp5, typename expr5,
-		 typename prp6, typename expr6,
-		 typename prp7, typename expr7,
-		 typename prp8, typename expr8>
-void assign(prp1 & p1, const expr1 & v_e1,
-			prp2 & p2, const expr2 & v_e2,
-			prp3 & p3, const expr3 & v_e3,
-			prp4 & p4, const expr4 & v_e4,
-			prp5 & p5, const expr5 & v_e5,
-			prp6 & p6, const expr6 & v_e6,
-			prp7 & p7, const expr7 & v_e7,
-			prp8 & p8, const expr8 & v_e8)
+		if (vector_dist_op_is_subset<typename std::remove_const<vector>::type>::value == true)
+		{
+			keys.reserve(n);
+
+			auto it = v.getDomainIterator();
+
+			while (it.isNext())
+			{
+				keys.push_back(it.get());
+				++it;
+			}
+
+			n = keys.size();
+		}
+
+		size_t n_tiles = (n + tile - 1) / tile;
+		size_t n_eval = 0;
+		size_t n_reuse = 0;
+
+#if defined(HAVE_OPENMP) && !defined(VECTOR_DIST_OPERATORS_SERIAL)
+
+		int nt = vector_dist_op_host_config::nThreads();
+
+		if (nt != 1 && n >= vector_dist_op_host_config::minParallelSize() && omp_in_parallel() == 0)
+		{
+			if (nt <= 0)
+			{nt = omp_get_max_threads();}
+
+			#pragma omp parallel num_threads(nt) reduction(+:n_eval,n_reuse)
+			{
+				std::vector<vect_dist_key_dx> key(tile);
+				std::vector<vect_dist_key_dx> key_orig(tile);
+				vector_dist_assign_cse cse(tile);
+
+				cse.start();
+
+				#pragma omp for schedule(static)
+				for (size_t t = 0 ; t < n_tiles ; t++)
+				{vector_dist_assign_tile(v,keys,t*tile,std::min(t*tile + tile,n),key,key_orig,cse,al);}
+
+				cse.stop();
+
+				n_eval += cse.getNEval();
+				n_reuse += cse.getNReuse();
+			}
+
+			vector_dist_assign_cse::setLastStats(n_eval,n_reuse,n_tiles);
+
+			return;
+		}
+
+#endif
+
+		std::vector<vect_dist_key_dx> key(tile);
+		std::vector<vect_dist_key_dx> key_orig(tile);
+		vector_dist_assign_cse cse(tile);
+
+		cse.start();
+
+		for (size_t t = 0 ; t < n_tiles ; t++)
+		{vector_dist_assign_tile(v,keys,t*tile,std::min(t*tile + tile,n),key,key_orig,cse,al);}
+
+		cse.stop();
+
+		vector_dist_assign_cse::setLastStats(cse.getNEval(),cse.getNReuse(),n_tiles);
+	}
+};
+
+//! Evaluate a list of assignments on device
+template<>
+struct vector_dist_assign_compute<true>
 {
-	auto v_exp1 = construct_expression<expr1>::construct(v_e1);
-	auto v_exp2 = construct_expression<expr2>::construct(v_e2);
-	auto v_exp3 = construct_expression<expr3>::construct(v_e3);
-	auto v_exp4 = construct_expression<expr4>::construct(v_e4);
-	auto v_exp5 = construct_expression<expr5>::construct(v_e5);
-	auto v_exp6 = construct_expression<expr6>::construct(v_e6);
-	auto v_exp7 = construct_expression<expr7>::construct(v_e7);
-	auto v_exp8 = construct_expression<expr8>::construct(v_e8);
-
-	v_exp1.init();
-	v_exp2.init();
-	v_exp3.init();
-	v_exp4.init();
-	v_exp5.init();
-	v_exp6.init();
-	v_exp7.init();
-	v_exp8.init();
-
-	auto it = p1.getVector().getDomainIterator();
-
-	while (it.isNext())
+	template<typename vector, typename assign_list>
+	static void compute(vector & v, assign_list & al)
 	{
-		auto key = it.get();
-
-		pos_or_propL<typename prp1::vtype,prp1::prop>::value(p1.getVector(),key) = v_exp1.value(key);
-		pos_or_propL<typename prp2::vtype,prp2::prop>::value(p2.getVector(),key) = v_exp2.value(key);
-		pos_or_propL<typename prp3::vtype,prp3::prop>::value(p3.getVector(),key) = v_exp3.value(key);
-		pos_or_propL<typename prp4::vtype,prp4::prop>::value(p4.getVector(),key) = v_exp4.value(key);
-		pos_or_propL<typename prp5::vtype,prp5::prop>::value(p5.getVector(),key) = v_exp5.value(key);
-		pos_or_propL<typename prp6::vtype,prp6::prop>::value(p6.getVector(),key) = v_exp6.value(key);
-		pos_or_propL<typename prp7::vtype,prp7::prop>::value(p7.getVector(),key) = v_exp7.value(key);
-		pos_or_propL<typename prp8::vtype,prp8::prop>::value(p8.getVector(),key) = v_exp8.value(key);
-
-		++it;
+#ifdef __NVCC__
+		auto ite = v.getDomainIteratorGPU(256);
+
+		CUDA_LAUNCH((assign_ker),ite,v,al);
+#else
+		std::cout << __FILE__ << ":" << __LINE__ << " error: assign on device vectors require compiling with NVCC" << std::endl;
+#endif
 	}
+};
+
+/*! \brief Assign several expressions to several properties with one pass over the particles
+ *
+ * \verbatim
+   assign(v1,expr1,
+          v2,expr2,
+          ...);
+ * \endverbatim
+ *
+ * Any number of (property,expression) pairs can be given, expressions can also be constants. On host the
+ * pass over the particles is done in tiles distributed across the OpenMP threads (see vector_dist_op_host_config)
+ * and the DCPSE derivatives used by more pairs are computed once for each particle (see vector_dist_assign_cse).
+ * On device the pass is a single kernel
+ *
+ * \param p1 first property to assign
+ * \param v_e1 first expression
+ * \param p2 second property to assign
+ * \param v_e2 second expression
+ * \param rest other (property,expression) pairs
+ *
+ */
+template<typename prp1, typename expr1, typename prp2, typename expr2, typename ... pairs>
+void assign(prp1 & p1, const expr1 & v_e1, prp2 & p2, const expr2 & v_e2, pairs && ... rest)
+{
+	static_assert(sizeof...(pairs) % 2 == 0,"assign require (property,expression) pairs");
+
+	auto al = vector_dist_assign_make_list(p1,v_e1,p2,v_e2,rest ...);
+
+	al.init();
+
+	vector_dist_assign_compute<has_vector_kernel<typename prp1::vtype>::type::value>::compute(p1.getVector(),al);
 }
 
 #endif /* OPENFPM_NUMERICS_SRC_OPERATORS_VECTOR_VECTOR_DIST_OPERATOR_ASSIGN_HPP_ */
@@ -1355,7 +1355,35 @@ public:
 		return v;
 	}
 
-	/*! \brief Fill the vector property with the double
+	/*! \brief Copy the values of another temporal
+	 *
+	 * The values and the variable id are copied in place, the internal vector is reallocated only if it
+	 * has to grow. This is the assignment used by odeint to copy the states, so the stepper temporaries
+	 * are allocated only once
+	 *
+	 * \param v_exp temporal to copy
+	 *
+	 * \return the internal vector
+	 *
+	 */
+	vector & operator=(const vector_dist_expression<0,openfpm::vector<aggregate<T>>> & v_exp)
+	{
+		if (&v_exp == this)
+		{return v;}
+
+		var_id = v_exp.var_id;
+
+		v.resize(v_exp.v.size());
+
+		if (v.size() != 0)
+		{std::copy(v_exp.begin(),v_exp.end(),begin());}
+
+		return v;
+	}
+
+	/*! \brief Fill the temporal with a constant
+	 *
+	 * The size of the temporal does not change
 	 *
 	 * \param d value to fill
 	 *
@@ -1364,7 +1392,10 @@ public:
 	 */
 	vector & operator=(double d)
 	{
-		std::cout << __FILE__ << ":" << __LINE__ << " Error: temporal with constants is unsupported" << std::endl;
+		if (v.size() != 0)
+		{std::fill(begin(),end(),d);}
+
+		return v;
 	}
 
 
@@ -1583,17 +1614,10 @@ public:
         SubsetSelector_impl<std::remove_reference<decltype(v)>::type::is_it_a_subset::value>::check(v2,v);
 #endif*/
 
-        auto it = v.getDomainIterator();
-
-        while (it.isNext())
+        vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
         {
-            auto key = it.get();
-            auto key_orig = v.getOriginKey(key);
-
             get_vector_dist_expression_op<n,n == rank_gen<property_act>::type::value>::template assign<exp1::prop>(v_exp,v,key,key_orig,comp);
-
-            ++it;
-        }
+        });
 
         return v;
     }
@@ -1615,17 +1639,10 @@ public:
 
         SubsetSelector_impl<std::remove_reference<decltype(v)>::type::is_it_a_subset::value>::check(v2,v);
 #endif
-		auto it = v.getDomainIterator();
-
-		while (it.isNext())
+		vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
 		{
-			auto key = it.get();
-			auto key_orig = v.getOriginKey(key);
-
 			get_vector_dist_expression_op<n,n == rank_gen<property_act>::type::value>::template assign<exp1::prop>(v_exp,v,key,key_orig,comp);
-
-			++it;
-		}
+		});
 
 		return v;
 	}
@@ -1672,18 +1689,11 @@ public:
 	{
 		auto & v = getVector();
 
-		auto it = v.getDomainIterator();
-
-		while (it.isNext())
+		vector_dist_op_host_loop(v,[&](const auto & key, const auto & key_orig)
 		{
-			auto key = it.get();
-
 			//pos_or_propL<vtype,exp1::prp>::value(v,key) = d;
 			get_vector_dist_expression_op<n,n == rank_gen<property_act>::type::value>::template assign_double<exp1::prop>(d,v,key,comp);
-
-
-			++it;
-		}
+		});
 
 		return v;
 	}
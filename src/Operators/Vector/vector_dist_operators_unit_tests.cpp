@@ -12,6 +12,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "tests/vector_dist_operators_tests_util.hpp"
+#include "Vector/vector_dist_subset.hpp"
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -39,6 +40,189 @@ BOOST_AUTO_TEST_CASE( vector_dist_operators_test )
 	check_all_expressions<comp_host>::check(vd);
 }
 
+BOOST_AUTO_TEST_CASE( vector_dist_operators_host_threads_test )
+{
+	if (create_vcluster().getProcessingUnits() > 3)
+		return;
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_type vd(2048,box,bc,ghost);
+
+	fill_values<comp_host>(vd);
+
+	vd.map();
+	vd.template ghost_get<0,1,2,3,4,5,6>();
+
+	auto vA = getV<A>(vd);
+	auto vB = getV<B>(vd);
+	auto vC = getV<C>(vd);
+	auto vVA = getV<VA>(vd);
+	auto vVB = getV<VB>(vd);
+	auto vVC = getV<VC>(vd);
+	auto vTA = getV<TA>(vd);
+
+	auto cl = vd.getCellList(0.05);
+	exp_kernel ker(0.2);
+
+	// force the parallel evaluation also on small vectors
+	size_t ms_old = vector_dist_op_host_config::minParallelSize();
+	vector_dist_op_host_config::setMinParallelSize(0);
+
+	auto collect = [&](std::vector<float> & res)
+	{
+		res.clear();
+
+		auto it = vd.getDomainIterator();
+		while (it.isNext())
+		{
+			auto p = it.get();
+
+			res.push_back(vd.template getProp<A>(p));
+			res.push_back(vd.template getProp<B>(p));
+			res.push_back(vd.template getProp<TA>(p));
+
+			for (size_t i = 0 ; i < 3 ; i++)
+			{res.push_back(vd.template getProp<VA>(p)[i]);}
+
+			++it;
+		}
+	};
+
+	std::vector<float> res[2];
+
+	// nt = 1 serial, nt = 0 all the OpenMP threads
+	for (int nt = 1 ; nt >= 0 ; nt--)
+	{
+		vector_dist_op_host_config::setNThreads(nt);
+
+		vA = applyKernel_in(vVC * vVB + norm(vVB),vd,cl,ker) + vC;
+		vVA = applyKernel_in(2.0*vVC + vVB ,vd,cl,ker) + vVC;
+		vB = exp(vC) * vA + 2.0 * norm(vVA);
+		vVA[1] = vVB[0] + vC;
+		vTA = 3.0;
+
+		collect(res[nt]);
+	}
+
+	vector_dist_op_host_config::setNThreads(0);
+	vector_dist_op_host_config::setMinParallelSize(ms_old);
+
+	// every particle is evaluated independently, so the results must be exactly the same
+	BOOST_REQUIRE_EQUAL(res[0].size(),res[1].size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < res[0].size() ; i++)
+	{match &= (res[0][i] == res[1][i]);}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_operators_host_threads_subset_test )
+{
+	if (create_vcluster().getProcessingUnits() > 3)
+		return;
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_dist_ws<3,float,aggregate<float,float,float>> vd(0,box,bc,ghost);
+
+	// one particle every three is in the subset 0, so the subset is not the first keys of vd
+	auto & v_cl = create_vcluster();
+
+	for (size_t i = 0 ; i < 3000 ; i++)
+	{
+		if (v_cl.getProcessUnitID() != 0)
+		{break;}
+
+		vd.add();
+
+		for (size_t d = 0 ; d < 3 ; d++)
+		{vd.getLastPos()[d] = (float)rand() / (float)RAND_MAX;}
+
+		vd.template getLastProp<B>() = (float)i;
+		vd.template getLastProp<C>() = (float)(i % 7);
+
+		vd.getLastSubset((i % 3 == 0)?0:1);
+	}
+
+	vd.map();
+
+	vector_dist_subset<3,float,aggregate<float,float,float>> vd_sub(vd,0);
+
+	auto vA = getV<A>(vd);
+	auto vB = getV<B>(vd);
+	auto vC = getV<C>(vd);
+	auto vA_sub = getV<A>(vd_sub);
+
+	// force the parallel evaluation also on small vectors
+	size_t ms_old = vector_dist_op_host_config::minParallelSize();
+	vector_dist_op_host_config::setMinParallelSize(0);
+
+	std::vector<float> res[2];
+
+	// nt = 1 serial, nt = 0 all the OpenMP threads
+	for (int nt = 1 ; nt >= 0 ; nt--)
+	{
+		vector_dist_op_host_config::setNThreads(nt);
+
+		vA = -1.0;
+		vA_sub = 2.0 * vB + vC;
+
+		res[nt].clear();
+
+		auto it = vd.getDomainIterator();
+		while (it.isNext())
+		{
+			auto p = it.get();
+
+			res[nt].push_back(vd.template getProp<A>(p));
+
+			++it;
+		}
+	}
+
+	vector_dist_op_host_config::setNThreads(0);
+	vector_dist_op_host_config::setMinParallelSize(ms_old);
+
+	BOOST_REQUIRE_EQUAL(res[0].size(),res[1].size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < res[0].size() ; i++)
+	{match &= (res[0][i] == res[1][i]);}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// only the particles of the subset are written
+	bool sub_ok = true;
+	auto it = vd.getDomainIterator();
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		if ((size_t)vd.template getProp<B>(p) % 3 == 0)
+		{sub_ok &= (vd.template getProp<A>(p) == 2.0f * vd.template getProp<B>(p) + vd.template getProp<C>(p));}
+		else
+		{sub_ok &= (vd.template getProp<A>(p) == -1.0f);}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(sub_ok,true);
+}
+
 
 void reset(vector_dist<3,float,aggregate<float,float,float,float,float,float,float,float>> & v1)
 {
@@ -214,6 +398,147 @@ BOOST_AUTO_TEST_CASE( vector_dist_operators_assign_test )
 	// Self assign;
 	assign(v_pos,v_pos,
 		   v_pos,v_pos);
+
+	// More pairs than properties, the pairs are evaluated in order
+	reset(vd);
+
+	assign(v1,0.0,
+		   v2,1.0,
+		   v3,2.0,
+		   v4,3.0,
+		   v5,4.0,
+		   v6,5.0,
+		   v7,6.0,
+		   v8,7.0,
+		   v1,-1.0,
+		   v1,v8 - 7.0);
+
+	check(vd,8);
+
+	// A property assigned in the pass can be reused by the next pairs
+	reset(vd);
+
+	assign(v8,7.0,
+		   v1,v8 - 7.0,
+		   v2,v8 - 6.0 + v1,
+		   v3,2.0*v2,
+		   v4,v3 + v2,
+		   v5,v4 + v2,
+		   v6,v5 + v2,
+		   v7,v6 + v2);
+
+	check(vd,8);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_operators_assign_tiles_test )
+{
+	if (create_vcluster().getProcessingUnits() > 3)
+		return;
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_dist_ws<3,float,aggregate<float,float,float,float>> vd(0,box,bc,ghost);
+
+	// one particle every three is in the subset 0
+	auto & v_cl = create_vcluster();
+
+	for (size_t i = 0 ; i < 3000 ; i++)
+	{
+		if (v_cl.getProcessUnitID() != 0)
+		{break;}
+
+		vd.add();
+
+		for (size_t d = 0 ; d < 3 ; d++)
+		{vd.getLastPos()[d] = (float)rand() / (float)RAND_MAX;}
+
+		vd.template getLastProp<1>() = (float)i;
+		vd.template getLastProp<2>() = (float)(i % 7);
+
+		vd.getLastSubset((i % 3 == 0)?0:1);
+	}
+
+	vd.map();
+
+	vector_dist_subset<3,float,aggregate<float,float,float,float>> vd_sub(vd,0);
+
+	auto vA = getV<0>(vd);
+	auto vB = getV<1>(vd);
+	auto vC = getV<2>(vd);
+	auto vD = getV<3>(vd);
+	auto vA_sub = getV<0>(vd_sub);
+	auto vD_sub = getV<3>(vd_sub);
+
+	size_t n_sub = 0;
+	auto it_sub = vd_sub.getDomainIterator();
+	while (it_sub.isNext())
+	{
+		n_sub++;
+		++it_sub;
+	}
+
+	size_t ms_old = vector_dist_op_host_config::minParallelSize();
+	size_t ts_old = vector_dist_op_host_config::assignTileSize();
+	vector_dist_op_host_config::setMinParallelSize(0);
+
+	// tiles of one particle, tiles that do not divide the subset and one tile for everything
+	size_t tiles[3] = {1,7,4096};
+
+	for (size_t t = 0 ; t < 3 ; t++)
+	{
+		vector_dist_op_host_config::setAssignTileSize(tiles[t]);
+
+		// nt = 1 serial, nt = 0 all the OpenMP threads
+		for (int nt = 1 ; nt >= 0 ; nt--)
+		{
+			vector_dist_op_host_config::setNThreads(nt);
+
+			vA = -1.0;
+			vD = -1.0;
+
+			// the second pair read on the same particle the property assigned by the first one
+			assign(vA_sub,2.0*vB + vC,
+			       vD_sub,vA + 1.0);
+
+			BOOST_REQUIRE_EQUAL(vector_dist_assign_cse::getLastNTiles(),(n_sub + tiles[t] - 1) / tiles[t]);
+			BOOST_REQUIRE_EQUAL(vector_dist_assign_cse::getLastNEval(),0ul);
+
+			auto it = vd.getDomainIterator();
+
+			bool match = true;
+
+			while (it.isNext())
+			{
+				auto p = it.get();
+
+				// the right hand side is evaluated on the particle of vd, not on the key of the subset
+				if ((size_t)vd.template getProp<1>(p) % 3 == 0)
+				{
+					match &= vd.template getProp<0>(p) == 2.0f*vd.template getProp<1>(p) + vd.template getProp<2>(p);
+					match &= vd.template getProp<3>(p) == vd.template getProp<0>(p) + 1.0f;
+				}
+				else
+				{
+					match &= vd.template getProp<0>(p) == -1.0f;
+					match &= vd.template getProp<3>(p) == -1.0f;
+				}
+
+				++it;
+			}
+
+			BOOST_REQUIRE_EQUAL(match,true);
+		}
+	}
+
+	vector_dist_op_host_config::setNThreads(0);
+	vector_dist_op_host_config::setMinParallelSize(ms_old);
+	vector_dist_op_host_config::setAssignTileSize(ts_old);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
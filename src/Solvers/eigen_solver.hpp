@@ -0,0 +1,448 @@
+/*
+ * eigen_solver.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef OPENFPM_NUMERICS_SRC_SOLVERS_EIGEN_SOLVER_HPP_
+#define OPENFPM_NUMERICS_SRC_SOLVERS_EIGEN_SOLVER_HPP_
+
+//! Krylov methods of eigen_solver
+enum eigen_solver_method
+{
+	EIGEN_SOLVER_CG,
+	EIGEN_SOLVER_BICGSTAB
+};
+
+//! Preconditioners of eigen_solver
+enum eigen_solver_pc
+{
+	EIGEN_PC_NONE,
+	EIGEN_PC_JACOBI,
+	EIGEN_PC_ILU
+};
+
+#if defined(HAVE_EIGEN)
+
+/////// Compiled with EIGEN support
+
+#include "Vector/Vector.hpp"
+#include <Eigen/IterativeLinearSolvers>
+
+//! stub, only double precision is supported
+template<typename T>
+class eigen_solver
+{
+public:
+
+	template<unsigned int impl, typename id_type> static Vector<T> solve(const SparseMatrix<T,id_type,impl> & A, const Vector<T> & b)
+	{
+		std::cerr << __FILE__ << ":" << __LINE__ << " Error eigen_solver only support double precision, and int ad id type" << "/n";
+
+		return Vector<T>();
+	}
+};
+
+/*! \brief Shared memory iterative solver based on Eigen
+ *
+ * It solve the systems produced with the EIGEN_BASE SparseMatrix and Vector (the same used by
+ * umfpack_solver) with the Eigen Krylov methods: Conjugate Gradient (symmetric positive definite
+ * systems) or BiCGSTAB, preconditioned with Jacobi or an incomplete factorization (ILUT for BiCGSTAB,
+ * incomplete Cholesky for CG). The system is collected on master and solved there, the products
+ * Matrix-Vector use all the threads of the node when Eigen is compiled with OpenMP, so it is meant for
+ * single node runs with one processor and many threads, where umfpack is limited by the direct
+ * factorization and PETSc need one processor for each core
+ *
+ * \verbatim
+   eigen_solver<double> solver;
+   solver.setSolver(EIGEN_SOLVER_BICGSTAB);
+   solver.setPreconditioner(EIGEN_PC_ILU);
+   solver.setNThreads(16);
+   FD.solve_with_solver(solver,sol);
+ * \endverbatim
+ *
+ */
+template<>
+class eigen_solver<double>
+{
+	//! Row major storage, the only one Eigen multi-thread in the Matrix-Vector product
+	typedef Eigen::SparseMatrix<double,Eigen::RowMajor,int> mat_type;
+
+	//! Dense vector
+	typedef Eigen::Matrix<double, Eigen::Dynamic, 1> vec_type;
+
+	//! Matrix of the last solve
+	mat_type mat_ei;
+
+	//! CG solvers
+	Eigen::ConjugateGradient<mat_type,Eigen::Lower|Eigen::Upper,Eigen::IdentityPreconditioner> cg_none;
+	Eigen::ConjugateGradient<mat_type,Eigen::Lower|Eigen::Upper,Eigen::DiagonalPreconditioner<double>> cg_jacobi;
+	Eigen::ConjugateGradient<mat_type,Eigen::Lower|Eigen::Upper,Eigen::IncompleteCholesky<double>> cg_ic;
+
+	//! BiCGSTAB solvers
+	Eigen::BiCGSTAB<mat_type,Eigen::IdentityPreconditioner> bicgstab_none;
+	Eigen::BiCGSTAB<mat_type,Eigen::DiagonalPreconditioner<double>> bicgstab_jacobi;
+	Eigen::BiCGSTAB<mat_type,Eigen::IncompleteLUT<double>> bicgstab_ilu;
+
+	//! Krylov method
+	eigen_solver_method method = EIGEN_SOLVER_BICGSTAB;
+
+	//! Preconditioner
+	eigen_solver_pc pc = EIGEN_PC_JACOBI;
+
+	//! relative tolerance
+	double tol = 1e-8;
+
+	//! maximum number of iterations (0 Eigen default)
+	size_t maxits = 0;
+
+	//! number of threads (0 Eigen default)
+	int n_threads = 0;
+
+	//! iterations of the last solve
+	size_t last_its = 0;
+
+	//! estimated relative error of the last solve
+	double last_err = 0.0;
+
+	//! time to set-up the preconditioner in the last solve
+	double setup_time = 0.0;
+
+	//! time to solve in the last solve
+	double apply_time = 0.0;
+
+	//! the preconditioner has been computed
+	bool is_computed = false;
+
+	/*! \brief Set the tolerances and compute the preconditioner
+	 *
+	 * \param s Eigen solver
+	 *
+	 * \return true if the preconditioner has been computed
+	 *
+	 */
+	template<typename solver_type>
+	bool compute_impl(solver_type & s)
+	{
+		s.setTolerance(tol);
+
+		if (maxits != 0)
+		{s.setMaxIterations(maxits);}
+
+		s.compute(mat_ei);
+
+		if (s.info() != Eigen::Success)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error the preconditioner cannot be computed" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	/*! \brief Solve with the preconditioner computed
+	 *
+	 * \param s Eigen solver
+	 * \param b_ei right-hand-side
+	 * \param x_ei solution
+	 *
+	 */
+	template<typename solver_type>
+	void solve_impl(solver_type & s, const vec_type & b_ei, vec_type & x_ei)
+	{
+		x_ei = s.solve(b_ei);
+
+		last_its = s.iterations();
+		last_err = s.error();
+
+		if (s.info() != Eigen::Success)
+		{std::cerr << __FILE__ << ":" << __LINE__ << " Warning the solver did not converge, iterations: " << last_its << " error: " << last_err << std::endl;}
+	}
+
+	/*! \brief Compute the preconditioner of the method selected
+	 *
+	 * \return true if the preconditioner has been computed
+	 *
+	 */
+	bool compute()
+	{
+		if (method == EIGEN_SOLVER_CG)
+		{
+			if (pc == EIGEN_PC_NONE)
+			{return compute_impl(cg_none);}
+			else if (pc == EIGEN_PC_JACOBI)
+			{return compute_impl(cg_jacobi);}
+
+			return compute_impl(cg_ic);
+		}
+
+		if (pc == EIGEN_PC_NONE)
+		{return compute_impl(bicgstab_none);}
+		else if (pc == EIGEN_PC_JACOBI)
+		{return compute_impl(bicgstab_jacobi);}
+
+		return compute_impl(bicgstab_ilu);
+	}
+
+	/*! \brief Solve with the method selected
+	 *
+	 * \param b_ei right-hand-side
+	 * \param x_ei solution
+	 *
+	 */
+	void solve_selected(const vec_type & b_ei, vec_type & x_ei)
+	{
+		if (method == EIGEN_SOLVER_CG)
+		{
+			if (pc == EIGEN_PC_NONE)
+			{solve_impl(cg_none,b_ei,x_ei);}
+			else if (pc == EIGEN_PC_JACOBI)
+			{solve_impl(cg_jacobi,b_ei,x_ei);}
+			else
+			{solve_impl(cg_ic,b_ei,x_ei);}
+		}
+		else
+		{
+			if (pc == EIGEN_PC_NONE)
+			{solve_impl(bicgstab_none,b_ei,x_ei);}
+			else if (pc == EIGEN_PC_JACOBI)
+			{solve_impl(bicgstab_jacobi,b_ei,x_ei);}
+			else
+			{solve_impl(bicgstab_ilu,b_ei,x_ei);}
+		}
+	}
+
+	//! Set the number of threads used by Eigen
+	void set_threads()
+	{
+#ifdef HAVE_OPENMP
+		if (n_threads != 0)
+		{Eigen::setNbThreads(n_threads);}
+#endif
+	}
+
+public:
+
+	/*! \brief Set the Krylov method
+	 *
+	 * \param m EIGEN_SOLVER_CG (only symmetric positive definite systems) or EIGEN_SOLVER_BICGSTAB
+	 *
+	 */
+	void setSolver(eigen_solver_method m)
+	{
+		method = m;
+		is_computed = false;
+	}
+
+	/*! \brief Set the preconditioner
+	 *
+	 * \param p EIGEN_PC_NONE, EIGEN_PC_JACOBI or EIGEN_PC_ILU (incomplete Cholesky with CG)
+	 *
+	 */
+	void setPreconditioner(eigen_solver_pc p)
+	{
+		pc = p;
+		is_computed = false;
+	}
+
+	/*! \brief Set the relative tolerance on the residual
+	 *
+	 * \param t tolerance
+	 *
+	 */
+	void setTolerance(double t)
+	{
+		tol = t;
+	}
+
+	/*! \brief Set the maximum number of iterations
+	 *
+	 * \param n maximum number of iterations
+	 *
+	 */
+	void setMaxIter(size_t n)
+	{
+		maxits = n;
+	}
+
+	/*! \brief Set the number of threads used by Eigen in the solve
+	 *
+	 * \param n number of threads (0 for the Eigen default, OMP_NUM_THREADS)
+	 *
+	 */
+	void setNThreads(int n)
+	{
+		n_threads = n;
+	}
+
+	/*! \brief Solve the system
+	 *
+	 * \warning the system is collected and solved on master, with more processors the others wait
+	 *
+	 * \param A sparse matrix
+	 * \param b right-hand-side
+	 *
+	 * \return the solution
+	 *
+	 */
+	Vector<double,EIGEN_BASE> solve(SparseMatrix<double,int,EIGEN_BASE> & A, const Vector<double,EIGEN_BASE> & b)
+	{
+		Vcluster<> & vcl = create_vcluster();
+
+		// Collect the matrix on master
+		auto & mat = A.getMat();
+
+		is_computed = false;
+
+		if (vcl.getProcessUnitID() == 0)
+		{
+			set_threads();
+
+			timer t_setup;
+			t_setup.start();
+
+			mat_ei = mat;
+			is_computed = compute();
+
+			t_setup.stop();
+			setup_time = t_setup.getwct();
+		}
+
+		return solve(b);
+	}
+
+	/*! \brief Solve the system with the Matrix and the preconditioner of the last solve
+	 *
+	 * \param b right-hand-side
+	 *
+	 * \return the solution
+	 *
+	 */
+	Vector<double,EIGEN_BASE> solve(const Vector<double,EIGEN_BASE> & b)
+	{
+		Vcluster<> & vcl = create_vcluster();
+
+		Vector<double> x;
+
+		// Collect the vector on master
+		auto & b_ei = b.getVec();
+
+		// Copy b into x, this also copy the information on how to scatter back the information on x
+		x = b;
+
+		if (vcl.getProcessUnitID() == 0)
+		{
+			if (is_computed == false)
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " Error the solver does not have a Matrix" << std::endl;
+
+				x.scatter();
+				return x;
+			}
+
+			set_threads();
+
+			timer t_apply;
+			t_apply.start();
+
+			vec_type x_ei;
+			solve_selected(b_ei,x_ei);
+
+			t_apply.stop();
+			apply_time = t_apply.getwct();
+
+			x = x_ei;
+		}
+
+		// Vector is only on master, scatter back the information
+		x.scatter();
+
+		return x;
+	}
+
+	/*! \brief Solve the system
+	 *
+	 * \param A sparse matrix
+	 * \param b right-hand-side
+	 *
+	 * \return the solution
+	 *
+	 */
+	Vector<double,EIGEN_BASE> try_solve(SparseMatrix<double,int,EIGEN_BASE> & A, const Vector<double,EIGEN_BASE> & b)
+	{
+		return solve(A,b);
+	}
+
+	/*! \brief Return the number of iterations of the last solve (on master)
+	 *
+	 * \return the number of iterations
+	 *
+	 */
+	size_t getLastIterations() const
+	{
+		return last_its;
+	}
+
+	/*! \brief Return the estimated relative residual of the last solve (on master)
+	 *
+	 * \return the relative residual
+	 *
+	 */
+	double getLastError() const
+	{
+		return last_err;
+	}
+
+	/*! \brief Return the time spent to compute the preconditioner in the last solve (on master)
+	 *
+	 * \return the time in seconds
+	 *
+	 */
+	double getLastSetupTime() const
+	{
+		return setup_time;
+	}
+
+	/*! \brief Return the time spent in the iterations of the last solve (on master)
+	 *
+	 * \return the time in seconds
+	 *
+	 */
+	double getLastApplyTime() const
+	{
+		return apply_time;
+	}
+};
+
+#else
+
+/////// Compiled without EIGEN support
+
+#include "Vector/Vector.hpp"
+
+//! stub when library compiled without eigen
+template<typename T>
+class eigen_solver
+{
+public:
+
+	//! stub solve
+	template<unsigned int impl, typename id_type> static Vector<T,impl> solve(SparseMatrix<T,id_type,impl> & A, const Vector<T,impl> & b)
+	{
+		std::cerr << __FILE__ << ":" << __LINE__ << " Error in order to use eigen_solver you must compile OpenFPM with linear algebra support" << "/n";
+
+		return Vector<T,impl>();
+	}
+
+	//! stub try_solve
+	template<unsigned int impl, typename id_type> static Vector<T,impl> try_solve(SparseMatrix<T,id_type,impl> & A, const Vector<T,impl> & b)
+	{
+		std::cerr << __FILE__ << ":" << __LINE__ << " Error in order to use eigen_solver you must compile OpenFPM with linear algebra support" << "/n";
+
+		return Vector<T,impl>();
+	}
+};
+
+#endif
+
+#endif /* OPENFPM_NUMERICS_SRC_SOLVERS_EIGEN_SOLVER_HPP_ */
@@ -15,11 +15,16 @@
 #include "Vector/Vector.hpp"
 #include <petscksp.h>
 #include <petsctime.h>
+#include <petscversion.h>
 #include "Plot/GoogleChart.hpp"
 #include "Matrix/SparseMatrix.hpp"
 #include "Vector/Vector.hpp"
 #include <sstream>
 #include <iomanip>
+#include <functional>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
 
 template <typename T>
 std::string to_string_with_precision(const T a_value, const int n = 6)
@@ -44,6 +49,22 @@ enum AMG_type
 	TRILINOS_ML
 };
 
+/*! \brief Policy to reuse the preconditioner across solves with the same Matrix object
+ *
+ * * REUSE_PC_NEVER the preconditioner is rebuilt at every solve (default)
+ * * REUSE_PC_N_SOLVES the preconditioner is rebuilt every N solves
+ * * REUSE_PC_ITERATIONS the preconditioner is rebuilt when the last solve needed more than N iterations
+ * * REUSE_PC_UNCHANGED_COEFF the preconditioner is rebuilt only when the coefficients of the Matrix changed
+ *
+ */
+enum PC_reuse_policy
+{
+	REUSE_PC_NEVER,
+	REUSE_PC_N_SOLVES,
+	REUSE_PC_ITERATIONS,
+	REUSE_PC_UNCHANGED_COEFF
+};
+
 
 /*! \brief In case T does not match the PETSC precision compilation create a
  *         stub structure
@@ -130,11 +151,23 @@ class petsc_solver<double>
 
 		//! Convergence per iteration
 		openfpm::vector<itError> res;
+
+		//! Krylov solver type
+		std::string ksp;
+
+		//! parameter of the Krylov solver (restart or search directions, 0 default)
+		PetscInt param = 0;
+
+		//! the solver converged (not aborted because slower than the best)
+		bool converged = false;
 	};
 
 	//! indicate if the preconditioner is set
 	bool is_preconditioner_set = false;
 
+	//! user preconditioner z = M^-1 r on the local rows (PCSHELL), empty if not set
+	std::function<void(const PetscScalar *, PetscScalar *)> pc_shell;
+
 	//! KSP Maximum number of iterations
 	PetscInt maxits;
 
@@ -157,6 +190,115 @@ class petsc_solver<double>
 	//! Block size
 	int block_sz = 0;
 
+	//! policy to reuse the preconditioner
+	PC_reuse_policy pc_reuse = REUSE_PC_NEVER;
+
+	//! parameter of the reuse policy (number of solves or iterations)
+	size_t pc_reuse_n = 0;
+
+	//! indicate if a preconditioner has been built and can be reused
+	bool pc_built = false;
+
+	//! global size of the Matrix used to build the current preconditioner
+	PetscInt pc_size = 0;
+
+	//! revision of the Matrix coefficients used to build the current preconditioner
+	size_t pc_revision = 0;
+
+	//! number of solves with the current preconditioner
+	size_t pc_n_solves = 0;
+
+	//! number of times the preconditioner has been built
+	size_t pc_n_builds = 0;
+
+	//! indicate if the last solve has built the preconditioner
+	bool pc_rebuilt = false;
+
+	//! time spent to set-up the solver and the preconditioner in the last solve (seconds)
+	double setup_time = 0.0;
+
+	//! time spent in the Krylov iterations in the last solve (seconds)
+	double apply_time = 0.0;
+
+	//! number of iterations of the last solve
+	PetscInt last_its = 0;
+
+	//! file of the tuning database (empty the results of try_solve are not stored)
+	std::string tuning_db;
+
+	//! time budget of the search in try_solve in seconds (0 no budget)
+	double tuning_budget = 0.0;
+
+	//! indicate if the last try_solve used a configuration from the tuning database
+	bool tuning_hit = false;
+
+	//! maximum time in seconds for the solver under test (negative no limit)
+	double cand_limit = -1.0;
+
+	//! start time of the solver under test
+	PetscLogDouble cand_start = 0.0;
+
+	//! iterations between two checks of the time limit of the solver under test (each one is a reduction)
+	PetscInt cand_check_its = 10;
+
+	//! Single precision copy of the local rows of a Matrix
+	struct float_matrix
+	{
+		//! row offsets
+		std::vector<PetscInt> row_ptr;
+
+		//! colums (index in the local vector x_loc)
+		std::vector<int> col;
+
+		//! coefficients
+		std::vector<float> val;
+
+		//! local vector with the colums used by the local rows
+		Vec x_loc = NULL;
+
+		//! vector with the layout of the Matrix (halo exchange and input of the preconditioner)
+		Vec x_glob = NULL;
+
+		//! output of the preconditioner
+		Vec z_glob = NULL;
+
+		//! scatter from x_glob to x_loc
+		VecScatter scat = NULL;
+
+		//! AIJ Matrix with the single precision coefficients, the inner preconditioner is built on it
+		Mat aij = NULL;
+
+		//! double precision Matrix (residuals of the refinement)
+		Mat A = NULL;
+
+		//! revision of the coefficients copied (0 = no copy)
+		size_t revision = 0;
+
+		//! revision of the coefficients of A
+		size_t A_revision = 0;
+	};
+
+	//! indicate if solve use the mixed precision iterative refinement
+	bool mixed_precision = false;
+
+	//! relative tolerance of the single precision inner solves
+	double mixed_inner_rtol = 1e-4;
+
+	//! maximum number of refinement steps
+	size_t mixed_max_outer = 30;
+
+	//! single precision copy of the Matrix
+	float_matrix mixed_mat;
+
+	//! inner preconditioner of the mixed precision mode (KSPPREONLY on the single precision AIJ Matrix)
+	KSP ksp_inner = NULL;
+
+	//! refinement steps of the last mixed precision solve
+	size_t mixed_outer_its = 0;
+
+	//! indicate if the last mixed precision solve reached the tolerances
+	bool mixed_converged = false;
+
 	/*! \brief Calculate the residual error at time t for one method
 	 *
 	 * \param t time
@@ -372,6 +514,700 @@ class petsc_solver<double>
 		return 0;
 	}
 
+	//! Operator of a matrix-free solve
+	struct matrix_free_ctx
+	{
+		//! y = A x on the local rows
+		std::function<void(const PetscScalar *, PetscScalar *)> mult;
+
+		//! diagonal of A on the local rows
+		std::function<void(PetscScalar *)> diag;
+	};
+
+	/*! \brief Apply the matrix-free operator
+	 *
+	 * \param A shell Matrix
+	 * \param x vector
+	 * \param y result
+	 *
+	 * \return always zero
+	 *
+	 */
+	static PetscErrorCode matrix_free_mult(Mat A, Vec x, Vec y)
+	{
+		matrix_free_ctx * ctx;
+		const PetscScalar * x_a;
+		PetscScalar * y_a;
+
+		PETSC_SAFE_CALL(MatShellGetContext(A,(void **)&ctx));
+
+		PETSC_SAFE_CALL(VecGetArrayRead(x,&x_a));
+		PETSC_SAFE_CALL(VecGetArray(y,&y_a));
+
+		ctx->mult(x_a,y_a);
+
+		PETSC_SAFE_CALL(VecRestoreArray(y,&y_a));
+		PETSC_SAFE_CALL(VecRestoreArrayRead(x,&x_a));
+
+		return 0;
+	}
+
+	/*! \brief Get the diagonal of the matrix-free operator
+	 *
+	 * \param A shell Matrix
+	 * \param d diagonal
+	 *
+	 * \return always zero
+	 *
+	 */
+	static PetscErrorCode matrix_free_diag(Mat A, Vec d)
+	{
+		matrix_free_ctx * ctx;
+		PetscScalar * d_a;
+
+		PETSC_SAFE_CALL(MatShellGetContext(A,(void **)&ctx));
+
+		PETSC_SAFE_CALL(VecGetArray(d,&d_a));
+
+		ctx->diag(d_a);
+
+		PETSC_SAFE_CALL(VecRestoreArray(d,&d_a));
+
+		return 0;
+	}
+
+	/*! \brief Matrix-Vector product with the single precision copy
+	 *
+	 * The coefficients, the vectors and the products are in single precision, only the halo
+	 * exchange go through the double precision vectors x_glob and x_loc (PETSc scalars are double)
+	 *
+	 * \param x local rows of the vector
+	 * \param y local rows of the result
+	 *
+	 */
+	void float_matrix_mult(const std::vector<float> & x, std::vector<float> & y)
+	{
+		PetscScalar * xg_a;
+		const PetscScalar * x_a;
+
+		PETSC_SAFE_CALL(VecGetArray(mixed_mat.x_glob,&xg_a));
+
+		for (size_t i = 0 ; i < x.size() ; i++)
+		{xg_a[i] = x[i];}
+
+		PETSC_SAFE_CALL(VecRestoreArray(mixed_mat.x_glob,&xg_a));
+
+		PETSC_SAFE_CALL(VecScatterBegin(mixed_mat.scat,mixed_mat.x_glob,mixed_mat.x_loc,INSERT_VALUES,SCATTER_FORWARD));
+		PETSC_SAFE_CALL(VecScatterEnd(mixed_mat.scat,mixed_mat.x_glob,mixed_mat.x_loc,INSERT_VALUES,SCATTER_FORWARD));
+
+		PETSC_SAFE_CALL(VecGetArrayRead(mixed_mat.x_loc,&x_a));
+
+		const PetscInt * row_ptr = mixed_mat.row_ptr.data();
+		const int * col = mixed_mat.col.data();
+		const float * val = mixed_mat.val.data();
+		size_t n_row = mixed_mat.row_ptr.size() - 1;
+
+#ifdef HAVE_OPENMP
+		#pragma omp parallel for schedule(static)
+#endif
+		for (size_t r = 0 ; r < n_row ; r++)
+		{
+			float sum = 0.0f;
+
+			for (PetscInt k = row_ptr[r] ; k < row_ptr[r+1] ; k++)
+			{sum += val[k] * (float)x_a[col[k]];}
+
+			y[r] = sum;
+		}
+
+		PETSC_SAFE_CALL(VecRestoreArrayRead(mixed_mat.x_loc,&x_a));
+	}
+
+	/*! \brief Apply the inner preconditioner to a single precision vector
+	 *
+	 * \param v local rows of the vector
+	 * \param z local rows of the result
+	 *
+	 */
+	void float_pc_apply(const std::vector<float> & v, std::vector<float> & z)
+	{
+		PetscScalar * x_a;
+		const PetscScalar * z_a;
+
+		PETSC_SAFE_CALL(VecGetArray(mixed_mat.x_glob,&x_a));
+
+		for (size_t i = 0 ; i < v.size() ; i++)
+		{x_a[i] = v[i];}
+
+		PETSC_SAFE_CALL(VecRestoreArray(mixed_mat.x_glob,&x_a));
+
+		PETSC_SAFE_CALL(KSPSolve(ksp_inner,mixed_mat.x_glob,mixed_mat.z_glob));
+
+		PETSC_SAFE_CALL(VecGetArrayRead(mixed_mat.z_glob,&z_a));
+
+		for (size_t i = 0 ; i < z.size() ; i++)
+		{z[i] = z_a[i];}
+
+		PETSC_SAFE_CALL(VecRestoreArrayRead(mixed_mat.z_glob,&z_a));
+	}
+
+	/*! \brief Scalar products of the first n vectors of V with w
+	 *
+	 * The products are in single precision, the sums in double precision. All the sums are
+	 * reduced across the processors with one communication
+	 *
+	 * \param V vectors
+	 * \param n number of vectors
+	 * \param w vector
+	 * \param h results
+	 *
+	 */
+	void float_mdot(const std::vector<std::vector<float>> & V, size_t n, const std::vector<float> & w, std::vector<double> & h)
+	{
+		auto & v_cl = create_vcluster();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			const float * v = V[i].data();
+			double sum = 0.0;
+
+#ifdef HAVE_OPENMP
+			#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+			for (size_t k = 0 ; k < w.size() ; k++)
+			{sum += v[k] * w[k];}
+
+			h[i] = sum;
+			v_cl.sum(h[i]);
+		}
+
+		v_cl.execute();
+	}
+
+	/*! \brief Norm 2 of a single precision vector distributed across the processors
+	 *
+	 * \param w local rows of the vector
+	 *
+	 * \return the norm
+	 *
+	 */
+	double float_norm(const std::vector<float> & w)
+	{
+		auto & v_cl = create_vcluster();
+
+		double sum = 0.0;
+
+#ifdef HAVE_OPENMP
+		#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+		for (size_t k = 0 ; k < w.size() ; k++)
+		{sum += w[k] * w[k];}
+
+		v_cl.sum(sum);
+		v_cl.execute();
+
+		return sqrt(sum);
+	}
+
+	/*! \brief Single precision restarted GMRES with right preconditioning
+	 *
+	 * It is the inner solve of the mixed precision refinement. It solve A d = r up to the relative
+	 * tolerance mixed_inner_rtol. The Krylov basis, the Matrix and the products are in single
+	 * precision, the preconditioner is ksp_inner (built on the single precision coefficients).
+	 * Gram-Schmidt is done twice (one reduction each) to keep the basis orthogonal in single
+	 * precision. The restart is the one set with setRestart (30 default)
+	 *
+	 * \param r_ right-hand-side
+	 * \param d_ solution
+	 * \param its number of iterations done
+	 *
+	 * \return true if the tolerance has been reached in maxits iterations
+	 *
+	 */
+	bool float_gmres(const Vec & r_, Vec & d_, PetscInt & its)
+	{
+		size_t n = mixed_mat.row_ptr.size() - 1;
+
+		PetscInt m = 30;
+		PetscBool set;
+		PETSC_SAFE_CALL(PetscOptionsGetInt(NULL,NULL,"-ksp_gmres_restart",&m,&set));
+		if (m <= 0)
+		{m = 30;}
+
+		std::vector<float> r(n);
+		std::vector<float> res(n);
+		std::vector<float> x(n,0.0f);
+		std::vector<float> w(n);
+		std::vector<float> z(n);
+		std::vector<std::vector<float>> V(m+1,std::vector<float>(n));
+
+		// Hessenberg Matrix (colum major), Givens rotations and right-hand-side of the least squares
+		std::vector<double> H((m+1)*m);
+		std::vector<double> h(m+1);
+		std::vector<double> cs(m);
+		std::vector<double> sn(m);
+		std::vector<double> g(m+1);
+		std::vector<double> y(m);
+
+		const PetscScalar * r_a;
+		PETSC_SAFE_CALL(VecGetArrayRead(r_,&r_a));
+
+		for (size_t k = 0 ; k < n ; k++)
+		{r[k] = r_a[k];}
+
+		PETSC_SAFE_CALL(VecRestoreArrayRead(r_,&r_a));
+
+		res = r;
+		double beta = float_norm(res);
+		double target = mixed_inner_rtol * beta;
+
+		its = 0;
+		bool conv = (beta == 0.0);
+
+		while (conv == false && its < maxits)
+		{
+			for (size_t k = 0 ; k < n ; k++)
+			{V[0][k] = res[k] / beta;}
+
+			std::fill(g.begin(),g.end(),0.0);
+			g[0] = beta;
+
+			PetscInt j = 0;
+			while (j < m && its < maxits)
+			{
+				float_pc_apply(V[j],z);
+				float_matrix_mult(z,w);
+
+				for (size_t i = 0 ; i <= (size_t)j ; i++)
+				{H[i + j*(m+1)] = 0.0;}
+
+				for (size_t pass = 0 ; pass < 2 ; pass++)
+				{
+					float_mdot(V,j+1,w,h);
+
+					for (size_t i = 0 ; i <= (size_t)j ; i++)
+					{
+						H[i + j*(m+1)] += h[i];
+
+						float hf = h[i];
+						const float * v = V[i].data();
+
+						for (size_t k = 0 ; k < n ; k++)
+						{w[k] -= hf * v[k];}
+					}
+				}
+
+				double h_next = float_norm(w);
+
+				if (h_next != 0.0)
+				{
+					for (size_t k = 0 ; k < n ; k++)
+					{V[j+1][k] = w[k] / h_next;}
+				}
+
+				// apply the previous rotations to the new colum and compute the new one
+				for (PetscInt i = 0 ; i < j ; i++)
+				{
+					double tmp = cs[i]*H[i + j*(m+1)] + sn[i]*H[i+1 + j*(m+1)];
+					H[i+1 + j*(m+1)] = -sn[i]*H[i + j*(m+1)] + cs[i]*H[i+1 + j*(m+1)];
+					H[i + j*(m+1)] = tmp;
+				}
+
+				double den = sqrt(H[j + j*(m+1)]*H[j + j*(m+1)] + h_next*h_next);
+
+				cs[j] = H[j + j*(m+1)] / den;
+				sn[j] = h_next / den;
+				H[j + j*(m+1)] = den;
+
+				g[j+1] = -sn[j]*g[j];
+				g[j] = cs[j]*g[j];
+
+				j++;
+				its++;
+
+				if (std::fabs(g[j]) <= target || h_next == 0.0)
+				{
+					conv = true;
+					break;
+				}
+			}
+
+			// y = H^-1 g and x = x + M^-1 V y
+			for (PetscInt i = j - 1 ; i >= 0 ; i--)
+			{
+				y[i] = g[i];
+				for (PetscInt l = i + 1 ; l < j ; l++)
+				{y[i] -= H[i + l*(m+1)]*y[l];}
+				y[i] /= H[i + i*(m+1)];
+			}
+
+			std::fill(w.begin(),w.end(),0.0f);
+			for (PetscInt i = 0 ; i < j ; i++)
+			{
+				float yf = y[i];
+				const float * v = V[i].data();
+
+				for (size_t k = 0 ; k < n ; k++)
+				{w[k] += yf * v[k];}
+			}
+
+			float_pc_apply(w,z);
+
+			for (size_t k = 0 ; k < n ; k++)
+			{x[k] += z[k];}
+
+			if (conv == true || its >= maxits)
+			{break;}
+
+			// residual of the restart
+			float_matrix_mult(x,w);
+
+			for (size_t k = 0 ; k < n ; k++)
+			{res[k] = r[k] - w[k];}
+
+			beta = float_norm(res);
+			conv = (beta <= target);
+		}
+
+		PetscScalar * d_a;
+		PETSC_SAFE_CALL(VecGetArray(d_,&d_a));
+
+		for (size_t k = 0 ; k < n ; k++)
+		{d_a[k] = x[k];}
+
+		PETSC_SAFE_CALL(VecRestoreArray(d_,&d_a));
+
+		return conv;
+	}
+
+	/*! \brief Destroy the single precision copy of the Matrix and the inner preconditioner
+	 *
+	 */
+	void destroy_mixed()
+	{
+		if (mixed_mat.aij != NULL)
+		{PETSC_SAFE_CALL(MatDestroy(&mixed_mat.aij));}
+		if (mixed_mat.A != NULL)
+		{PETSC_SAFE_CALL(MatDestroy(&mixed_mat.A));}
+		if (mixed_mat.scat != NULL)
+		{PETSC_SAFE_CALL(VecScatterDestroy(&mixed_mat.scat));}
+		if (mixed_mat.x_loc != NULL)
+		{PETSC_SAFE_CALL(VecDestroy(&mixed_mat.x_loc));}
+		if (mixed_mat.x_glob != NULL)
+		{PETSC_SAFE_CALL(VecDestroy(&mixed_mat.x_glob));}
+		if (mixed_mat.z_glob != NULL)
+		{PETSC_SAFE_CALL(VecDestroy(&mixed_mat.z_glob));}
+		if (ksp_inner != NULL)
+		{PETSC_SAFE_CALL(KSPDestroy(&ksp_inner));}
+
+		mixed_mat.revision = 0;
+	}
+
+	/*! \brief Create the single precision copy of the local rows of a Matrix and the inner preconditioner
+	 *
+	 * \param A_ Matrix
+	 * \param revision revision of the coefficients of the Matrix
+	 *
+	 */
+	void build_float_matrix(const Mat & A_, size_t revision)
+	{
+		// the residuals of the refinement use the double precision Matrix, A_ can be the one
+		// of the previous copy
+		PETSC_SAFE_CALL(PetscObjectReference((PetscObject)A_));
+
+		destroy_mixed();
+
+		mixed_mat.A = A_;
+		mixed_mat.A_revision = revision;
+
+		PetscInt row;
+		PetscInt col;
+		PetscInt row_loc;
+		PetscInt col_loc;
+		PetscInt r_start;
+		PetscInt r_stop;
+
+		PETSC_SAFE_CALL(MatGetSize(A_,&row,&col));
+		PETSC_SAFE_CALL(MatGetLocalSize(A_,&row_loc,&col_loc));
+		PETSC_SAFE_CALL(MatGetOwnershipRange(A_,&r_start,&r_stop));
+
+		std::vector<PetscInt> gcol;
+
+		mixed_mat.row_ptr.clear();
+		mixed_mat.val.clear();
+		mixed_mat.row_ptr.push_back(0);
+
+		for (PetscInt r = r_start ; r < r_stop ; r++)
+		{
+			PetscInt ncols;
+			const PetscInt * cols;
+			const PetscScalar * vals;
+
+			PETSC_SAFE_CALL(MatGetRow(A_,r,&ncols,&cols,&vals));
+
+			for (PetscInt j = 0 ; j < ncols ; j++)
+			{
+				gcol.push_back(cols[j]);
+				mixed_mat.val.push_back((float)vals[j]);
+			}
+
+			mixed_mat.row_ptr.push_back(gcol.size());
+
+			PETSC_SAFE_CALL(MatRestoreRow(A_,r,&ncols,&cols,&vals));
+		}
+
+		// colums used by the local rows
+		std::vector<PetscInt> ucol(gcol);
+		std::sort(ucol.begin(),ucol.end());
+		ucol.erase(std::unique(ucol.begin(),ucol.end()),ucol.end());
+
+		mixed_mat.col.resize(gcol.size());
+		for (size_t k = 0 ; k < gcol.size() ; k++)
+		{mixed_mat.col[k] = std::lower_bound(ucol.begin(),ucol.end(),gcol[k]) - ucol.begin();}
+
+		IS is;
+
+		PETSC_SAFE_CALL(MatCreateVecs(A_,&mixed_mat.x_glob,&mixed_mat.z_glob));
+		PETSC_SAFE_CALL(VecCreateSeq(PETSC_COMM_SELF,ucol.size(),&mixed_mat.x_loc));
+		PETSC_SAFE_CALL(ISCreateGeneral(PETSC_COMM_SELF,ucol.size(),ucol.data(),PETSC_COPY_VALUES,&is));
+		PETSC_SAFE_CALL(VecScatterCreate(mixed_mat.x_glob,is,mixed_mat.x_loc,NULL,&mixed_mat.scat));
+		PETSC_SAFE_CALL(ISDestroy(&is));
+
+		// AIJ Matrix with the coefficients rounded to single precision
+		std::vector<PetscScalar> val_d(mixed_mat.val.begin(),mixed_mat.val.end());
+
+		PETSC_SAFE_CALL(MatCreate(PETSC_COMM_WORLD,&mixed_mat.aij));
+		PETSC_SAFE_CALL(MatSetSizes(mixed_mat.aij,row_loc,col_loc,row,col));
+		PETSC_SAFE_CALL(MatSetType(mixed_mat.aij,MATMPIAIJ));
+		PETSC_SAFE_CALL(MatMPIAIJSetPreallocationCSR(mixed_mat.aij,mixed_mat.row_ptr.data(),gcol.data(),val_d.data()));
+
+		mixed_mat.revision = revision;
+
+		// The inner preconditioner is the one configured for the solver, built on the single
+		// precision coefficients and applied once (KSPPREONLY), the Krylov method is float_gmres
+		PETSC_SAFE_CALL(KSPCreate(PETSC_COMM_WORLD,&ksp_inner));
+		PETSC_SAFE_CALL(KSPSetOperators(ksp_inner,mixed_mat.aij,mixed_mat.aij));
+		PETSC_SAFE_CALL(KSPSetFromOptions(ksp_inner));
+		PETSC_SAFE_CALL(KSPSetType(ksp_inner,KSPPREONLY));
+		set_pc_shell(ksp_inner);
+		PETSC_SAFE_CALL(KSPSetUp(ksp_inner));
+	}
+
+	/*! \brief Mixed precision iterative refinement
+	 *
+	 * The residual and the update of the solution are in double precision, the corrections are
+	 * computed with float_gmres on the single precision copy of the Matrix up to mixed_inner_rtol. It stop
+	 * when the residual satisfy the relative and absolute tolerances of the solver, or with an error
+	 * when an inner solve fail
+	 *
+	 * \param A_ Matrix
+	 * \param b_ right-hand-side
+	 * \param x_ solution (and initial guess)
+	 * \param revision revision of the coefficients of the Matrix
+	 * \param initial_guess true if x_ contain the initial guess
+	 *
+	 * \return true if the tolerances have been reached
+	 *
+	 */
+	bool solve_mixed(const Mat & A_, const Vec & b_, Vec & x_, size_t revision, bool initial_guess)
+	{
+		timer t_setup;
+		t_setup.start();
+
+		pc_rebuilt = false;
+
+		if (mixed_mat.revision != revision)
+		{
+			build_float_matrix(A_,revision);
+			pc_rebuilt = true;
+			pc_n_builds++;
+		}
+
+		t_setup.stop();
+
+		timer t_apply;
+		t_apply.start();
+
+		PetscReal rtol;
+		PetscReal abstol;
+		PetscReal dtol;
+		PetscInt max_its;
+
+		PETSC_SAFE_CALL(KSPGetTolerances(ksp,&rtol,&abstol,&dtol,&max_its));
+
+		Vec r_;
+		Vec d_;
+
+		PETSC_SAFE_CALL(VecDuplicate(b_,&r_));
+		PETSC_SAFE_CALL(VecDuplicate(b_,&d_));
+
+		PetscReal b_norm;
+		PETSC_SAFE_CALL(VecNorm(b_,NORM_2,&b_norm));
+
+		if (initial_guess == false)
+		{PETSC_SAFE_CALL(VecSet(x_,0.0));}
+
+		last_its = 0;
+		mixed_outer_its = 0;
+		mixed_converged = false;
+
+		for ( ; mixed_outer_its < mixed_max_outer ; mixed_outer_its++)
+		{
+			// r = b - A x in double precision
+			PETSC_SAFE_CALL(MatMult(A_,x_,r_));
+			PETSC_SAFE_CALL(VecAYPX(r_,-1.0,b_));
+
+			PetscReal r_norm;
+			PETSC_SAFE_CALL(VecNorm(r_,NORM_2,&r_norm));
+
+			if (r_norm <= std::max(rtol*b_norm,abstol))
+			{
+				mixed_converged = true;
+				break;
+			}
+
+			// correction with the single precision Matrix
+			PetscInt its;
+			bool inner_conv = float_gmres(r_,d_,its);
+			last_its += its;
+
+			if (inner_conv == false)
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " Error the single precision inner solve did not converge in " << its << " iterations at the refinement step " << mixed_outer_its << std::endl;
+				break;
+			}
+
+			PETSC_SAFE_CALL(VecAXPY(x_,1.0,d_));
+		}
+
+		if (mixed_converged == false && mixed_outer_its == mixed_max_outer)
+		{std::cerr << __FILE__ << ":" << __LINE__ << " Warning the mixed precision refinement did not converge in " << mixed_max_outer << " steps" << std::endl;}
+
+		PETSC_SAFE_CALL(VecDestroy(&r_));
+		PETSC_SAFE_CALL(VecDestroy(&d_));
+
+		t_apply.stop();
+
+		setup_time = t_setup.getwct();
+		apply_time = t_apply.getwct();
+
+		return mixed_converged;
+	}
+
+	/*! \brief Mixed precision solve with the Matrix of the last mixed precision solve
+	 *
+	 * \param b_ right-hand-side
+	 * \param x_ solution (and initial guess)
+	 * \param initial_guess true if x_ contain the initial guess
+	 *
+	 * \return true if the tolerances have been reached
+	 *
+	 */
+	bool solve_mixed(const Vec & b_, Vec & x_, bool initial_guess)
+	{
+		if (mixed_mat.A == NULL)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error no Matrix has been set, solve with a Matrix first" << std::endl;
+			return false;
+		}
+
+		Mat A_ = mixed_mat.A;
+
+		return solve_mixed(A_,b_,x_,mixed_mat.A_revision,initial_guess);
+	}
+
+	/*! \brief Convergence test of the solvers under test in try_solve
+	 *
+	 * It is the default convergence test, but the solver is stopped (diverged) when it run for more
+	 * than the time of the best solver found so far, or more than the time budget left. The time is
+	 * checked only every cand_check_its iterations, because the decision need a reduction across the
+	 * processors
+	 *
+	 * \param ksp Solver
+	 * \param it Iteration number
+	 * \param rnorm residual norm
+	 * \param reason converged reason
+	 * \param ctx context of the default convergence test
+	 *
+	 * \return always zero
+	 *
+	 */
+	static PetscErrorCode converged_budget(KSP ksp, PetscInt it, PetscReal rnorm, KSPConvergedReason * reason, void * ctx)
+	{
+		petsc_solver<double> * pts;
+
+		PETSC_SAFE_CALL(KSPGetApplicationContext(ksp,(void **)&pts));
+		PETSC_SAFE_CALL(KSPConvergedDefault(ksp,it,rnorm,reason,ctx));
+
+		if (*reason == KSP_CONVERGED_ITERATING && pts->cand_limit >= 0.0 && it % pts->cand_check_its == 0 && it != 0)
+		{
+			PetscLogDouble t_now;
+			PETSC_SAFE_CALL(PetscTime(&t_now));
+
+			// All the processors must take the same decision
+			double t = t_now - pts->cand_start;
+
+			auto & v_cl = create_vcluster();
+			v_cl.max(t);
+			v_cl.execute();
+
+			if (t > pts->cand_limit)
+			{*reason = KSP_DIVERGED_ITS;}
+		}
+
+		return 0;
+	}
+
+	/*! \brief Apply the user preconditioner
+	 *
+	 * \param pc shell preconditioner
+	 * \param r vector
+	 * \param z result
+	 *
+	 * \return always zero
+	 *
+	 */
+	static PetscErrorCode pc_shell_apply(PC pc, Vec r, Vec z)
+	{
+		petsc_solver<double> * pts;
+		const PetscScalar * r_a;
+		PetscScalar * z_a;
+
+		PETSC_SAFE_CALL(PCShellGetContext(pc,(void **)&pts));
+
+		PETSC_SAFE_CALL(VecGetArrayRead(r,&r_a));
+		PETSC_SAFE_CALL(VecGetArray(z,&z_a));
+
+		pts->pc_shell(r_a,z_a);
+
+		PETSC_SAFE_CALL(VecRestoreArray(z,&z_a));
+		PETSC_SAFE_CALL(VecRestoreArrayRead(r,&r_a));
+
+		return 0;
+	}
+
+	/*! \brief If the user preconditioner is set, use it as preconditioner of a Krylov solver
+	 *
+	 * \param k Krylov solver
+	 *
+	 * \return true if the user preconditioner is set
+	 *
+	 */
+	bool set_pc_shell(KSP k)
+	{
+		if (!pc_shell)
+		{return false;}
+
+		PC pc;
+
+		PETSC_SAFE_CALL(KSPGetPC(k,&pc));
+		PETSC_SAFE_CALL(PCSetType(pc,PCSHELL));
+		PETSC_SAFE_CALL(PCShellSetContext(pc,this));
+		PETSC_SAFE_CALL(PCShellSetApply(pc,pc_shell_apply));
+
+		return true;
+	}
+
 	/*! \brief This function print an "*" showing the progress of the solvers
 	 *
 	 * \param it iteration number
@@ -481,6 +1317,223 @@ class petsc_solver<double>
 		bench.add();
 		bench.last().method = to_string_method(str);
 		bench.last().smethod = std::string(str);
+		bench.last().ksp = str;
+	}
+
+	/*! \brief Benchmark the last solver added with new_bench
+	 *
+	 * The solver is stopped when it become slower than the best solver found so far, or when
+	 * it exceed the time budget left
+	 *
+	 * \param A_ Matrix
+	 * \param b_ right-hand-side
+	 * \param x_ solution
+	 * \param best_res residual of the best solution
+	 * \param best_sol best solution
+	 * \param best_time time in seconds of the fastest solver that converged (negative none)
+	 * \param t_search start time of the search
+	 *
+	 * \return false if the time budget is finished (the solver is not tested)
+	 *
+	 */
+	bool bench_candidate(const Mat & A_, const Vec & b_, Vec & x_,
+			             double & best_res, Vec & best_sol,
+			             double & best_time, PetscLogDouble t_search)
+	{
+		cand_limit = best_time;
+
+		if (tuning_budget > 0.0)
+		{
+			PetscLogDouble t_now;
+			PETSC_SAFE_CALL(PetscTime(&t_now));
+
+			double left = tuning_budget - (t_now - t_search);
+
+			auto & v_cl = create_vcluster();
+			v_cl.min(left);
+			v_cl.execute();
+
+			if (left <= 0.0)
+			{
+				bench.remove(bench.size()-1);
+				return false;
+			}
+
+			cand_limit = (cand_limit < 0.0)?left:std::min(cand_limit,left);
+		}
+
+		bench_solve_simple(A_,b_,x_,bench.last());
+
+		if (bench.last().converged == true)
+		{
+			copy_if_better(bench.last().err.err_inf,x_,best_res,best_sol);
+
+			if (best_time < 0.0 || bench.last().time / 1000.0 < best_time)
+			{best_time = bench.last().time / 1000.0;}
+		}
+
+		cand_limit = -1.0;
+
+		return true;
+	}
+
+	/*! \brief Set solver, parameter and preconditioner
+	 *
+	 * \param ksp_type Krylov solver
+	 * \param param restart for GMRES methods or search directions for BiCGStab(L) (0 default)
+	 * \param pc preconditioner
+	 *
+	 */
+	void set_configuration(const std::string & ksp_type, PetscInt param, const std::string & pc)
+	{
+		setSolver(ksp_type.c_str());
+
+		if (param != 0)
+		{
+			if (ksp_type == std::string(KSPBCGSL))
+			{searchDirections(param);}
+			else if (ksp_type == std::string(KSPGMRES) ||
+					 ksp_type == std::string(KSPFGMRES) ||
+					 ksp_type == std::string(KSPLGMRES))
+			{setRestart(param);}
+		}
+
+		PETSC_SAFE_CALL(PetscOptionsSetValue(NULL,"-pc_type",pc.c_str()));
+	}
+
+	/*! \brief Fingerprint of a Matrix used as key of the tuning database
+	 *
+	 * It is made of size, non-zeros, symmetry and diagonal dominance (minimum over the rows of
+	 * |a_ii| / sum_j!=i |a_ij| in tenths, 10 for diagonally dominant matrices)
+	 *
+	 * \param A_ Matrix
+	 *
+	 * \return the fingerprint
+	 *
+	 */
+	std::string matrix_fingerprint(const Mat & A_)
+	{
+		PetscInt row;
+		PetscInt col;
+		PETSC_SAFE_CALL(MatGetSize(A_,&row,&col));
+
+		MatInfo info;
+		PETSC_SAFE_CALL(MatGetInfo(A_,MAT_GLOBAL_SUM,&info));
+
+		PetscBool sym;
+		PETSC_SAFE_CALL(MatIsSymmetric(A_,1e-10,&sym));
+
+		PetscInt r_start;
+		PetscInt r_stop;
+		PETSC_SAFE_CALL(MatGetOwnershipRange(A_,&r_start,&r_stop));
+
+		double dd = 1.0;
+
+		for (PetscInt r = r_start ; r < r_stop ; r++)
+		{
+			PetscInt ncols;
+			const PetscInt * cols;
+			const PetscScalar * vals;
+
+			PETSC_SAFE_CALL(MatGetRow(A_,r,&ncols,&cols,&vals));
+
+			double diag = 0.0;
+			double off = 0.0;
+
+			for (PetscInt j = 0 ; j < ncols ; j++)
+			{
+				if (cols[j] == r)
+				{diag += std::fabs(vals[j]);}
+				else
+				{off += std::fabs(vals[j]);}
+			}
+
+			PETSC_SAFE_CALL(MatRestoreRow(A_,r,&ncols,&cols,&vals));
+
+			if (off != 0.0)
+			{dd = std::min(dd,diag / off);}
+		}
+
+		auto & v_cl = create_vcluster();
+		v_cl.min(dd);
+		v_cl.execute();
+
+		std::stringstream key;
+		key << "n" << row << "x" << col << "_nnz" << (size_t)info.nz_used << "_sym" << (sym == PETSC_TRUE) << "_dd" << (int)std::floor(dd * 10.0);
+
+		return key.str();
+	}
+
+	/*! \brief Search a configuration in the tuning database
+	 *
+	 * \param key fingerprint of the Matrix
+	 * \param ksp_type Krylov solver
+	 * \param param parameter of the Krylov solver
+	 * \param pc preconditioner
+	 *
+	 * \return true if found on all the processors
+	 *
+	 */
+	bool tuning_lookup(const std::string & key, std::string & ksp_type, PetscInt & param, std::string & pc)
+	{
+		size_t found = 0;
+
+		std::ifstream db(tuning_db);
+		std::string line;
+
+		// the last entry of a key is the most recent
+		while (db.is_open() && std::getline(db,line))
+		{
+			std::istringstream ss(line);
+			std::string k;
+			std::string kt;
+			std::string p;
+			PetscInt pr;
+
+			if (!(ss >> k >> kt >> pr >> p) || k != key)
+			{continue;}
+
+			ksp_type = kt;
+			param = pr;
+			pc = p;
+			found = 1;
+		}
+
+		auto & v_cl = create_vcluster();
+		v_cl.min(found);
+		v_cl.execute();
+
+		return found == 1;
+	}
+
+	/*! \brief Append the result of a search in the tuning database
+	 *
+	 * \param key fingerprint of the Matrix
+	 * \param best best solver
+	 *
+	 */
+	void tuning_store(const std::string & key, const solv_bench_info & best)
+	{
+		auto & v_cl = create_vcluster();
+
+		if (v_cl.getProcessUnitID() == 0)
+		{
+			std::ofstream db(tuning_db,std::ios::app);
+
+			if (db.is_open() == false)
+			{std::cerr << __FILE__ << ":" << __LINE__ << " Error cannot write the tuning database " << tuning_db << std::endl;}
+			else
+			{
+				// key ksp param pc iterations time(ms) residual
+				db << key << " " << best.ksp << " " << best.param << " " << PCNONE << " " << best.err.its << " "
+				   << best.time << " " << best.err.err_inf << std::endl;
+			}
+		}
+
+		// the entry is visible to all the processors at the next try_solve
+		size_t written = 1;
+		v_cl.sum(written);
+		v_cl.execute();
 	}
 
 	/*! \brief Copy the solution if better
@@ -505,12 +1558,17 @@ class petsc_solver<double>
 	 *   It try to solve the system using JACOBI pre-conditioner and all the Krylov solvers available at the end it write
 	 *   a report
 	 *
+	 *   Solvers slower than the best found so far are stopped, and no more solvers are tested when
+	 *   the time budget is finished. At the end the fastest solver is set for the next solves
+	 *
 	 * \param A_ Matrix
 	 * \param b_ vector of coefficents
 	 * \param x_ solution
 	 *
+	 * \return the index in bench of the fastest solver that converged (-1 if none converged)
+	 *
 	 */
-	void try_solve_simple(const Mat & A_, const Vec & b_, Vec & x_)
+	long int try_solve_simple(const Mat & A_, const Vec & b_, Vec & x_)
 	{
 		Vec best_sol;
 		PETSC_SAFE_CALL(VecDuplicate(x_,&best_sol));
@@ -518,9 +1576,16 @@ class petsc_solver<double>
 		// Best residual
 		double best_res = std::numeric_limits<double>::max();
 
+		// time of the fastest solver
+		double best_time = -1.0;
+
+		PetscLogDouble t_search;
+		PETSC_SAFE_CALL(PetscTime(&t_search));
+
 		// Create a new VCluster
 		auto & v_cl = create_vcluster();
 
+		bench.clear();
 		destroyKSP();
 
 		// for each solver
@@ -548,10 +1613,11 @@ class petsc_solver<double>
 					if (v_cl.getProcessUnitID() == 0)
 						std::cout << "L = " << j << std::endl;
 					bench.last().smethod += std::string("(") + std::to_string(j) + std::string(")");
+					bench.last().param = j;
 					searchDirections(j);
-					bench_solve_simple(A_,b_,x_,bench.last());
 
-					copy_if_better(bench.last().err.err_inf,x_,best_res,best_sol);
+					if (bench_candidate(A_,b_,x_,best_res,best_sol,best_time,t_search) == false)
+					{break;}
 				}
 			}
 			else if (solvs.get(i) == std::string(KSPGMRES) ||
@@ -567,10 +1633,11 @@ class petsc_solver<double>
 					if (v_cl.getProcessUnitID() == 0)
 						std::cout << "Restart = " << j << std::endl;
 					bench.last().smethod += std::string("(") + std::to_string(j) + std::string(")");
+					bench.last().param = j;
 					setRestart(j);
-					bench_solve_simple(A_,b_,x_,bench.last());
 
-					copy_if_better(bench.last().err.err_inf,x_,best_res,best_sol);
+					if (bench_candidate(A_,b_,x_,best_res,best_sol,best_time,t_search) == false)
+					{break;}
 				}
 			}
 			else
@@ -578,9 +1645,7 @@ class petsc_solver<double>
 				// Add a new benchmark result
 				new_bench(solvs.get(i));
 
-				bench_solve_simple(A_,b_,x_,bench.last());
-
-				copy_if_better(bench.last().err.err_inf,x_,best_res,best_sol);
+				bench_candidate(A_,b_,x_,best_res,best_sol,best_time,t_search);
 			}
 
 			destroyKSP();
@@ -591,6 +1656,23 @@ class petsc_solver<double>
 		// Copy the best solution to x
 		PETSC_SAFE_CALL(VecCopy(best_sol,x_));
 		PETSC_SAFE_CALL(VecDestroy(&best_sol));
+
+		// The next solves use the fastest solver
+		initKSP();
+		setMaxIter(maxits);
+
+		long int best = -1;
+
+		for (size_t i = 0 ; i < bench.size() ; i++)
+		{
+			if (bench.get(i).converged == true && (best == -1 || bench.get(i).time < bench.get(best).time))
+			{best = i;}
+		}
+
+		if (best != -1)
+		{set_configuration(bench.get(best).ksp,bench.get(best).param,PCNONE);}
+
+		return best;
 	}
 
 
@@ -612,8 +1694,24 @@ class petsc_solver<double>
 		PETSC_SAFE_CALL(KSPMonitorCancel(ksp));
 		PETSC_SAFE_CALL(KSPMonitorSet(ksp,monitor_progress_residual,this,NULL));
 		print_progress_bar();
+
+		// Stop the solver if too slow
+		if (cand_limit >= 0.0)
+		{
+			void * conv_ctx;
+
+			PETSC_SAFE_CALL(KSPConvergedDefaultCreate(&conv_ctx));
+			PETSC_SAFE_CALL(KSPSetApplicationContext(ksp,(void *)this));
+			PETSC_SAFE_CALL(KSPSetConvergenceTest(ksp,converged_budget,conv_ctx,KSPConvergedDefaultDestroy));
+		}
+
+		PETSC_SAFE_CALL(PetscTime(&cand_start));
 		solve_simple(A_,b_,x_);
 
+		KSPConvergedReason reason;
+		PETSC_SAFE_CALL(KSPGetConvergedReason(ksp,&reason));
+		bench.converged = (reason > 0);
+
 		// New line
 		if (create_vcluster().getProcessUnitID() == 0)
 			std::cout << std::endl;
@@ -639,29 +1737,110 @@ class petsc_solver<double>
 	 * \param x_ solution
 	 *
 	 */
-	void solve_simple(const Mat & A_, const Vec & b_, Vec & x_)
+	void solve_simple(const Mat & A_, const Vec & b_, Vec & x_, bool rebuild_pc = true)
 	{
-//		PETSC_SAFE_CALL(KSPSetType(ksp,s_type));
+		setup_simple(A_,rebuild_pc);
 
-		// We set the size of x according to the Matrix A
-		PetscInt row;
-		PetscInt col;
-		PetscInt row_loc;
-		PetscInt col_loc;
+		timer t_apply;
+		t_apply.start();
 
-		PETSC_SAFE_CALL(MatGetSize(A_,&row,&col));
-		PETSC_SAFE_CALL(MatGetLocalSize(A_,&row_loc,&col_loc));
+		// Solve the system
+		PETSC_SAFE_CALL(KSPSolve(ksp,b_,x_));
 
-		// We set the Matrix operators
-		PETSC_SAFE_CALL(KSPSetOperators(ksp,A_,A_));
+		t_apply.stop();
+
+		apply_time = t_apply.getwct();
+		pc_n_solves++;
+		PETSC_SAFE_CALL(KSPGetIterationNumber(ksp,&last_its));
+	}
 
-		// if we are on on best solve set-up a monitor function
+	/*! \brief Set the operators of the Krylov solver and (re)build the preconditioner
+	 *
+	 * \param A_ SparseMatrix
+	 * \param rebuild_pc true to build the preconditioner, false to reuse the current one
+	 *
+	 */
+	void setup_simple(const Mat & A_, bool rebuild_pc)
+	{
+		timer t_setup;
+		t_setup.start();
+
+		if (rebuild_pc == true)
+		{
+			PETSC_SAFE_CALL(KSPSetReusePreconditioner(ksp,PETSC_FALSE));
+
+			// We set the Matrix operators
+			PETSC_SAFE_CALL(KSPSetOperators(ksp,A_,A_));
+
+			// if we are on on best solve set-up a monitor function
+
+			PETSC_SAFE_CALL(KSPSetFromOptions(ksp));
+			set_pc_shell(ksp);
+			PETSC_SAFE_CALL(KSPSetUp(ksp));
+
+			pc_built = true;
+			pc_n_solves = 0;
+			pc_n_builds++;
+		}
+		else
+		{
+			// The Krylov solver use the current coefficients, the preconditioner is kept
+			PETSC_SAFE_CALL(KSPSetReusePreconditioner(ksp,PETSC_TRUE));
+			PETSC_SAFE_CALL(KSPSetOperators(ksp,A_,A_));
+		}
+
+		t_setup.stop();
+
+		setup_time = t_setup.getwct();
+		pc_rebuilt = rebuild_pc;
+	}
+
+	/*! \brief Decide, following the reuse policy, if the preconditioner must be rebuilt
+	 *
+	 * The decision use only the revision of the coefficients given by SparseMatrix::getRevision().
+	 * Revisions are unique across Matrices, so with REUSE_PC_UNCHANGED_COEFF a different Matrix
+	 * always rebuild the preconditioner. The policies that reuse the preconditioner with changed
+	 * coefficients rebuild it only if the size of the system change
+	 *
+	 * \param A_ Matrix of the system
+	 * \param revision revision of the coefficients of the Matrix
+	 *
+	 * \return true if the preconditioner must be rebuilt
+	 *
+	 */
+	bool pc_need_rebuild(const Mat & A_, size_t revision)
+	{
+		bool rebuild = true;
+
+		PetscInt row, col;
+		PETSC_SAFE_CALL(MatGetSize(A_,&row,&col));
+
+		if (pc_built == true && pc_size == row)
+		{
+			switch (pc_reuse)
+			{
+			case REUSE_PC_NEVER:
+				rebuild = true;
+				break;
+			case REUSE_PC_N_SOLVES:
+				rebuild = (pc_n_solves >= pc_reuse_n);
+				break;
+			case REUSE_PC_ITERATIONS:
+				rebuild = ((size_t)last_its > pc_reuse_n);
+				break;
+			case REUSE_PC_UNCHANGED_COEFF:
+				rebuild = (revision != pc_revision);
+				break;
+			}
+		}
 
-		PETSC_SAFE_CALL(KSPSetFromOptions(ksp));
-		PETSC_SAFE_CALL(KSPSetUp(ksp));
+		if (rebuild == true)
+		{
+			pc_revision = revision;
+			pc_size = row;
+		}
 
-		// Solve the system
-		PETSC_SAFE_CALL(KSPSolve(ksp,b_,x_));
+		return rebuild;
 	}
 
 	/*! \brief solve simple use a Krylov solver + Simple selected Parallel Pre-conditioner
@@ -672,8 +1851,19 @@ class petsc_solver<double>
 	 */
 	void solve_simple(const Vec & b_, Vec & x_)
 	{
+		timer t_apply;
+		t_apply.start();
+
 		// Solve the system
 		PETSC_SAFE_CALL(KSPSolve(ksp,b_,x_));
+
+		t_apply.stop();
+
+		setup_time = 0.0;
+		apply_time = t_apply.getwct();
+		pc_rebuilt = false;
+		pc_n_solves++;
+		PETSC_SAFE_CALL(KSPGetIterationNumber(ksp,&last_its));
 	}
 
 	/*! \brief Calculate statistic on the error solution
@@ -707,6 +1897,8 @@ class petsc_solver<double>
 	void initKSP()
 	{
 		PETSC_SAFE_CALL(KSPCreate(PETSC_COMM_WORLD,&ksp));
+
+		pc_built = false;
 	}
 
 	/*! \brief initialize the KSP object for solver testing
@@ -717,6 +1909,8 @@ class petsc_solver<double>
 	{
 		PETSC_SAFE_CALL(KSPCreate(PETSC_COMM_WORLD,&ksp));
 
+		pc_built = false;
+
 		setMaxIter(maxits);
 	}
 
@@ -800,6 +1994,7 @@ public:
 
 	~petsc_solver()
 	{
+		destroy_mixed();
 		PETSC_SAFE_CALL(KSPDestroy(&ksp));
 	}
 
@@ -918,6 +2113,7 @@ public:
 	void setSolver(KSPType type)
 	{
 		PetscOptionsSetValue(NULL,"-ksp_type",type);
+		resetPreconditioner();
 	}
 
 	/*! \brief Set the relative tolerance as stop criteria
@@ -1046,6 +2242,8 @@ public:
 	void setPreconditioner(PCType type)
 	{
 		is_preconditioner_set = true;
+		pc_shell = nullptr;
+		resetPreconditioner();
 
 		if (std::string(type) == PCHYPRE_BOOMERAMG)
 		{
@@ -1321,14 +2519,70 @@ public:
 		Vector<double,PETSC_BASE> x(row,row_loc);
 		Vec & x_ = x.getVec();
 
+		if (mixed_precision == true)
+		{
+			solve_mixed(A_,b_,x_,A.getRevision(),false);
+
+			x.update();
+
+			return x;
+		}
+
 		pre_solve_impl(A_,b_,x_);
-		solve_simple(A_,b_,x_);
+		solve_simple(A_,b_,x_,pc_need_rebuild(A_,A.getRevision()));
 
 		x.update();
 
 		return x;
 	}
 
+	/*! \brief Solve with mixed precision iterative refinement
+	 *
+	 * In this mode solve(A,b), solve(A,x,b), solve(b), solve(x,b) and solve_multi keep a single
+	 * precision copy of the local rows of the Matrix, and compute the corrections with a single
+	 * precision GMRES (restart from setRestart) preconditioned with the preconditioner set, built
+	 * on the coefficients rounded to single precision. The Krylov method set with setSolver is not
+	 * used by the inner solves. The residual and the solution are
+	 * updated in double precision until the residual satisfy the tolerances of the solver
+	 * (setRelTol, setAbsTol), so the final accuracy is the same of the double precision solve.
+	 * The copy is rebuilt when the coefficients of the Matrix change, a failed inner solve stop the
+	 * refinement (see isLastMixedConverged). getLastIterations return the total number of inner
+	 * iterations. try_solve, with_constant_nullspace_solve and solve_matrix_free ignore this mode
+	 *
+	 * \param mp true to enable the mode
+	 * \param inner_rtol relative tolerance of the inner solves
+	 * \param max_outer maximum number of refinement steps
+	 *
+	 */
+	void setMixedPrecision(bool mp, double inner_rtol = 1e-4, size_t max_outer = 30)
+	{
+		mixed_precision = mp;
+		mixed_inner_rtol = inner_rtol;
+		mixed_max_outer = max_outer;
+
+		destroy_mixed();
+	}
+
+	/*! \brief Return the number of refinement steps of the last mixed precision solve
+	 *
+	 * \return the number of refinement steps
+	 *
+	 */
+	size_t getLastRefinementSteps() const
+	{
+		return mixed_outer_its;
+	}
+
+	/*! \brief Return if the last mixed precision solve reached the tolerances
+	 *
+	 * \return true if the residual satisfy the tolerances of the solver
+	 *
+	 */
+	bool isLastMixedConverged() const
+	{
+		return mixed_converged;
+	}
+
     /*! \brief Here we invert the matrix and solve the system using a Nullspace for Neumann BC
      *
      *  \warning umfpack is not a parallel solver, this function work only with one processor
@@ -1371,13 +2625,114 @@ public:
         PETSC_SAFE_CALL(MatNullSpaceDestroy(&nullspace));
 
         pre_solve_impl(A_,b_,x_);
-        solve_simple(A_,b_,x_);
+        solve_simple(A_,b_,x_,pc_need_rebuild(A_,A.getRevision()));
 
         x.update();
 
         return x;
     }
 
+	/*! \brief Set the policy to reuse the preconditioner across solves
+	 *
+	 * In time dependent problems the Matrix is often constant or change slowly, and building
+	 * the preconditioner (for example the BoomerAMG hierarchy) can cost more than the iterations.
+	 * The preconditioner is reused only when the same Matrix object is solved again; with a reused
+	 * preconditioner the Krylov iterations still use the current coefficients of the Matrix
+	 *
+	 * \note solver and preconditioner options changed after the preconditioner has been built
+	 *       are applied at the next rebuild, use resetPreconditioner to force it
+	 *
+	 * \param policy reuse policy
+	 * \param n number of solves for REUSE_PC_N_SOLVES, maximum number of iterations for REUSE_PC_ITERATIONS
+	 *
+	 */
+	void setPreconditionerReuse(PC_reuse_policy policy, size_t n = 0)
+	{
+		pc_reuse = policy;
+		pc_reuse_n = n;
+	}
+
+	/*! \brief Use a user preconditioner (PETSc PCSHELL)
+	 *
+	 * The functor is called with the local part of the residual r and must return the local
+	 * part of z = M^-1 r, for example one cycle of FD_multigrid
+	 *
+	 * \verbatim
+	   pet_sol.setPreconditionerShell([&](const double * r, double * z){mg.apply(r,z);});
+	 * \endverbatim
+	 *
+	 * setPreconditioner remove it
+	 *
+	 * \param apply functor apply(const PetscScalar * r, PetscScalar * z)
+	 *
+	 */
+	template<typename apply_type>
+	void setPreconditionerShell(apply_type apply)
+	{
+		is_preconditioner_set = true;
+		pc_shell = apply;
+		resetPreconditioner();
+	}
+
+	/*! \brief Force to rebuild the preconditioner at the next solve
+	 *
+	 */
+	void resetPreconditioner()
+	{
+		pc_built = false;
+		mixed_mat.revision = 0;
+	}
+
+	/*! \brief Return the time spent to set-up the solver and the preconditioner in the last solve
+	 *
+	 * \return the time in seconds
+	 *
+	 */
+	double getLastSetupTime() const
+	{
+		return setup_time;
+	}
+
+	/*! \brief Return the time spent in the Krylov iterations in the last solve
+	 *
+	 * \return the time in seconds
+	 *
+	 */
+	double getLastApplyTime() const
+	{
+		return apply_time;
+	}
+
+	/*! \brief Return the number of iterations of the last solve
+	 *
+	 * \return the number of iterations
+	 *
+	 */
+	PetscInt getLastIterations() const
+	{
+		return last_its;
+	}
+
+	/*! \brief Return true if the last solve has built the preconditioner
+	 *
+	 * \return true if the preconditioner has been rebuilt
+	 *
+	 */
+	bool isPreconditionerRebuilt() const
+	{
+		return pc_rebuilt;
+	}
+
+	/*! \brief Return how many times the preconditioner has been built
+	 *
+	 * \return the number of preconditioner builds
+	 *
+	 */
+	size_t getNPreconditionerBuilds() const
+	{
+		return pc_n_builds;
+	}
+
 	/*! \brief Return the KSP solver
 	 *
 	 * In case you want to do fine tuning of the KSP solver before
@@ -1436,8 +2791,16 @@ public:
 
 		PETSC_SAFE_CALL(KSPSetInitialGuessNonzero(ksp,PETSC_TRUE));
 
+		if (mixed_precision == true)
+		{
+			bool ret = solve_mixed(A_,b_,x_,A.getRevision(),true);
+			x.update();
+
+			return ret;
+		}
+
 		pre_solve_impl(A_,b_,x_);
-		solve_simple(A_,b_,x_);
+		solve_simple(A_,b_,x_,pc_need_rebuild(A_,A.getRevision()));
 		x.update();
 
 		return true;
@@ -1465,7 +2828,11 @@ public:
 		Vector<double,PETSC_BASE> x(row,row_loc);
 		Vec & x_ = x.getVec();
 
-		solve_simple(b_,x_);
+		if (mixed_precision == true)
+		{solve_mixed(b_,x_,false);}
+		else
+		{solve_simple(b_,x_);}
+
 		x.update();
 
 		return x;
@@ -1490,12 +2857,234 @@ public:
 		const Vec & b_ = b.getVec();
 		Vec & x_ = x.getVec();
 
+		if (mixed_precision == true)
+		{
+			bool ret = solve_mixed(b_,x_,true);
+			x.update();
+
+			return ret;
+		}
+
 		solve_simple(b_,x_);
 		x.update();
 
 		return true;
 	}
 
+	/*! \brief Solve the system for several right-hand-sides with one set-up of the solver
+	 *
+	 * The Krylov solver and the preconditioner are set-up once. When PETSc support it (3.14 or newer)
+	 * all the right-hand-sides are solved together with KSPMatSolve (block Krylov methods like
+	 * KSPHPDDM use them as a block, the others solve them one after the other), otherwise every
+	 * right-hand-side is solved with the operators already set.
+	 *
+	 * \param A sparse matrix
+	 * \param n_rhs number of right-hand-sides
+	 * \param get_b functor get_b(k) that return the right-hand-side k, the vector is copied
+	 *        before asking for the next one
+	 * \param set_x functor set_x(k,x) that receive the solution of the right-hand-side k
+	 *
+	 */
+	template<typename get_b_type, typename set_x_type>
+	void solve_multi(SparseMatrix<double,int,PETSC_BASE> & A, size_t n_rhs, get_b_type get_b, set_x_type set_x)
+	{
+		Mat & A_ = A.getMat();
+
+		// We set the size of x according to the Matrix A
+		PetscInt row;
+		PetscInt col;
+		PetscInt row_loc;
+		PetscInt col_loc;
+
+		PETSC_SAFE_CALL(KSPSetInitialGuessNonzero(ksp,PETSC_FALSE));
+		PETSC_SAFE_CALL(MatGetSize(A_,&row,&col));
+		PETSC_SAFE_CALL(MatGetLocalSize(A_,&row_loc,&col_loc));
+
+		if (mixed_precision == true)
+		{
+			for (size_t k = 0 ; k < n_rhs ; k++)
+			{
+				const Vec & b_ = get_b(k).getVec();
+
+				Vector<double,PETSC_BASE> x(row,row_loc);
+				Vec & x_ = x.getVec();
+
+				solve_mixed(A_,b_,x_,A.getRevision(),false);
+
+				x.update();
+				set_x(k,x);
+			}
+
+			return;
+		}
+
+#if PETSC_VERSION_GE(3,14,0)
+
+		if (n_rhs > 1)
+		{
+			Mat B_;
+			Mat X_;
+
+			PETSC_SAFE_CALL(MatCreateDense(PETSC_COMM_WORLD,row_loc,PETSC_DECIDE,row,n_rhs,NULL,&B_));
+			PETSC_SAFE_CALL(MatCreateDense(PETSC_COMM_WORLD,row_loc,PETSC_DECIDE,row,n_rhs,NULL,&X_));
+
+			for (size_t k = 0 ; k < n_rhs ; k++)
+			{
+				Vec b_col;
+				const Vec & b_ = get_b(k).getVec();
+
+				PETSC_SAFE_CALL(MatDenseGetColumnVecWrite(B_,k,&b_col));
+				PETSC_SAFE_CALL(VecCopy(b_,b_col));
+				PETSC_SAFE_CALL(MatDenseRestoreColumnVecWrite(B_,k,&b_col));
+			}
+
+			Vector<double,PETSC_BASE> x(row,row_loc);
+			Vec & x_ = x.getVec();
+
+			pre_solve_impl(A_,x_,x_);
+			setup_simple(A_,pc_need_rebuild(A_,A.getRevision()));
+
+			timer t_apply;
+			t_apply.start();
+
+			PETSC_SAFE_CALL(KSPMatSolve(ksp,B_,X_));
+
+			t_apply.stop();
+
+			apply_time = t_apply.getwct();
+			pc_n_solves += n_rhs;
+			PETSC_SAFE_CALL(KSPGetIterationNumber(ksp,&last_its));
+
+			for (size_t k = 0 ; k < n_rhs ; k++)
+			{
+				Vec x_col;
+
+				PETSC_SAFE_CALL(MatDenseGetColumnVecRead(X_,k,&x_col));
+				PETSC_SAFE_CALL(VecCopy(x_col,x_));
+				PETSC_SAFE_CALL(MatDenseRestoreColumnVecRead(X_,k,&x_col));
+
+				x.update();
+				set_x(k,x);
+			}
+
+			PETSC_SAFE_CALL(MatDestroy(&B_));
+			PETSC_SAFE_CALL(MatDestroy(&X_));
+
+			return;
+		}
+
+#endif
+
+		for (size_t k = 0 ; k < n_rhs ; k++)
+		{
+			const Vec & b_ = get_b(k).getVec();
+
+			Vector<double,PETSC_BASE> x(row,row_loc);
+			Vec & x_ = x.getVec();
+
+			if (k == 0)
+			{
+				pre_solve_impl(A_,b_,x_);
+				solve_simple(A_,b_,x_,pc_need_rebuild(A_,A.getRevision()));
+			}
+			else
+			{solve_simple(b_,x_);}
+
+			x.update();
+			set_x(k,x);
+		}
+	}
+
+	/*! \brief Solve the system without assembling the Matrix
+	 *
+	 * The Matrix is a PETSc shell that call mult(x,y) to compute y = A x and diag(d) to get
+	 * its diagonal, both on the local rows. Because the coefficients are not available, only
+	 * the preconditioners that need the diagonal can be used: PCJACOBI (used when the
+	 * preconditioner set is not PCNONE or PCJACOBI) or PCNONE, or a user preconditioner set with
+	 * setPreconditionerShell
+	 *
+	 * \param mult functor mult(const PetscScalar * x, PetscScalar * y) that apply the operator
+	 * \param diag functor diag(PetscScalar * d) that return the diagonal of the operator
+	 * \param b right-hand-side
+	 *
+	 * \return the solution
+	 *
+	 */
+	template<typename mult_type, typename diag_type>
+	Vector<double,PETSC_BASE> solve_matrix_free(mult_type mult, diag_type diag, const Vector<double,PETSC_BASE> & b)
+	{
+		const Vec & b_ = b.getVec();
+
+		PetscInt row;
+		PetscInt row_loc;
+
+		PETSC_SAFE_CALL(VecGetSize(b_,&row));
+		PETSC_SAFE_CALL(VecGetLocalSize(b_,&row_loc));
+
+		matrix_free_ctx ctx;
+		ctx.mult = mult;
+		ctx.diag = diag;
+
+		Mat A_;
+
+		PETSC_SAFE_CALL(MatCreateShell(PETSC_COMM_WORLD,row_loc,row_loc,row,row,&ctx,&A_));
+		PETSC_SAFE_CALL(MatShellSetOperation(A_,MATOP_MULT,(void (*)(void))matrix_free_mult));
+		PETSC_SAFE_CALL(MatShellSetOperation(A_,MATOP_GET_DIAGONAL,(void (*)(void))matrix_free_diag));
+
+		Vector<double,PETSC_BASE> x(row,row_loc);
+		Vec & x_ = x.getVec();
+
+		PETSC_SAFE_CALL(KSPSetInitialGuessNonzero(ksp,PETSC_FALSE));
+		pre_solve_impl(A_,b_,x_);
+
+		timer t_setup;
+		t_setup.start();
+
+		PETSC_SAFE_CALL(KSPSetReusePreconditioner(ksp,PETSC_FALSE));
+		PETSC_SAFE_CALL(KSPSetOperators(ksp,A_,A_));
+		PETSC_SAFE_CALL(KSPSetFromOptions(ksp));
+
+		PC pc;
+		PCType pc_type;
+
+		PETSC_SAFE_CALL(KSPGetPC(ksp,&pc));
+		PETSC_SAFE_CALL(PCGetType(pc,&pc_type));
+
+		if (set_pc_shell(ksp) == false && (pc_type == NULL || (strcmp(pc_type,PCNONE) != 0 && strcmp(pc_type,PCJACOBI) != 0)))
+		{
+			if (is_preconditioner_set == true)
+			{std::cerr << __FILE__ << ":" << __LINE__ << " Warning the matrix-free solve support only PCJACOBI and PCNONE, PCJACOBI is used" << std::endl;}
+
+			PETSC_SAFE_CALL(PCSetType(pc,PCJACOBI));
+		}
+
+		PETSC_SAFE_CALL(KSPSetUp(ksp));
+
+		t_setup.stop();
+
+		timer t_apply;
+		t_apply.start();
+
+		PETSC_SAFE_CALL(KSPSolve(ksp,b_,x_));
+
+		t_apply.stop();
+
+		setup_time = t_setup.getwct();
+		apply_time = t_apply.getwct();
+		pc_rebuilt = true;
+		pc_n_builds++;
+		pc_n_solves = 1;
+		PETSC_SAFE_CALL(KSPGetIterationNumber(ksp,&last_its));
+
+		// the shell is destroyed, the next solve with a SparseMatrix must set-up the operators again
+		pc_built = false;
+		PETSC_SAFE_CALL(MatDestroy(&A_));
+
+		x.update();
+
+		return x;
+	}
+
 	/*! \brief this function give you the possibility to set PETSC options
 	 *
 	 * this function call PetscOptionsSetValue
@@ -1538,13 +3127,90 @@ public:
 		Vector<double,PETSC_BASE> x(row,row_loc);
 		Vec & x_ = x.getVec();
 
+		tuning_hit = false;
+		std::string key;
+
+		if (tuning_db.size() != 0)
+		{
+			key = matrix_fingerprint(A_);
+
+			std::string ksp_type;
+			std::string pc;
+			PetscInt param;
+
+			if (tuning_lookup(key,ksp_type,param,pc) == true)
+			{
+				set_configuration(ksp_type,param,pc);
+
+				pre_solve_impl(A_,b_,x_);
+				solve_simple(A_,b_,x_);
+
+				tuning_hit = true;
+				x.update();
+
+				return x;
+			}
+		}
+
 		pre_solve_impl(A_,b_,x_);
-		try_solve_simple(A_,b_,x_);
+		long int best = try_solve_simple(A_,b_,x_);
+
+		if (tuning_db.size() != 0 && best != -1)
+		{tuning_store(key,bench.get(best));}
 
 		x.update();
 
 		return x;
 	}
+
+	/*! \brief Persist the results of try_solve in a tuning database
+	 *
+	 * The fastest solver found by try_solve is appended to the file, with a fingerprint of the
+	 * Matrix (size, non-zeros, symmetry, diagonal dominance). When try_solve is called on a Matrix
+	 * with a fingerprint already in the database, the stored configuration is used directly
+	 * without searching. Every processor read the file, so it must be on a shared file system
+	 *
+	 * \param file database file (an empty string disable the database)
+	 *
+	 */
+	void setTuningDatabase(const std::string & file)
+	{
+		tuning_db = file;
+	}
+
+	/*! \brief Set a time budget for the search in try_solve
+	 *
+	 * When the budget is finished the remaining solvers are not tested
+	 *
+	 * \param seconds time budget (0 no budget)
+	 *
+	 */
+	void setTuningBudget(double seconds)
+	{
+		tuning_budget = seconds;
+	}
+
+	/*! \brief Return true if the last try_solve used a configuration from the tuning database
+	 *
+	 * \return true if the search has been skipped
+	 *
+	 */
+	bool isLastTuningHit() const
+	{
+		return tuning_hit;
+	}
+
+	/*! \brief Return the fingerprint of a Matrix used in the tuning database
+	 *
+	 * \param A Matrix
+	 *
+	 * \return the fingerprint
+	 *
+	 */
+	std::string getMatrixFingerprint(SparseMatrix<double,int,PETSC_BASE> & A)
+	{
+		return matrix_fingerprint(A.getMat());
+	}
 };
 
 #endif
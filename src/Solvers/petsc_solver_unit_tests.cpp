@@ -132,6 +132,102 @@ BOOST_AUTO_TEST_CASE( laplacian_3D_int_zero_mg )
 	BOOST_REQUIRE_EQUAL(check,true);
 }
 
+BOOST_AUTO_TEST_CASE( laplacian_2D_mixed_precision )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	// 2D Poisson, 5 points, Dirichlet boundary
+	const int nx = 128;
+	const int N = nx*nx;
+	const int np = v_cl.getProcessingUnits();
+	const int rank = v_cl.getProcessUnitID();
+	const int loc = N / np + ((rank < N % np)?1:0);
+	const int start = rank * (N / np) + std::min(rank,N % np);
+	const double h = 1.0 / (nx - 1);
+
+	SparseMatrix<double,int,PETSC_BASE> A(N,N,loc);
+	Vector<double,PETSC_BASE> b(N,loc);
+
+	typedef SparseMatrix<double,int,PETSC_BASE>::triplet_type triplet;
+	auto & trpl = A.getMatrixTriplets();
+
+	for (int r = start ; r < start + loc ; r++)
+	{
+		int i = r % nx;
+		int j = r / nx;
+
+		if (i == 0 || j == 0 || i == nx-1 || j == nx-1)
+		{
+			trpl.add(triplet(r,r,1.0));
+			b.insert(r,0.0);
+			continue;
+		}
+
+		trpl.add(triplet(r,r,-4.0/h/h));
+		trpl.add(triplet(r,r-1,1.0/h/h));
+		trpl.add(triplet(r,r+1,1.0/h/h));
+		trpl.add(triplet(r,r-nx,1.0/h/h));
+		trpl.add(triplet(r,r+nx,1.0/h/h));
+
+		double x = i*h;
+		double y = j*h;
+		b.insert(r,-2.0*M_PI*M_PI*sin(M_PI*x)*sin(M_PI*y));
+	}
+
+	// double precision
+	petsc_solver<double> solver;
+	solver.setSolver(KSPGMRES);
+	solver.setPreconditioner(PCBJACOBI);
+	solver.setRelTol(1e-10);
+	solver.setMaxIter(5000);
+
+	auto x = solver.solve(A,b);
+	solError err = solver.get_residual_error(A,x,b);
+
+	// mixed precision, single precision GMRES with the same preconditioner
+	petsc_solver<double> solver_mp;
+	solver_mp.setSolver(KSPGMRES);
+	solver_mp.setPreconditioner(PCBJACOBI);
+	solver_mp.setRelTol(1e-10);
+	solver_mp.setMaxIter(5000);
+	solver_mp.setMixedPrecision(true,1e-4);
+
+	auto x_mp = solver_mp.solve(A,b);
+	solError err_mp = solver_mp.get_residual_error(A,x_mp,b);
+
+	BOOST_REQUIRE_EQUAL(solver_mp.isLastMixedConverged(),true);
+	BOOST_REQUIRE(solver_mp.getLastRefinementSteps() > 0);
+	BOOST_REQUIRE(solver_mp.getLastRefinementSteps() < 30);
+
+	// the residual is not worse than the double precision one or the requested tolerance
+	PetscReal b_norm;
+	PETSC_SAFE_CALL(VecNorm(b.getVec(),NORM_2,&b_norm));
+	BOOST_REQUIRE(err_mp.err_inf <= std::max(err.err_inf,1e-10*b_norm));
+
+	double diff = 0.0;
+	for (int r = start ; r < start + loc ; r++)
+	{diff = std::max(diff,std::fabs(x(r) - x_mp(r)));}
+
+	v_cl.max(diff);
+	v_cl.execute();
+
+	BOOST_REQUIRE(diff < 1e-6);
+
+	// with the solution as initial guess no refinement is needed
+	BOOST_REQUIRE_EQUAL(solver_mp.solve(A,x_mp,b),true);
+	BOOST_REQUIRE_EQUAL(solver_mp.getLastRefinementSteps(),0ul);
+
+	// solve(b) reuse the single precision copy and the preconditioner
+	size_t n_builds = solver_mp.getNPreconditionerBuilds();
+	auto x_mp2 = solver_mp.solve(b);
+	BOOST_REQUIRE_EQUAL(solver_mp.isLastMixedConverged(),true);
+	BOOST_REQUIRE(solver_mp.getLastRefinementSteps() > 0);
+	BOOST_REQUIRE_EQUAL(solver_mp.getNPreconditionerBuilds(),n_builds);
+
+	solError err_mp2 = solver_mp.get_residual_error(A,x_mp2,b);
+	BOOST_REQUIRE(err_mp2.err_inf <= std::max(err.err_inf,1e-10*b_norm));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
@@ -23,6 +23,7 @@
 #include "Vector/Vector.hpp"
 #include "Eigen/UmfPackSupport"
 #include <Eigen/SparseLU>
+#include <algorithm>
 
 
 template<typename T>
@@ -48,10 +49,175 @@ class umfpack_solver<double>
 
 	Eigen::UmfPackLU<Eigen::SparseMatrix<double,0,int> > solver;
 
+	//! Matrix of the current factorization
 	Eigen::SparseMatrix<double,0,int> mat_ei;
 
+	//! indicate that the symbolic analysis of mat_ei is valid
+	bool is_analyzed = false;
+
+	//! indicate that the numeric factorization of mat_ei is valid
+	bool is_factorized = false;
+
+	//! the user flagged the Matrix as unchanged since the last factorization
+	bool mat_unchanged = false;
+
+	//! number of symbolic analysis
+	size_t n_symbolic = 0;
+
+	//! number of numeric factorizations
+	size_t n_numeric = 0;
+
+	/*! \brief Check if a Matrix has the same sparsity pattern of the factorized one
+	 *
+	 * \param mat Matrix (compressed)
+	 *
+	 * \return true if the pattern is the same
+	 *
+	 */
+	bool same_pattern(const Eigen::SparseMatrix<double,0,int> & mat)
+	{
+		if (mat.rows() != mat_ei.rows() || mat.cols() != mat_ei.cols() || mat.nonZeros() != mat_ei.nonZeros())
+		{return false;}
+
+		return std::equal(mat.outerIndexPtr(),mat.outerIndexPtr() + mat.outerSize() + 1,mat_ei.outerIndexPtr()) &&
+		       std::equal(mat.innerIndexPtr(),mat.innerIndexPtr() + mat.nonZeros(),mat_ei.innerIndexPtr());
+	}
+
+	/*! \brief Factorize the Matrix (on master)
+	 *
+	 * The symbolic analysis is redone only when the sparsity pattern change, the numeric
+	 * factorization only when the values change
+	 *
+	 * \param mat Matrix
+	 *
+	 * \return false if the factorization failed
+	 *
+	 */
+	bool factorize(const Eigen::SparseMatrix<double,0,int> & mat)
+	{
+		if (mat.isCompressed() == false)
+		{
+			Eigen::SparseMatrix<double,0,int> mat_c = mat;
+			mat_c.makeCompressed();
+
+			return factorize(mat_c);
+		}
+
+		bool pattern = is_analyzed && same_pattern(mat);
+
+		if (pattern == true && is_factorized == true &&
+			std::equal(mat.valuePtr(),mat.valuePtr() + mat.nonZeros(),mat_ei.valuePtr()))
+		{return true;}
+
+		mat_ei = mat;
+		is_factorized = false;
+
+		if (pattern == false)
+		{
+			solver.analyzePattern(mat_ei);
+			n_symbolic++;
+
+			if(solver.info()!=Eigen::Success)
+			{
+				is_analyzed = false;
+				return false;
+			}
+
+			is_analyzed = true;
+		}
+
+		solver.factorize(mat_ei);
+		n_numeric++;
+
+		if(solver.info()!=Eigen::Success)
+		{return false;}
+
+		is_factorized = true;
+
+		return true;
+	}
+
+	/*! \brief Get the Matrix on master and factorize it if needed
+	 *
+	 * The result of the factorization on master is sent to all processors, so is_factorized
+	 * is the same everywhere and the decision to skip the collective collection of the Matrix
+	 * is taken by all processors together
+	 *
+	 * \param A Matrix
+	 *
+	 * \return false if the factorization failed
+	 *
+	 */
+	bool factorize(SparseMatrix<double,int,EIGEN_BASE> & A)
+	{
+		Vcluster<> & vcl = create_vcluster();
+
+		// The Matrix is not even collected
+		if (mat_unchanged == true && is_factorized == true)
+		{return true;}
+
+		// Collect the matrix on master
+		auto & mat = A.getMat();
+
+		size_t success = 0;
+
+		if (vcl.getProcessUnitID() == 0)
+		{success = factorize(mat);}
+
+		vcl.sum(success);
+		vcl.execute();
+
+		is_factorized = (success != 0);
+
+		return is_factorized;
+	}
+
 public:
 
+	/*! \brief Flag the Matrix as unchanged since the last factorization
+	 *
+	 * While the flag is set, solve(A,b) does not collect and factorize A, it use the current
+	 * factorization and do only the triangular solves. Without the flag the Matrix is compared
+	 * with the factorized one: the symbolic analysis is reused when the sparsity pattern is the
+	 * same, and the numeric factorization when also the values are the same
+	 *
+	 * \param unchanged true if the Matrix did not change
+	 *
+	 */
+	void setMatrixUnchanged(bool unchanged = true)
+	{
+		mat_unchanged = unchanged;
+	}
+
+	/*! \brief Drop the cached symbolic analysis and factorization
+	 *
+	 */
+	void resetFactorization()
+	{
+		is_analyzed = false;
+		is_factorized = false;
+	}
+
+	/*! \brief Return how many symbolic analysis have been done
+	 *
+	 * \return the number of symbolic analysis
+	 *
+	 */
+	size_t getNSymbolic() const
+	{
+		return n_symbolic;
+	}
+
+	/*! \brief Return how many numeric factorizations have been done
+	 *
+	 * \return the number of numeric factorizations
+	 *
+	 */
+	size_t getNNumeric() const
+	{
+		return n_numeric;
+	}
+
 	/*! \brief Here we invert the matrix and solve the system
 	 *
 	 *  \warning umfpack is not a parallel solver, this function work only with one processor
@@ -81,8 +247,7 @@ public:
 
 		Vector<double> x;
 
-		// Collect the matrix on master
-		mat_ei = A.getMat();
+		bool success = factorize(A);
 
 		Eigen::Matrix<double, Eigen::Dynamic, 1> x_ei;
 
@@ -94,9 +259,7 @@ public:
 
 		if (vcl.getProcessUnitID() == 0)
 		{
-			solver.compute(mat_ei);
-
-			if(solver.info()!=Eigen::Success)
+			if(success == false)
 			{
 				// Linear solver failed
 				std::cout << __FILE__ << ":" << __LINE__ << " solver failed" << "\n";
@@ -180,6 +343,100 @@ public:
 
 		return x;
 	}
+
+	/*! \brief Factorize the matrix once and solve the system for several right-hand-sides
+	 *
+	 * All the right-hand-sides are collected on master and solved as the columns of a dense matrix
+	 * with the same LU factorization
+	 *
+	 *  \warning umfpack is not a parallel solver, this function work only with one processor
+	 *
+	 * \param A sparse matrix
+	 * \param n_rhs number of right-hand-sides
+	 * \param get_b functor get_b(k) that return the right-hand-side k, the vector is copied
+	 *        before asking for the next one
+	 * \param set_x functor set_x(k,x) that receive the solution of the right-hand-side k
+	 * \param opt options
+	 *
+	 */
+	template<typename get_b_type, typename set_x_type>
+	void solve_multi(SparseMatrix<double,int,EIGEN_BASE> & A, size_t n_rhs, get_b_type get_b, set_x_type set_x, size_t opt = UMFPACK_NONE)
+	{
+		Vcluster<> & vcl = create_vcluster();
+
+		// Vector with the information on how to scatter back the solution
+		Vector<double> x;
+
+		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> B_ei;
+		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> X_ei;
+
+		bool success = factorize(A);
+
+		for (size_t k = 0 ; k < n_rhs ; k++)
+		{
+			auto & b = get_b(k);
+
+			// Collect the vector on master
+			auto & b_ei = b.getVec();
+
+			if (k == 0)
+			{x = b;}
+
+			if (vcl.getProcessUnitID() == 0)
+			{
+				if (k == 0)
+				{B_ei.resize(b_ei.size(),n_rhs);}
+
+				B_ei.col(k) = b_ei;
+			}
+		}
+
+		bool failed = false;
+
+		if (vcl.getProcessUnitID() == 0)
+		{
+			if(success == false)
+			{
+				// Linear solver failed
+				std::cout << __FILE__ << ":" << __LINE__ << " solver failed" << "\n";
+
+				failed = true;
+			}
+			else
+			{
+				X_ei = solver.solve(B_ei);
+
+				if (opt & SOLVER_PRINT_RESIDUAL_NORM_INFINITY)
+				{
+					Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> res;
+					res = mat_ei * X_ei - B_ei;
+
+					std::cout << "Infinity norm: " << res.lpNorm<Eigen::Infinity>() << "\n";
+				}
+
+				if (opt & SOLVER_PRINT_DETERMINANT)
+				{
+					std::cout << " Determinant: " << solver.determinant() << "\n";
+				}
+			}
+		}
+
+		for (size_t k = 0 ; k < n_rhs ; k++)
+		{
+			Vector<double> xk = x;
+
+			if (vcl.getProcessUnitID() == 0 && failed == false)
+			{
+				Eigen::Matrix<double, Eigen::Dynamic, 1> x_ei = X_ei.col(k);
+				xk = x_ei;
+			}
+
+			// Vector is only on master, scatter back the information
+			xk.scatter();
+
+			set_x(k,xk);
+		}
+	}
 };
 
 #else
@@ -242,6 +499,13 @@ public:
 		std::cerr << __FILE__ << ":" << __LINE__ << " Error in order to use umfpack you must compile OpenFPM with linear algebra support" << "/n";
 		return Vector<double,EIGEN_BASE>();
 	}
+
+	//! stub solve
+	template<typename get_b_type, typename set_x_type>
+	void solve_multi(SparseMatrix<double,int,EIGEN_BASE> & A, size_t n_rhs, get_b_type get_b, set_x_type set_x, size_t opt = UMFPACK_NONE)
+	{
+		std::cerr << __FILE__ << ":" << __LINE__ << " Error in order to use umfpack you must compile OpenFPM with linear algebra support" << "/n";
+	}
 };
 
 #endif